@@ -9,6 +9,8 @@
 #include "databasemanager.h"
 #include "../utils/definitionholder.h"
 #include "filemanager.h"
+#include "settingsmanager.h"
+#include "queryprofiler.h"
 
 #include <QtCore/QFile>
 #include <QtCore/QFileInfo>
@@ -19,6 +21,8 @@
 #include <QtWidgets/QMessageBox>
 #include <QtGui/QDesktopServices>
 #include <QtCore/QDir>
+#include <QtCore/QDateTime>
+#include <QtCore/QStringList>
 
 
 //-----------------------------------------------------------------------------
@@ -39,6 +43,14 @@
     "CREATE TABLE \"alarms\" (\"_id\" INTEGER PRIMARY KEY, \"collection_id\" INTEGER," \
     " \"field_id\" INTEGER, \"record_id\" INTEGER, \"date\" TEXT)"
 
+#define SQL_CREATE_TABLE_SYNC_UPLOAD \
+    "CREATE TABLE IF NOT EXISTS \"to_upload\" (\"file\" TEXT PRIMARY KEY)"
+#define SQL_CREATE_TABLE_SYNC_DELETE \
+    "CREATE TABLE IF NOT EXISTS \"to_delete\" (\"file\" TEXT PRIMARY KEY)"
+#define SQL_CREATE_TABLE_SYNC_WATCH \
+    "CREATE TABLE IF NOT EXISTS \"to_watch\" (\"file\" TEXT PRIMARY KEY," \
+    " \"last_modified\" INTEGER)"
+
 
 //-----------------------------------------------------------------------------
 // Static init
@@ -46,6 +58,7 @@
 
 DatabaseManager* DatabaseManager::m_instance = 0;
 
+
 //-----------------------------------------------------------------------------
 // Public
 //-----------------------------------------------------------------------------
@@ -69,6 +82,11 @@ QSqlDatabase DatabaseManager::getDatabase() const
     return QSqlDatabase::database("main");
 }
 
+QSqlDatabase DatabaseManager::getSyncStateDatabase() const
+{
+    return QSqlDatabase::database("syncState");
+}
+
 void DatabaseManager::beginTransaction()
 {
     QSqlDatabase::database("main").transaction();
@@ -120,29 +138,50 @@ QString DatabaseManager::getDatabasePath()
     return m_databasePath;
 }
 
+bool DatabaseManager::hasDropColumn() const
+{
+    return m_dropColumn;
+}
+
+QueryProfiler* DatabaseManager::getQueryProfiler() const
+{
+    return m_queryProfiler;
+}
+
+QString DatabaseManager::getSyncStateDatabasePath()
+{
+    return m_syncStateDatabasePath;
+}
+
 
 //-----------------------------------------------------------------------------
 // Private
 //-----------------------------------------------------------------------------
 
-DatabaseManager::DatabaseManager()
+DatabaseManager::DatabaseManager() :
+    m_dropColumn(false),
+    m_queryProfiler(new QueryProfiler)
 {
     QString dataDir = QStandardPaths::standardLocations(
                 QStandardPaths::DataLocation).at(0);
     m_databaseName = "data.db";
     m_databasePath = dataDir.append("/");
     m_databasePath.append(m_databaseName);
+    m_syncStateDatabasePath = dataDir + "syncstate.db";
 
     if (!QDir(dataDir).exists()) {
         QDir::current().mkpath(dataDir);
     }
 
     openDatabase();
+    openSyncStateDatabase();
 }
 
 DatabaseManager::~DatabaseManager()
 {
+    closeSyncStateDatabase();
     closeDatabase();
+    delete m_queryProfiler;
 }
 
 void DatabaseManager::openDatabase()
@@ -166,6 +205,27 @@ void DatabaseManager::openDatabase()
         return;
     }
 
+    //optional SQL profiling, the value is the slow query threshold in ms
+    QByteArray profileThreshold = qgetenv("PASSIFLORA_SQL_PROFILE");
+    if (!profileThreshold.isEmpty()) {
+        if (m_queryProfiler->install(database)) {
+            QString dataDir = QFileInfo(m_databasePath).absolutePath();
+            m_queryProfiler->setSlowQueryLog(dataDir + "/slow_queries.log",
+                                             profileThreshold.toInt());
+        } else {
+            qWarning("SQL profiling needs CONFIG+=system_sqlite");
+        }
+    }
+
+    //DROP COLUMN is available since SQLite 3.35.0
+    QSqlQuery versionQuery(database);
+    if (versionQuery.exec("SELECT sqlite_version()") && versionQuery.next()) {
+        QStringList version = versionQuery.value(0).toString().split('.');
+        int major = version.value(0).toInt();
+        int minor = version.value(1).toInt();
+        m_dropColumn = (major > 3) || ((major == 3) && (minor >= 35));
+    }
+
     if (!db_exists && open) {
         initDatabase(database);
         return;
@@ -189,11 +249,93 @@ void DatabaseManager::openDatabase()
 
 void DatabaseManager::closeDatabase()
 {
+    //write the profile of this connection
+    if (m_queryProfiler->isInstalled()) {
+        m_queryProfiler->uninstall();
+        QFile report(QFileInfo(m_databasePath).absolutePath()
+                     + "/query_profile.txt");
+        if (report.open(QIODevice::WriteOnly | QIODevice::Text))
+            report.write(m_queryProfiler->report().toUtf8());
+        m_queryProfiler->reset();
+    }
+
     QSqlDatabase database = QSqlDatabase::database("main");
     database.close();
     QSqlDatabase::removeDatabase("main");
 }
 
+void DatabaseManager::openSyncStateDatabase()
+{
+    bool db_exists = QFile::exists(m_syncStateDatabasePath);
+
+    //if already open
+    if (QSqlDatabase::database("syncState").isValid())
+        return;
+
+    QSqlDatabase database = QSqlDatabase::addDatabase("QSQLITE", "syncState");
+    database.setDatabaseName(m_syncStateDatabasePath);
+
+    if (!database.open()) {
+        QString err = database.lastError().text();
+        QMessageBox::critical(0, QObject::tr("Database Error"),
+                              QObject::tr("Failed to open the database file: %1")
+                              .arg(err));
+        return;
+    }
+
+    //file name is the primary key, so each
+    //queue operation is a single index lookup
+    QSqlQuery query(database);
+    database.transaction();
+    query.exec(SQL_CREATE_TABLE_SYNC_UPLOAD);
+    query.exec(SQL_CREATE_TABLE_SYNC_DELETE);
+    query.exec(SQL_CREATE_TABLE_SYNC_WATCH);
+    if (!db_exists)
+        importLegacySyncLists(database);
+    database.commit();
+}
+
+void DatabaseManager::closeSyncStateDatabase()
+{
+    QSqlDatabase database = QSqlDatabase::database("syncState");
+    database.close();
+    QSqlDatabase::removeDatabase("syncState");
+}
+
+void DatabaseManager::importLegacySyncLists(QSqlDatabase &database)
+{
+    SettingsManager sm;
+    QStringList uploadList, deleteList;
+    QHash<QString,QDateTime> watchList;
+    sm.restoreLegacySyncLists(uploadList, deleteList, watchList);
+
+    QSqlQuery query(database);
+
+    query.prepare("INSERT OR IGNORE INTO to_upload (file) VALUES (:file)");
+    foreach (QString s, uploadList) {
+        query.bindValue(":file", s);
+        query.exec();
+    }
+
+    query.prepare("INSERT OR IGNORE INTO to_delete (file) VALUES (:file)");
+    foreach (QString s, deleteList) {
+        query.bindValue(":file", s);
+        query.exec();
+    }
+
+    query.prepare("INSERT OR REPLACE INTO to_watch (file,last_modified)"
+                  " VALUES (:file, :lastModified)");
+    QHash<QString,QDateTime>::const_iterator i = watchList.constBegin();
+    while (i != watchList.constEnd()) {
+        query.bindValue(":file", i.key());
+        query.bindValue(":lastModified", i.value().toMSecsSinceEpoch());
+        query.exec();
+        ++i;
+    }
+
+    sm.removeLegacySyncLists();
+}
+
 bool DatabaseManager::databaseExists() const
 {
     return QFile::exists(m_databasePath);
@@ -286,6 +428,7 @@ void DatabaseManager::initDatabase(QSqlDatabase &database)
     query.exec("INSERT INTO \"cb92ee55f44577b584464c13f47fa3771_metadata\" VALUES (\"41\",\"col6_trigger\",\"\")");
     query.exec("INSERT INTO \"cb92ee55f44577b584464c13f47fa3771_metadata\" VALUES (\"42\",\"col6_name\",\"Photo\")");
     query.exec("INSERT INTO \"cb92ee55f44577b584464c13f47fa3771_metadata\" VALUES (\"43\",\"col6_type\",\"9\")");
+    query.exec("INSERT INTO \"cb92ee55f44577b584464c13f47fa3771_metadata\" VALUES (\"44\",\"next_field_id\",\"7\")");
     query.exec("INSERT INTO \"files\" VALUES (\"1\",\"symphytum.jpg\",\"25993661ea0bdede9699836f9ba0956b.jpg\",\"2012-12-01T16:00:00\")");
     query.exec("INSERT INTO \"files\" VALUES (\"2\",\"calendula.jpg\",\"81f87c38d8fd4cff00f35847e454e753.jpg\",\"2012-12-01T16:00:00\")");
     query.exec("INSERT INTO \"files\" VALUES (\"3\",\"coffea.jpg\",\"fd461a1f28d6682993422d65dafa2ddf.jpg\",\"2012-12-01T16:00:00\")");
@@ -349,6 +492,13 @@ void DatabaseManager::upgradeDatabase(const int oldVersion, const int newVersion
     if ((oldVersion == 1) && (newVersion == 2)) {
         //no major change (only new field type URL and email)
     }
+    //upgrade v2 -> v3
+    if ((oldVersion < 3) && (newVersion >= 3)) {
+        //data columns are named by permanent field keys now, existing
+        //keys match the columns, so nothing to convert. The version is
+        //raised because older versions expect no gaps in column names
+        seedFieldKeyCounters();
+    }
     //add new else if blocks on new versions here
 
     //upgrade done
@@ -359,3 +509,28 @@ void DatabaseManager::upgradeDatabase(const int oldVersion, const int newVersion
     query.bindValue(":version", DefinitionHolder::DATABASE_VERSION);
     query.exec();
 }
+
+void DatabaseManager::seedFieldKeyCounters()
+{
+    QSqlQuery query(getDatabase());
+
+    QStringList tableNames;
+    query.exec("SELECT table_name FROM collections");
+    while (query.next())
+        tableNames.append(query.value(0).toString());
+
+    foreach (const QString &tableName, tableNames) {
+        if (tableName.isEmpty())
+            continue;
+
+        //new keys start after the last column
+        int nextFieldKey = 1; //0 is _id
+        query.exec(QString("PRAGMA table_info('%1')").arg(tableName));
+        while (query.next())
+            nextFieldKey = qMax(nextFieldKey, query.value(1).toInt() + 1);
+
+        query.exec(QString("INSERT INTO '%1_metadata' (\"key\",\"value\") VALUES "
+                           "(\"next_field_id\", %2)")
+                   .arg(tableName).arg(nextFieldKey));
+    }
+}
@@ -24,6 +24,7 @@
 //-----------------------------------------------------------------------------
 
 class QSqlDatabase;
+class QueryProfiler;
 
 
 //-----------------------------------------------------------------------------
@@ -39,6 +40,14 @@ public:
     /** Return the database connection */
     QSqlDatabase getDatabase() const;
 
+    /**
+     * Return the connection to the local sync state database.
+     * This is a separate file next to the main database which holds
+     * the queues of files to upload/delete/watch. It is not part of the
+     * main database because that one is replaced on plant database updates.
+     */
+    QSqlDatabase getSyncStateDatabase() const;
+
     /** Begin transaction mode */
     void beginTransaction();
 
@@ -60,6 +69,26 @@ public:
     /** Get the path of the database file */
     QString getDatabasePath();
 
+    /** Get the path of the sync state database file */
+    QString getSyncStateDatabasePath();
+
+    /**
+     * Whether the SQLite library supports ALTER TABLE DROP COLUMN
+     * (since 3.35.0). The version depends on the Qt SQLite driver
+     * in use, so it is checked at runtime on the main connection.
+     */
+    bool hasDropColumn() const;
+
+    /**
+     * Return the SQL profiler of the main connection. Profiling is
+     * enabled by setting PASSIFLORA_SQL_PROFILE to the slow query
+     * threshold in ms, e.g. PASSIFLORA_SQL_PROFILE=50. Slow statements
+     * are logged to slow_queries.log and a report of all statements
+     * is written to query_profile.txt in the data directory when the
+     * database is closed. Needs CONFIG+=system_sqlite.
+     */
+    QueryProfiler* getQueryProfiler() const;
+
 private:
     DatabaseManager();
     DatabaseManager(const DatabaseManager&) {}
@@ -71,6 +100,15 @@ private:
     /** Close database */
     void closeDatabase();
 
+    /** Create the sync state database if needed and open it */
+    void openSyncStateDatabase();
+
+    /** Close sync state database */
+    void closeSyncStateDatabase();
+
+    /** Move file lists from old settings based storage to sync state db */
+    void importLegacySyncLists(QSqlDatabase &database);
+
     /** Whether the db file exists or not */
     bool databaseExists() const;
 
@@ -86,11 +124,21 @@ private:
     /** Upgrade the database to the new version */
     void upgradeDatabase(const int oldVersion, const int newVersion);
 
+    /**
+     * Add the field key counter to the metadata of all collections,
+     * set after the highest field key in use. This is used when
+     * upgrading from versions without permanent field keys.
+     */
+    void seedFieldKeyCounters();
+
     static DatabaseManager *m_instance;
     QString m_databasePath; /**< The full path, including db name
                               *  to the main db file
                               */
     QString m_databaseName; /**< The name of main database file */
+    QString m_syncStateDatabasePath; /**< The full path to the sync state db file */
+    bool m_dropColumn; /**< Whether SQLite supports DROP COLUMN */
+    QueryProfiler *m_queryProfiler;
 };
 
 #endif // DATABASEMANAGER_H
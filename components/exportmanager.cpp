@@ -0,0 +1,389 @@
+/*
+ *  Copyright (c) 2017 Giorgio Wicklein <giowckln@gmail.com>
+ */
+
+//-----------------------------------------------------------------------------
+// Hearders
+//-----------------------------------------------------------------------------
+
+#include "exportmanager.h"
+#include "databasemanager.h"
+#include "../utils/csvparser.h"
+#include "../utils/fieldformatter.h"
+
+#include <QtCore/QThread>
+#include <QtCore/QFile>
+#include <QtCore/QTextStream>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QJsonValue>
+#include <QtCore/QHash>
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlQuery>
+#include <QtSql/QSqlError>
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define EXPORT_CONNECTION_NAME "export"
+
+
+//-----------------------------------------------------------------------------
+// ExportTask
+//-----------------------------------------------------------------------------
+
+ExportTask::ExportTask(const QString &databasePath,
+                       const QAtomicInt *canceled,
+                       QObject *parent)
+    : QObject(parent), m_format(CsvFormat)
+{
+    m_dbPath = databasePath;
+    m_canceled = canceled;
+
+    //rows between progress signals and cancel checks
+    m_progressInterval = 1000;
+}
+
+ExportTask::~ExportTask()
+{
+}
+
+void ExportTask::configureTask(const QString &filePath,
+                               int collectionId,
+                               ExportFormat format,
+                               const QString &filter,
+                               const QList<int> &recordIds)
+{
+    MetadataEngine *meta = &MetadataEngine::getInstance();
+
+    m_filePath = filePath;
+    m_tableName = meta->getTableName(collectionId);
+    m_format = format;
+
+    //restrict to filter and records
+    QStringList conditions;
+    if (!filter.isEmpty())
+        conditions.append("(" + filter + ")");
+    if (!recordIds.isEmpty()) {
+        QStringList ids;
+        foreach (int id, recordIds)
+            ids.append(QString::number(id));
+        conditions.append(QString("\"_id\" IN (%1)").arg(ids.join(",")));
+    }
+    m_whereClause = conditions.isEmpty() ?
+                QString() : " WHERE " + conditions.join(" AND ");
+
+    //field metadata is read here, on the thread that
+    //owns the main database connection
+    m_fieldNames.clear();
+    m_fieldKeys.clear();
+    m_fieldTypes.clear();
+    m_displayProperties.clear();
+    int count = meta->getFieldCount(collectionId);
+    for (int column = 1; column < count; column++) { //0 is _id
+        m_fieldNames.append(meta->getFieldName(column, collectionId));
+        m_fieldKeys.append(meta->getFieldKey(column, collectionId));
+        m_fieldTypes.append(meta->getFieldType(column, collectionId));
+        m_displayProperties.append(meta->getFieldProperties(
+                                       MetadataEngine::DisplayProperty,
+                                       column, collectionId));
+    }
+}
+
+void ExportTask::startExportTask()
+{
+    int recordCount = 0;
+    QString errMessage;
+
+    bool error = !exportRecords(recordCount, errMessage);
+
+    //the connection must be unused when removed
+    QSqlDatabase::removeDatabase(EXPORT_CONNECTION_NAME);
+
+    if (error) {
+        emit errorSignal(errMessage);
+        return;
+    }
+
+    if (m_canceled->load()) {
+        emit canceledSignal();
+        return;
+    }
+
+    emit finishedSignal(recordCount);
+}
+
+bool ExportTask::exportRecords(int &recordCount, QString &errorMessage)
+{
+    QFile file(m_filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        errorMessage = file.errorString();
+        return false;
+    }
+
+    //the main connection belongs to the GUI thread
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE",
+                                                EXPORT_CONNECTION_NAME);
+    db.setDatabaseName(m_dbPath);
+    if (!db.open()) {
+        errorMessage = db.lastError().text();
+        return false;
+    }
+
+    QSqlQuery query(db);
+
+    //content file names for image and files fields
+    QHash<int,QString> fileNames;
+    if (m_fieldTypes.contains(MetadataEngine::ImageType) ||
+            m_fieldTypes.contains(MetadataEngine::FilesType)) {
+        query.exec("SELECT _id,name FROM files");
+        while (query.next())
+            fileNames.insert(query.value(0).toInt(), query.value(1).toString());
+    }
+
+    QList<FieldFormatter> formatters;
+    QStringList columnNames;
+    for (int i = 0; i < m_fieldKeys.size(); i++) {
+        formatters.append(FieldFormatter(m_displayProperties.at(i),
+                                         m_fieldTypes.at(i),
+                                         fileNames));
+        columnNames.append(QString("\"%1\"").arg(m_fieldKeys.at(i)));
+    }
+    if (columnNames.isEmpty()) {
+        errorMessage = tr("The collection has no fields");
+        return false;
+    }
+
+    //record count for progress
+    int total = 0;
+    if (query.exec(QString("SELECT COUNT(*) FROM '%1'%2")
+                   .arg(m_tableName).arg(m_whereClause)) && query.next())
+        total = query.value(0).toInt();
+    emit progressRangeSignal(0, total);
+
+    //forward only, so rows are not cached by the driver
+    QSqlQuery rowQuery(db);
+    rowQuery.setForwardOnly(true);
+    if (!rowQuery.exec(QString("SELECT %1 FROM '%2'%3 ORDER BY \"_id\"")
+                       .arg(columnNames.join(","))
+                       .arg(m_tableName)
+                       .arg(m_whereClause))) {
+        errorMessage = rowQuery.lastError().text();
+        return false;
+    }
+
+    //field names as JSON keys must be unique
+    QStringList keys;
+    foreach (const QString &name, m_fieldNames) {
+        QString key = name;
+        for (int n = 2; keys.contains(key); n++)
+            key = QString("%1 (%2)").arg(name).arg(n);
+        keys.append(key);
+    }
+
+    //the stream writes to the file in buffered chunks
+    QTextStream out(&file);
+    out.setCodec("UTF-8");
+
+    if (m_format == CsvFormat)
+        out << CsvParser::formatRow(m_fieldNames, ',') << "\n";
+
+    QStringList fields;
+    while (rowQuery.next()) {
+        if (m_format == CsvFormat) {
+            fields.clear();
+            for (int i = 0; i < formatters.size(); i++)
+                fields.append(formatters.at(i).format(rowQuery.value(i)));
+            out << CsvParser::formatRow(fields, ',') << "\n";
+        } else {
+            QJsonObject object;
+            for (int i = 0; i < formatters.size(); i++) {
+                const FieldFormatter &f = formatters.at(i);
+                QString s = f.format(rowQuery.value(i));
+                QJsonValue value(s);
+                bool ok = true;
+
+                if (s.isEmpty()) {
+                    value = QJsonValue();
+                } else if (f.type() == MetadataEngine::CheckboxType) {
+                    value = (s == "1");
+                } else if ((f.type() == MetadataEngine::NumericType) ||
+                           (f.type() == MetadataEngine::ProgressType)) {
+                    double d = s.toDouble(&ok);
+                    if (ok) value = d;
+                }
+                object.insert(keys.at(i), value);
+            }
+            out << QJsonDocument(object).toJson(QJsonDocument::Compact) << "\n";
+        }
+
+        if ((++recordCount % m_progressInterval) == 0) {
+            emit progressSignal(recordCount);
+            if (m_canceled->load())
+                break;
+        }
+    }
+
+    out.flush();
+
+    //don't leave a partial file
+    if (m_canceled->load()) {
+        file.remove();
+        return true;
+    }
+
+    if (out.status() != QTextStream::Ok) {
+        errorMessage = file.errorString();
+        return false;
+    }
+
+    emit progressSignal(recordCount);
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+// Public
+//-----------------------------------------------------------------------------
+
+ExportManager::ExportManager(QObject *parent) :
+    QObject(parent), m_exportTaskThread(nullptr),
+    m_recordCount(0), m_wasCanceled(false)
+{
+    m_databasePath = DatabaseManager::getInstance().getDatabasePath();
+}
+
+ExportManager::~ExportManager()
+{
+    //the task must not outlive the canceled flag
+    if (m_exportTaskThread) {
+        m_canceled.store(1);
+        m_exportTaskThread->wait();
+    }
+}
+
+void ExportManager::startExport(const QString &destFilePath,
+                                int collectionId,
+                                ExportTask::ExportFormat format,
+                                const QString &filter,
+                                const QList<int> &recordIds)
+{
+    m_recordCount = 0;
+    m_wasCanceled = false;
+    m_errorMessage.clear();
+
+    //create export task thread
+    m_canceled.store(0);
+    m_exportTaskThread = new QThread;
+    ExportTask *exportTask = new ExportTask(m_databasePath, &m_canceled);
+
+    //call config task before moving to thread
+    //because field metadata is read from the main connection
+    exportTask->configureTask(destFilePath, collectionId, format,
+                              filter, recordIds);
+
+    exportTask->moveToThread(m_exportTaskThread);
+    createExportThreadConnections(m_exportTaskThread, exportTask);
+
+    m_exportTaskThread->start();
+}
+
+int ExportManager::exportedRecordCount() const
+{
+    return m_recordCount;
+}
+
+bool ExportManager::wasCanceled() const
+{
+    return m_wasCanceled;
+}
+
+QString ExportManager::errorMessage() const
+{
+    return m_errorMessage;
+}
+
+
+//-----------------------------------------------------------------------------
+// Public slots
+//-----------------------------------------------------------------------------
+
+void ExportManager::stopExportTask()
+{
+    //the task stops at the next progress step
+    //and emits canceledSignal()
+    if (m_exportTaskThread)
+        m_canceled.store(1);
+}
+
+
+//-----------------------------------------------------------------------------
+// Private slots
+//-----------------------------------------------------------------------------
+
+void ExportManager::exportTaskErrorSlot(const QString &message)
+{
+    m_exportTaskThread = 0;
+    m_errorMessage = message;
+    emit exportFinished();
+}
+
+void ExportManager::exportTaskFinishedSlot(int recordCount)
+{
+    m_exportTaskThread = 0;
+    m_recordCount = recordCount;
+    emit exportFinished();
+}
+
+void ExportManager::exportTaskCanceledSlot()
+{
+    m_exportTaskThread = 0;
+    m_wasCanceled = true;
+    emit exportFinished();
+}
+
+
+//-----------------------------------------------------------------------------
+// Private
+//-----------------------------------------------------------------------------
+
+void ExportManager::createExportThreadConnections(QThread *thread,
+                                                  ExportTask *exportTask)
+{
+    //thread start and stop, quit directly from the task thread,
+    //so the thread stops even while the GUI thread waits on it
+    connect(thread, SIGNAL(started()),
+            exportTask, SLOT(startExportTask()));
+    connect(exportTask, SIGNAL(finishedSignal(int)),
+            thread, SLOT(quit()), Qt::DirectConnection);
+    connect(exportTask, SIGNAL(canceledSignal()),
+            thread, SLOT(quit()), Qt::DirectConnection);
+    connect(exportTask, SIGNAL(errorSignal(QString)),
+            thread, SLOT(quit()), Qt::DirectConnection);
+
+    //exportTask delete
+    connect(exportTask, SIGNAL(finishedSignal(int)),
+            exportTask, SLOT(deleteLater()));
+    connect(exportTask, SIGNAL(canceledSignal()),
+            exportTask, SLOT(deleteLater()));
+    connect(exportTask, SIGNAL(errorSignal(QString)),
+            exportTask, SLOT(deleteLater()));
+
+    //thread delete
+    connect(thread, SIGNAL(finished()),
+            thread, SLOT(deleteLater()));
+
+    //exportTask signals
+    connect(exportTask, SIGNAL(errorSignal(QString)),
+            this, SLOT(exportTaskErrorSlot(QString)));
+    connect(exportTask, SIGNAL(finishedSignal(int)),
+            this, SLOT(exportTaskFinishedSlot(int)));
+    connect(exportTask, SIGNAL(canceledSignal()),
+            this, SLOT(exportTaskCanceledSlot()));
+    connect(exportTask, SIGNAL(progressRangeSignal(int,int)),
+            this, SIGNAL(progressRangeSignal(int,int)));
+    connect(exportTask, SIGNAL(progressSignal(int)),
+            this, SIGNAL(progressSignal(int)));
+}
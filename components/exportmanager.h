@@ -0,0 +1,148 @@
+/**
+  * \class ExportManager
+  * \brief This class is used to export the records of a collection to
+  *        CSV or JSON Lines files. Rows are streamed from the data table
+  *        on a worker thread with its own database connection and
+  *        written through a buffered stream, so memory use doesn't
+  *        depend on the collection size. Values are formatted by
+  *        FieldFormatter from the display properties of each field.
+  *        The export can be restricted to a filter (like the current
+  *        search) and to a set of records (like the selection).
+  * \author Giorgio Wicklein - GIOWISYS Software
+  * \date 19/10/2026
+  */
+
+#ifndef EXPORTMANAGER_H
+#define EXPORTMANAGER_H
+
+
+//-----------------------------------------------------------------------------
+// Headers
+//-----------------------------------------------------------------------------
+
+#include "metadataengine.h"
+
+#include <QtCore/QObject>
+#include <QtCore/QAtomicInt>
+#include <QtCore/QStringList>
+
+
+//-----------------------------------------------------------------------------
+// Forward declarations
+//-----------------------------------------------------------------------------
+
+class QThread;
+
+class ExportTask : public QObject
+{
+    Q_OBJECT
+public:
+    enum ExportFormat {
+        CsvFormat,
+        JsonLinesFormat
+    };
+    ExportTask(const QString &databasePath,
+               const QAtomicInt *canceled,
+               QObject *parent = nullptr);
+    ~ExportTask();
+    void configureTask(const QString &filePath,
+                       int collectionId,
+                       ExportFormat format,
+                       const QString &filter,
+                       const QList<int> &recordIds);
+public slots:
+    void startExportTask();
+signals:
+    void finishedSignal(int recordCount);
+    void canceledSignal();
+    void progressRangeSignal(int minimum, int maximum);
+    void progressSignal(int currentStep);
+    void errorSignal(const QString &message);
+private:
+    bool exportRecords(int &recordCount, QString &errorMessage);
+    QString m_dbPath;
+    QString m_filePath;
+    QString m_tableName;
+    ExportFormat m_format;
+    QString m_whereClause;
+    QStringList m_fieldNames;
+    QList<int> m_fieldKeys;
+    QList<MetadataEngine::FieldType> m_fieldTypes;
+    QStringList m_displayProperties;
+    const QAtomicInt *m_canceled; /**< Set by ExportManager to stop the task */
+    int m_progressInterval;
+};
+
+
+//-----------------------------------------------------------------------------
+// ExportManager
+//-----------------------------------------------------------------------------
+
+class ExportManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ExportManager(QObject *parent = nullptr);
+    ~ExportManager();
+
+    /**
+     * Start an async export of collection records.
+     * Once done, the exportFinished() signal is emitted.
+     * @param destFilePath - the path of the file to write
+     * @param collectionId - the collection to export
+     * @param format - CSV (with header row) or JSON Lines
+     * @param filter - SQL filter on the data table, like the search filter
+     *                 of StandardModel, all records if empty
+     * @param recordIds - ids of the records to export, all if empty
+     */
+    void startExport(const QString &destFilePath,
+                     int collectionId,
+                     ExportTask::ExportFormat format,
+                     const QString &filter = QString(),
+                     const QList<int> &recordIds = QList<int>());
+
+    /** Return the count of exported records of the last export */
+    int exportedRecordCount() const;
+
+    /** Whether the last export has been canceled */
+    bool wasCanceled() const;
+
+    /** Return the error message of the last export, empty if succeeded */
+    QString errorMessage() const;
+
+public slots:
+    /**
+     * Cancel the export task, if running. This doesn't block,
+     * exportFinished() is emitted once the task has stopped
+     */
+    void stopExportTask();
+
+signals:
+    /** Emitted when the export completed, failed or has been canceled */
+    void exportFinished();
+
+    /** Emitted once the count of records to export is known */
+    void progressRangeSignal(int minimum, int maximum);
+
+    /** Emitted to signal the count of exported records */
+    void progressSignal(int currentStep);
+
+private slots:
+    void exportTaskErrorSlot(const QString &message);
+    void exportTaskFinishedSlot(int recordCount);
+    void exportTaskCanceledSlot();
+
+private:
+    void createExportThreadConnections(QThread *thread,
+                                       ExportTask *exportTask);
+
+    QThread *m_exportTaskThread;
+    QAtomicInt m_canceled;
+    QString m_databasePath; /**< The path where database file is saved */
+    int m_recordCount;
+    bool m_wasCanceled;
+    QString m_errorMessage;
+};
+
+#endif // EXPORTMANAGER_H
@@ -0,0 +1,216 @@
+/*
+ *  Copyright (c) 2017 Giorgio Wicklein <giowckln@gmail.com>
+ */
+
+//-----------------------------------------------------------------------------
+// Hearders
+//-----------------------------------------------------------------------------
+
+#include "filechangetracker.h"
+#include "databasemanager.h"
+
+#include <QtCore/QFileSystemWatcher>
+#include <QtCore/QTimer>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QDir>
+#include <QtCore/QDateTime>
+#include <QtCore/QHash>
+#include <QtCore/QStringList>
+#include <QtCore/QVariant>
+#include <QtSql/QSqlQuery>
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define RESCAN_DELAY_MS 200
+
+
+//-----------------------------------------------------------------------------
+// Static init
+//-----------------------------------------------------------------------------
+
+FileChangeTracker* FileChangeTracker::m_instance = 0;
+
+
+//-----------------------------------------------------------------------------
+// Public
+//-----------------------------------------------------------------------------
+
+FileChangeTracker& FileChangeTracker::getInstance()
+{
+    if (!m_instance)
+        m_instance = new FileChangeTracker();
+    return *m_instance;
+}
+
+void FileChangeTracker::destroy()
+{
+    if (m_instance)
+        delete m_instance;
+    m_instance = 0;
+}
+
+bool FileChangeTracker::isActive()
+{
+    return m_instance && (!m_instance->m_filesDir.isEmpty());
+}
+
+void FileChangeTracker::start(const QString &filesDir)
+{
+    m_filesDir = filesDir;
+    m_rescanTimer->stop();
+    m_watchedFiles.clear();
+    m_dirtyFiles.clear();
+    m_localFiles.clear();
+
+    //one directory listing for all files
+    QHash<QString,qint64> modTimes;
+    QDir dir(m_filesDir);
+    QFileInfoList infoList = dir.entryInfoList(QDir::Files | QDir::NoDotAndDotDot);
+    foreach (const QFileInfo &info, infoList) {
+        m_localFiles.insert(info.fileName());
+        modTimes.insert(info.fileName(), info.lastModified().toMSecsSinceEpoch());
+    }
+
+    //detect watched files modified while not tracking
+    QStringList pathsToWatch;
+    QSqlQuery query(DatabaseManager::getInstance().getSyncStateDatabase());
+    query.exec("SELECT file,last_modified FROM to_watch");
+    while (query.next()) {
+        QString file = query.value(0).toString();
+        m_watchedFiles.insert(file);
+
+        QHash<QString,qint64>::const_iterator i = modTimes.constFind(file);
+        if (i == modTimes.constEnd()) {
+            m_dirtyFiles.insert(file); //removed
+        } else {
+            if (i.value() != query.value(1).toLongLong())
+                m_dirtyFiles.insert(file);
+            pathsToWatch.append(m_filesDir + file);
+        }
+    }
+
+    m_watcher->addPath(m_filesDir);
+    if (!pathsToWatch.isEmpty())
+        m_watcher->addPaths(pathsToWatch);
+}
+
+void FileChangeTracker::watchFile(const QString &file)
+{
+    m_watchedFiles.insert(file);
+    m_dirtyFiles.remove(file);
+
+    if (QFile::exists(m_filesDir + file))
+        m_watcher->addPath(m_filesDir + file);
+}
+
+void FileChangeTracker::clearWatchedFiles()
+{
+    QStringList watchedPaths = m_watcher->files();
+    if (!watchedPaths.isEmpty())
+        m_watcher->removePaths(watchedPaths);
+
+    m_watchedFiles.clear();
+    m_dirtyFiles.clear();
+}
+
+bool FileChangeTracker::hasWatchedFiles() const
+{
+    return !m_watchedFiles.isEmpty();
+}
+
+QSet<QString> FileChangeTracker::dirtyFiles()
+{
+    flushPendingRescan();
+    return m_dirtyFiles;
+}
+
+QSet<QString> FileChangeTracker::localFiles()
+{
+    flushPendingRescan();
+    return m_localFiles;
+}
+
+
+//-----------------------------------------------------------------------------
+// Private slots
+//-----------------------------------------------------------------------------
+
+void FileChangeTracker::fileChangedSlot(const QString &path)
+{
+    QString file = QFileInfo(path).fileName();
+
+    if (m_watchedFiles.contains(file))
+        m_dirtyFiles.insert(file);
+}
+
+void FileChangeTracker::directoryChangedSlot(const QString &path)
+{
+    Q_UNUSED(path);
+
+    //copies and saves emit many events, rescan once they settle
+    m_rescanTimer->start();
+}
+
+void FileChangeTracker::rescanTimeoutSlot()
+{
+    rescanFilesDirectory();
+}
+
+
+//-----------------------------------------------------------------------------
+// Private
+//-----------------------------------------------------------------------------
+
+FileChangeTracker::FileChangeTracker(QObject *parent) :
+    QObject(parent)
+{
+    m_watcher = new QFileSystemWatcher(this);
+    m_rescanTimer = new QTimer(this);
+    m_rescanTimer->setSingleShot(true);
+    m_rescanTimer->setInterval(RESCAN_DELAY_MS);
+
+    connect(m_watcher, SIGNAL(fileChanged(QString)),
+            this, SLOT(fileChangedSlot(QString)));
+    connect(m_watcher, SIGNAL(directoryChanged(QString)),
+            this, SLOT(directoryChangedSlot(QString)));
+    connect(m_rescanTimer, SIGNAL(timeout()),
+            this, SLOT(rescanTimeoutSlot()));
+}
+
+FileChangeTracker::~FileChangeTracker()
+{
+}
+
+void FileChangeTracker::rescanFilesDirectory()
+{
+    QDir dir(m_filesDir);
+    m_localFiles = dir.entryList(QDir::Files | QDir::NoDotAndDotDot).toSet();
+
+    //files saved by replacement (ie. rename) are dropped by the watcher
+    QSet<QString> watchedPaths = m_watcher->files().toSet();
+    QStringList pathsToWatch;
+    foreach (const QString &file, m_watchedFiles) {
+        QString path = m_filesDir + file;
+        if (!m_localFiles.contains(file)) {
+            m_dirtyFiles.insert(file); //removed
+        } else if (!watchedPaths.contains(path)) {
+            m_dirtyFiles.insert(file); //replaced
+            pathsToWatch.append(path);
+        }
+    }
+
+    if (!pathsToWatch.isEmpty())
+        m_watcher->addPaths(pathsToWatch);
+}
+
+void FileChangeTracker::flushPendingRescan()
+{
+    if (m_rescanTimer->isActive()) {
+        m_rescanTimer->stop();
+        rescanFilesDirectory();
+    }
+}
@@ -0,0 +1,104 @@
+/**
+  * \class FileChangeTracker
+  * \brief This class tracks changes in the files directory (see FileManager)
+  *        by using a file system watcher. Modified watched files are kept in
+  *        a dirty set which is updated incrementally, so sync checks don't need
+  *        to stat every watched file. Watched files that changed while the
+  *        app was not running are detected by a single directory scan on start.
+  *        Directory changes are rescanned once a burst of events settles.
+  *        The tracker is optional, if not active FileManager falls back
+  *        to file stats.
+  * \author Giorgio Wicklein - GIOWISYS Software
+  * \date 19/10/2026
+  */
+
+#ifndef FILECHANGETRACKER_H
+#define FILECHANGETRACKER_H
+
+
+//-----------------------------------------------------------------------------
+// Headers
+//-----------------------------------------------------------------------------
+
+#include <QtCore/QObject>
+#include <QtCore/QSet>
+#include <QtCore/QString>
+
+
+//-----------------------------------------------------------------------------
+// Forward declarations
+//-----------------------------------------------------------------------------
+
+class QFileSystemWatcher;
+class QTimer;
+
+
+//-----------------------------------------------------------------------------
+// FileChangeTracker
+//-----------------------------------------------------------------------------
+
+class FileChangeTracker : public QObject
+{
+    Q_OBJECT
+
+public:
+    static FileChangeTracker& getInstance(); //singleton
+    static void destroy();
+
+    /** Return whether the tracker has been started (without creating it) */
+    static bool isActive();
+
+    /**
+     * Start tracking the specified files directory.
+     * Files in the watch list of the sync state database are compared
+     * against a single directory listing to detect offline modifications.
+     * @param filesDir - the files directory, including trailing slash
+     */
+    void start(const QString &filesDir);
+
+    /** Add the specified file (name relative to files dir) to watched files */
+    void watchFile(const QString &file);
+
+    /** Stop watching all files and clear the dirty set */
+    void clearWatchedFiles();
+
+    /** Return whether any file is being watched */
+    bool hasWatchedFiles() const;
+
+    /**
+     * Return watched files that have been modified or removed.
+     * A pending directory rescan is run first
+     */
+    QSet<QString> dirtyFiles();
+
+    /**
+     * Return all files in the files directory.
+     * A pending directory rescan is run first
+     */
+    QSet<QString> localFiles();
+
+private slots:
+    void fileChangedSlot(const QString &path);
+    void directoryChangedSlot(const QString &path);
+    void rescanTimeoutSlot();
+
+private:
+    FileChangeTracker(QObject *parent = 0); //singleton
+    ~FileChangeTracker();
+
+    /** Refresh local file set and watch paths after directory changes */
+    void rescanFilesDirectory();
+
+    /** Run the rescan now if directory changes are waiting for the timer */
+    void flushPendingRescan();
+
+    static FileChangeTracker *m_instance;
+    QFileSystemWatcher *m_watcher;
+    QTimer *m_rescanTimer; /**< Collects bursts of directory changes */
+    QString m_filesDir;
+    QSet<QString> m_watchedFiles;
+    QSet<QString> m_dirtyFiles;
+    QSet<QString> m_localFiles;
+};
+
+#endif // FILECHANGETRACKER_H
@@ -8,8 +8,8 @@
 
 #include "filemanager.h"
 #include "../components/metadataengine.h"
-#include "../components/settingsmanager.h"
 #include "../components/databasemanager.h"
+#include "../components/filechangetracker.h"
 
 #include <QtCore/QStringList>
 #include <QtCore/QDir>
@@ -22,6 +22,9 @@
 #include <QtCore/QUrl>
 #include <QtSql/QSqlQuery>
 #include <QtCore/QVariant>
+#include <QtCore/QSet>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
 
 
 //-----------------------------------------------------------------------------
@@ -47,6 +50,12 @@ void FileTask::configureTask(const QString &srcfileName,
     m_currentOp = operation;
 }
 
+void FileTask::configureTask(const QStringList &fileList)
+{
+    m_fileList = fileList;
+    m_currentOp = RemoveListOp;
+}
+
 void FileTask::startFileOp()
 {
     bool error = false;
@@ -69,6 +78,13 @@ void FileTask::startFileOp()
                     .arg(m_filesDir + m_srcFileName).arg(src.errorString());
         }
         break;
+    case RemoveListOp:
+        //best effort, like a single remove a missing file is no failure
+        for (int i = 0; i < m_fileList.size(); i++) {
+            QFile::remove(m_filesDir + m_fileList.at(i));
+            emit progressSignal(i + 1, m_fileList.size());
+        }
+        break;
     default:
         break;
     }
@@ -106,7 +122,6 @@ FileManager::FileManager(QObject *parent) :
     }
 
     m_metadataEngine = &MetadataEngine::getInstance();
-    m_settingsManager = new SettingsManager;
 }
 
 FileManager::~FileManager()
@@ -115,16 +130,15 @@ FileManager::~FileManager()
 
     if (m_fileOpThread)
         delete m_fileOpThread;
-
-    if (m_settingsManager)
-        delete m_settingsManager;
 }
 
 bool FileManager::localFileChangesToSync()
 {
+    updateUploadListFromWatchList();
+
     bool b = !fileListToDownload().isEmpty();
-    b = b || (!fileListToRemove().isEmpty());
-    b = b || (!fileListToUpload().isEmpty());
+    b = b || (!syncQueueIsEmpty("to_delete"));
+    b = b || (!syncQueueIsEmpty("to_upload"));
 
     return b;
 }
@@ -139,13 +153,65 @@ QString FileManager::getPlantImageMetaJsonFilePath()
     return m_fileDirPath + "plantimagesmeta.json";
 }
 
+QString FileManager::getPlantImageManifestFilePath()
+{
+    return m_fileDirPath + "plantimagesmanifest.json";
+}
+
+QHash<QString,FileManager::ManifestEntry> FileManager::localFileManifest(
+        const QStringList &files)
+{
+    QHash<QString,ManifestEntry> manifest;
+    QHash<QString,ManifestEntry> cache = readManifestCache();
+    QSet<QString> wantedFiles = files.toSet();
+    bool cacheDirty = false;
+
+    //a single directory listing provides size and date of all files
+    QDir filesDir(m_fileDirPath);
+    QFileInfoList infoList = filesDir.entryInfoList(QDir::Files | QDir::NoDotAndDotDot);
+
+    foreach (const QFileInfo &info, infoList) {
+        QString name = info.fileName();
+        if (!wantedFiles.contains(name))
+            continue;
+
+        ManifestEntry entry;
+        entry.size = info.size();
+        entry.lastModified = info.lastModified().toMSecsSinceEpoch();
+
+        //reuse cached hash if file is unchanged, rehash otherwise
+        QHash<QString,ManifestEntry>::const_iterator c = cache.constFind(name);
+        if ((c != cache.constEnd()) && (c->size == entry.size) &&
+                (c->lastModified == entry.lastModified)) {
+            entry.md5Hash = c->md5Hash;
+        } else {
+            entry.md5Hash = fileMd5Hash(info.absoluteFilePath());
+            cacheDirty = true;
+        }
+
+        manifest.insert(name, entry);
+    }
+
+    //drop entries of removed files too
+    if (cacheDirty || (manifest.size() != cache.size()))
+        writeManifestCache(manifest);
+
+    return manifest;
+}
+
 QStringList FileManager::fileListToDownload()
 {
     QStringList downloadFileList;
-    QStringList localFileList = getAllLocalFiles();
+    QSet<QString> localFileList;
     QStringList databaseFileList =
             m_metadataEngine->getAllContentFiles().values();
 
+    //use tracked file list if available, avoids a directory listing
+    if (FileChangeTracker::isActive())
+        localFileList = FileChangeTracker::getInstance().localFiles();
+    else
+        localFileList = getAllLocalFiles().toSet();
+
     foreach (QString s, databaseFileList) {
         if (!localFileList.contains(s))
             downloadFileList.append(s);
@@ -162,46 +228,48 @@ QStringList FileManager::fullFileList()
 
 QStringList FileManager::fileListToUpload()
 {
-    QStringList uploadList = m_settingsManager->restoreToUploadList();
-    QHash<QString,QDateTime> watchList = m_settingsManager->restoreToWatchList();
+    QStringList uploadList;
 
-    //check watched files for modifications, if yes, add to upload list
-    QHash<QString, QDateTime>::const_iterator i = watchList.constBegin();
-    while (i != watchList.constEnd()) {
-        QFileInfo info(m_fileDirPath + i.key());
-        if (info.lastModified() != i.value()) {
-            if (!uploadList.contains(i.key()))
-                uploadList.append(i.key());
-        }
-        ++i;
-    }
+    //check watched files for modifications first
+    updateUploadListFromWatchList();
 
-    m_settingsManager->saveToUploadList(uploadList);
-    watchList.clear();
-    m_settingsManager->saveToWatchList(watchList);
+    QSqlQuery query(DatabaseManager::getInstance().getSyncStateDatabase());
+    query.exec("SELECT file FROM to_upload ORDER BY rowid");
+    while (query.next()) {
+        uploadList.append(query.value(0).toString());
+    }
 
     return uploadList;
 }
 
 QStringList FileManager::fileListToRemove()
 {
-    return m_settingsManager->restoreToDeleteList();
+    QStringList removeList;
+
+    QSqlQuery query(DatabaseManager::getInstance().getSyncStateDatabase());
+    query.exec("SELECT file FROM to_delete ORDER BY rowid");
+    while (query.next()) {
+        removeList.append(query.value(0).toString());
+    }
+
+    return removeList;
 }
 
 QStringList FileManager::unneededLocalFileList()
 {
     QStringList unneededFileList;
     QStringList localFileList = getAllLocalFiles();
-    QStringList databaseFileList =
-            m_metadataEngine->getAllContentFiles().values();
+    QSet<QString> databaseFileList =
+            m_metadataEngine->getAllContentFiles().values().toSet();
 
     foreach (QString s, localFileList) {
         if (!databaseFileList.contains(s))
             unneededFileList.append(s);
     }
 
-    //keep image metadata json file
+    //keep image metadata json and manifest cache files
     unneededFileList.removeOne("plantimagesmeta.json");
+    unneededFileList.removeOne("plantimagesmanifest.json");
 
     return unneededFileList;
 }
@@ -231,7 +299,7 @@ QStringList FileManager::orphanDatabaseFileList()
                 //extract all ids
                 QSqlQuery query(DatabaseManager::getInstance().getDatabase());
                 QString sql(QString("SELECT \"%1\" FROM \"%2\"")
-                            .arg(QString::number(i))
+                            .arg(m_metadataEngine->getFieldKey(i, collectionId))
                             .arg(m_metadataEngine->getTableName(collectionId)));
                 query.exec(sql);
 
@@ -247,7 +315,7 @@ QStringList FileManager::orphanDatabaseFileList()
                 //extract all ids
                 QSqlQuery query(DatabaseManager::getInstance().getDatabase());
                 QString sql(QString("SELECT \"%1\" FROM \"%2\"")
-                            .arg(QString::number(i))
+                            .arg(m_metadataEngine->getFieldKey(i, collectionId))
                             .arg(m_metadataEngine->getTableName(collectionId)));
                 query.exec(sql);
 
@@ -277,23 +345,33 @@ QStringList FileManager::orphanDatabaseFileList()
 
 void FileManager::removeFileFromUploadList(const QString &file)
 {
-    QStringList list = fileListToUpload();
-    list.removeOne(file);
-    m_settingsManager->saveToUploadList(list);
+    QSqlQuery query(DatabaseManager::getInstance().getSyncStateDatabase());
+    query.prepare("DELETE FROM to_upload WHERE file=:file");
+    query.bindValue(":file", file);
+    query.exec();
 }
 
 void FileManager::removeFileFromRemoveList(const QString &file)
 {
-    QStringList list = fileListToRemove();
-    list.removeOne(file);
-    m_settingsManager->saveToDeleteList(list);
+    QSqlQuery query(DatabaseManager::getInstance().getSyncStateDatabase());
+    query.prepare("DELETE FROM to_delete WHERE file=:file");
+    query.bindValue(":file", file);
+    query.exec();
 }
 
 void FileManager::clearAllLists()
 {
-    m_settingsManager->saveToDeleteList(QStringList());
-    m_settingsManager->saveToUploadList(QStringList());
-    m_settingsManager->saveToWatchList(QHash<QString,QDateTime>());
+    QSqlDatabase db = DatabaseManager::getInstance().getSyncStateDatabase();
+    QSqlQuery query(db);
+
+    db.transaction();
+    query.exec("DELETE FROM to_upload");
+    query.exec("DELETE FROM to_delete");
+    query.exec("DELETE FROM to_watch");
+    db.commit();
+
+    if (FileChangeTracker::isActive())
+        FileChangeTracker::getInstance().clearWatchedFiles();
 }
 
 void FileManager::startAddFile(const QString &file)
@@ -338,6 +416,26 @@ void FileManager::startRemoveFile(const QString &file)
     m_fileOpThread->start();
 }
 
+void FileManager::startRemoveUnneededFiles()
+{
+    //build file list here, the database is not accessible from the thread
+    QStringList fileList = unneededLocalFileList();
+
+    //create file op thread
+    m_fileOpThread = new QThread;
+    FileTask *fileTask = new FileTask(m_fileDirPath);
+
+    //config task
+    fileTask->configureTask(fileList);
+
+    fileTask->moveToThread(m_fileOpThread);
+    createFileThreadConnections(m_fileOpThread, fileTask);
+    connect(fileTask, SIGNAL(progressSignal(int,int)),
+            this, SIGNAL(removeUnneededFilesProgress(int,int)));
+
+    m_fileOpThread->start();
+}
+
 void FileManager::openContentFile(const QString &file)
 {
     QFileInfo f(m_fileDirPath + file);
@@ -425,6 +523,9 @@ void FileManager::fileOperationFinishedSlot(const QString &srcFileName,
                     m_metadataEngine->getContentFileId(srcFileName));
         emit removeFileCompletedSignal(srcFileName);
         break;
+    case FileTask::RemoveListOp:
+        emit removeUnneededFilesCompleted();
+        break;
     }
 }
 
@@ -464,26 +565,143 @@ void FileManager::createFileThreadConnections(QThread *thread,
 
 void FileManager::addFileToUploadList(const QString &file)
 {
-    QStringList list = fileListToUpload();
-    if (!list.contains(file)) {
-        list.append(file);
-        m_settingsManager->saveToUploadList(list);
-    }
+    QSqlQuery query(DatabaseManager::getInstance().getSyncStateDatabase());
+    query.prepare("INSERT OR IGNORE INTO to_upload (file) VALUES (:file)");
+    query.bindValue(":file", file);
+    query.exec();
 }
 
 void FileManager::addFileToDeleteList(const QString &file)
 {
-    QStringList list = fileListToRemove();
-    if (!list.contains(file)) {
-        list.append(file);
-        m_settingsManager->saveToDeleteList(list);
-    }
+    QSqlQuery query(DatabaseManager::getInstance().getSyncStateDatabase());
+    query.prepare("INSERT OR IGNORE INTO to_delete (file) VALUES (:file)");
+    query.bindValue(":file", file);
+    query.exec();
 }
 
 void FileManager::addFileToWatchList(const QString &file)
 {
     QFileInfo info(m_fileDirPath + file);
-    QHash<QString,QDateTime> map = m_settingsManager->restoreToWatchList();
-    map.insert(file, info.lastModified());
-    m_settingsManager->saveToWatchList(map);
+
+    QSqlQuery query(DatabaseManager::getInstance().getSyncStateDatabase());
+    query.prepare("INSERT OR REPLACE INTO to_watch (file,last_modified)"
+                  " VALUES (:file, :lastModified)");
+    query.bindValue(":file", file);
+    query.bindValue(":lastModified", info.lastModified().toMSecsSinceEpoch());
+    query.exec();
+
+    if (FileChangeTracker::isActive())
+        FileChangeTracker::getInstance().watchFile(file);
+}
+
+void FileManager::updateUploadListFromWatchList()
+{
+    QSqlDatabase db = DatabaseManager::getInstance().getSyncStateDatabase();
+    QSqlQuery query(db);
+    QStringList modifiedFiles;
+    bool watchListEmpty = true;
+
+    if (FileChangeTracker::isActive()) {
+        //modifications are already tracked, no stat needed
+        FileChangeTracker &tracker = FileChangeTracker::getInstance();
+        watchListEmpty = !tracker.hasWatchedFiles();
+        modifiedFiles = tracker.dirtyFiles().toList();
+    } else {
+        //check watched files for modifications, if yes, add to upload list
+        query.exec("SELECT file,last_modified FROM to_watch");
+        while (query.next()) {
+            watchListEmpty = false;
+            QString file = query.value(0).toString();
+            QFileInfo info(m_fileDirPath + file);
+            if (info.lastModified().toMSecsSinceEpoch() != query.value(1).toLongLong())
+                modifiedFiles.append(file);
+        }
+    }
+
+    //nothing watched, avoid write transaction
+    if (watchListEmpty)
+        return;
+
+    db.transaction();
+    query.prepare("INSERT OR IGNORE INTO to_upload (file) VALUES (:file)");
+    foreach (QString file, modifiedFiles) {
+        query.bindValue(":file", file);
+        query.exec();
+    }
+    query.exec("DELETE FROM to_watch");
+    db.commit();
+
+    if (FileChangeTracker::isActive())
+        FileChangeTracker::getInstance().clearWatchedFiles();
+}
+
+bool FileManager::syncQueueIsEmpty(const QString &tableName)
+{
+    QSqlQuery query(DatabaseManager::getInstance().getSyncStateDatabase());
+    query.exec(QString("SELECT 1 FROM '%1' LIMIT 1").arg(tableName));
+
+    return !query.next();
+}
+
+QHash<QString,FileManager::ManifestEntry> FileManager::readManifestCache()
+{
+    QHash<QString,ManifestEntry> manifest;
+
+    QFile file(getPlantImageManifestFilePath());
+    if (!file.open(QIODevice::ReadOnly))
+        return manifest;
+    QJsonDocument jsonDoc = QJsonDocument::fromJson(file.readAll());
+    file.close();
+
+    QJsonObject filesObject = jsonDoc.object()["files"].toObject();
+    QJsonObject::const_iterator i = filesObject.constBegin();
+    while (i != filesObject.constEnd()) {
+        QJsonObject obj = i.value().toObject();
+        ManifestEntry entry;
+        entry.size = (qint64) obj.value("size").toDouble(-1);
+        entry.lastModified = (qint64) obj.value("modified").toDouble(-1);
+        entry.md5Hash = obj["md5 hash"].toString();
+        manifest.insert(i.key(), entry);
+        ++i;
+    }
+
+    return manifest;
+}
+
+void FileManager::writeManifestCache(const QHash<QString,ManifestEntry> &manifest)
+{
+    QJsonObject filesObject;
+
+    QHash<QString,ManifestEntry>::const_iterator i = manifest.constBegin();
+    while (i != manifest.constEnd()) {
+        QJsonObject obj;
+        obj["size"] = (double) i->size;
+        obj["modified"] = (double) i->lastModified;
+        obj["md5 hash"] = i->md5Hash;
+        filesObject[i.key()] = obj;
+        ++i;
+    }
+
+    QJsonObject root;
+    root["files"] = filesObject;
+
+    QFile file(getPlantImageManifestFilePath());
+    if (file.open(QIODevice::WriteOnly)) { //truncates when writing
+        file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+        file.close();
+    }
+}
+
+QString FileManager::fileMd5Hash(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return QString();
+
+    //hash in chunks, images may be big
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    hash.addData(&file);
+    file.close();
+
+    return hash.result().toHex();
 }
@@ -21,6 +21,8 @@
 //-----------------------------------------------------------------------------
 
 #include <QtCore/QObject>
+#include <QtCore/QHash>
+#include <QtCore/QStringList>
 
 
 //-----------------------------------------------------------------------------
@@ -33,13 +35,15 @@ class FileTask : public QObject
 public:
     enum FileOp {
         CopyOp,
-        RemoveOp
+        RemoveOp,
+        RemoveListOp
     };
     FileTask(const QString &filesDir, QObject *parent = 0);
     ~FileTask();
     void configureTask(const QString &srcfileName,
                        const QString &destFileName = QString(),
                        FileOp operation = RemoveOp);
+    void configureTask(const QStringList &fileList);
 public slots:
     void startFileOp();
 signals:
@@ -47,15 +51,16 @@ signals:
                         const QString &destFileName,
                         int operation);
     void errorSignal(const QString &message);
+    void progressSignal(int done, int total);
 private:
     QString m_srcFileName;
     QString m_destFileName;
+    QStringList m_fileList;
     FileOp m_currentOp;
     QString m_filesDir;
 };
 
 class MetadataEngine;
-class SettingsManager;
 
 
 //-----------------------------------------------------------------------------
@@ -67,6 +72,13 @@ class FileManager : public QObject
     Q_OBJECT
 
 public:
+    /** Structure of a local file manifest entry */
+    struct ManifestEntry {
+        qint64 size; /**< File size in bytes */
+        qint64 lastModified; /**< Modification time in ms since epoch */
+        QString md5Hash; /**< Hex encoded md5 hash of the file content */
+    };
+
     explicit FileManager(QObject *parent = 0);
     ~FileManager();
     
@@ -79,6 +91,20 @@ public:
     /** Return image meta json file path */
     QString getPlantImageMetaJsonFilePath();
 
+    /** Return local image manifest cache file path */
+    QString getPlantImageManifestFilePath();
+
+    /**
+     * Return a manifest (size, modification time and md5 hash) of the
+     * specified files that are present in the files directory.
+     * Hashes are cached in the local manifest file, so only new or modified
+     * files are read and hashed again. Files that don't exist locally
+     * are not part of the returned manifest.
+     * @param files - file names (relative to files dir) to include
+     * @return QHash - pair of fileName,ManifestEntry
+     */
+    QHash<QString,ManifestEntry> localFileManifest(const QStringList &files);
+
     /** Return a list of files that should be downloaded (sync) */
     QStringList fileListToDownload();
 
@@ -128,6 +154,14 @@ public:
      */
     void startRemoveFile(const QString &file);
 
+    /**
+     * Start an async removal of all files that are in the local files dir
+     * but not in the database (see unneededLocalFileList()).
+     * Progress is notified by removeUnneededFilesProgress() and once
+     * completed, the removeUnneededFilesCompleted() signal is emitted.
+     */
+    void startRemoveUnneededFiles();
+
     /**
      * Open a content file and if sync is enabled the file is added
      * to a file watch list to detect changes to that files. On next
@@ -166,6 +200,12 @@ signals:
     /** Emitted when an error occurred during file op */
     void fileOpFailed();
 
+    /** Progress of a startRemoveUnneededFiles() request */
+    void removeUnneededFilesProgress(int done, int total);
+
+    /** This signal is emitted when a startRemoveUnneededFiles() request completes */
+    void removeUnneededFilesCompleted();
+
 private slots:
     void fileOperationErrorSlot(const QString &message);
     void fileOperationFinishedSlot(const QString &srcFileName,
@@ -177,11 +217,15 @@ private:
     void addFileToUploadList(const QString &file);
     void addFileToDeleteList(const QString &file);
     void addFileToWatchList(const QString &file);
+    void updateUploadListFromWatchList();
+    bool syncQueueIsEmpty(const QString &tableName);
+    QHash<QString,ManifestEntry> readManifestCache();
+    void writeManifestCache(const QHash<QString,ManifestEntry> &manifest);
+    QString fileMd5Hash(const QString &filePath);
 
     QString m_fileDirPath; /**< The path where content data files are saved */
     QThread *m_fileOpThread;
     MetadataEngine *m_metadataEngine;
-    SettingsManager *m_settingsManager;
 };
 
 #endif // FILEMANAGER_H
@@ -10,6 +10,8 @@
 #include "../widgets/form_widgets/abstractformwidget.h"
 
 #include <QtCore/QString>
+#include <QtCore/QList>
+#include <QtCore/QSize>
 
 
 //-----------------------------------------------------------------------------
@@ -23,7 +25,8 @@ FormLayoutMatrix::FormLayoutMatrix() : m_rows(0), m_columns(0)
 
 FormLayoutMatrix::FormLayoutMatrix(const FormLayoutMatrix &other) :
     m_rows(other.m_rows), m_columns(other.m_columns),
-    m_matrix(other.m_matrix)
+    m_cells(other.m_cells), m_owners(other.m_owners),
+    m_occupancy(other.m_occupancy), m_placements(other.m_placements)
 {
 
 }
@@ -41,8 +44,8 @@ int FormLayoutMatrix::columnCount() const
 AbstractFormWidget* FormLayoutMatrix::getFormWidget(int row, int column) const
 {
     //check boundaries
-    if ((row < m_rows) && (column < m_columns)) {
-        return m_matrix[row].at(column);
+    if ((row >= 0) && (column >= 0) && (row < m_rows) && (column < m_columns)) {
+        return m_cells.at(cellIndex(row, column));
     } else {
         return NULL;
     }
@@ -50,84 +53,67 @@ AbstractFormWidget* FormLayoutMatrix::getFormWidget(int row, int column) const
 
 AbstractFormWidget* FormLayoutMatrix::getFormWidgetByExtended(int row, int column) const
 {
-    bool found = false;
-    FormWidget *fw = NULL;
-
     //check boundaries
-    if ((row < m_rows) && (column < m_columns)) {
+    if ((row < 0) || (column < 0) || (row >= m_rows) || (column >= m_columns))
+        return NULL;
 
-        //check if the cell is really an extension
-        if (m_matrix[row][column] != (FormWidget*)EXTENDED_FORM_WIDGET)
-            return NULL;
+    int index = cellIndex(row, column);
 
-        //iterate through every row and column backwards
-        for (int i = row; i >= 0; i--) {
-            for (int j = column; j >= 0; j--) {
-                fw = m_matrix[i][j];
-                if ((fw != (FormWidget*)NO_FORM_WIDGET) &&
-                    (fw != (FormWidget*)EXTENDED_FORM_WIDGET)) {
-                    int tRow, tColumn;
-                    tRow = i + fw->getHeightUnits() - 1;
-                    tColumn = j + fw->getWidthUnits() - 1;
-
-                    if ((m_matrix[tRow][tColumn] == (FormWidget*)EXTENDED_FORM_WIDGET) &&
-                        (row <= tRow) && (column <= tColumn)) {
-                        found = true;
-                        break;
-                    }
-                }
-            }
-            if (found) break;
-        }
-    }
+    //check if the cell is really an extension
+    if (m_cells.at(index) != (FormWidget*)EXTENDED_FORM_WIDGET)
+        return NULL;
 
-    if (!found) fw = NULL;
-    return fw;
+    int owner = m_owners.at(index);
+    if (owner == -1)
+        return NULL;
+
+    return m_cells.at(owner);
 }
 
 void FormLayoutMatrix::setFormWidget(AbstractFormWidget *fw, int row, int column)
-{   
-    //check boundaries
-    if ((row < m_rows) && (column < m_columns)) {
-        int maxRow = row + fw->getHeightUnits() - 1;
-        int maxColumn = column + fw->getWidthUnits() - 1;
-
-        //check if the widget fits in current matrix size
-        //if not grow the matrix to fit the mac row/column
-        if ((maxRow >= m_rows) || (maxColumn >= m_columns)) {
-            int rowDelta = maxRow - m_rows + 1; //+1 because row count starts by 1
-            int columnDelta = maxColumn - m_columns + 1; //+1 because cols count starts by 1
-            growMatrixSize(m_rows + rowDelta, m_columns + columnDelta);
-        }
+{
+    setFormWidget(fw, row, column, fw->getWidthUnits(), fw->getHeightUnits());
+}
 
-        //first mark all matrix cells which are part of the form widget
-        for (int i = row; i < (row + fw->getHeightUnits()); i++) {
-            for (int j = column; j < (column + fw->getWidthUnits()); j++) {
-                m_matrix[i].replace(j,(FormWidget*)EXTENDED_FORM_WIDGET);
-            }
-        }
-        //set the first row/column that belong to the FW with its address
-        m_matrix[row].replace(column, fw);
+void FormLayoutMatrix::setFormWidget(AbstractFormWidget *fw, int row, int column,
+                                     int widthUnits, int heightUnits)
+{
+    int maxRow = row + heightUnits - 1;
+    int maxColumn = column + widthUnits - 1;
+
+    //check if the widget fits in current matrix size
+    //if not grow the matrix to fit the max row/column
+    //grow function expects row/column count
+    if ((maxRow >= m_rows) || (maxColumn >= m_columns)) {
+        growMatrixSize(maxRow + 1, maxColumn + 1);
+    }
 
-    } else {
-        //increment matrix size
-        //grow function expects row/column count
-        growMatrixSize(row + fw->getHeightUnits(), column + fw->getWidthUnits());
-        setFormWidget(fw, row, column);
+    int origin = cellIndex(row, column);
+
+    //first mark all matrix cells which are part of the form widget
+    for (int i = row; i <= maxRow; i++) {
+        for (int j = column; j <= maxColumn; j++) {
+            int index = cellIndex(i, j);
+
+            //an overwritten origin cell drops the widget it belonged to
+            FormWidget *old = m_cells.at(index);
+            if (isFormWidget(old) && (m_placements.value(old).origin == index))
+                m_placements.remove(old);
+
+            m_cells[index] = (FormWidget*)EXTENDED_FORM_WIDGET;
+            m_owners[index] = origin;
+            m_occupancy.setBit(index);
+        }
     }
+    //set the first row/column that belong to the FW with its address
+    m_cells[origin] = fw;
+    Placement placement = {origin, widthUnits, heightUnits};
+    m_placements.insert(fw, placement);
 }
 
 void FormLayoutMatrix::addFormWidget(AbstractFormWidget *fw)
 {   
-    int row, column;
-    bool spaceAvailable = findFreeSpace(fw->getWidthUnits(), fw->getHeightUnits(), row, column);
-
-    if (spaceAvailable) {
-        setFormWidget(fw, row, column);
-    } else {
-        createFreeSpace(fw->getWidthUnits(), fw->getHeightUnits(), row, column);
-        setFormWidget(fw, row, column);
-    }
+    addFormWidget(fw, fw->getWidthUnits(), fw->getHeightUnits());
 }
 
 AbstractFormWidget* FormLayoutMatrix::removeFormWidget(int row, int column)
@@ -135,14 +121,26 @@ AbstractFormWidget* FormLayoutMatrix::removeFormWidget(int row, int column)
     AbstractFormWidget* fw;
 
     //check boundaries
-    if ((row < m_rows) && (column < m_columns)) {
-        fw = m_matrix[row].at(column);
+    if ((row >= 0) && (column >= 0) && (row < m_rows) && (column < m_columns)) {
+        int origin = cellIndex(row, column);
+        fw = m_cells.at(origin);
+        if (!isFormWidget(fw))
+            return NULL;
+
         //set all cells that are part of the widget to NOFW
-        for (int i = row; i < (row + fw->getHeightUnits()); i++) {
-            for (int j = column; j < (column + fw->getWidthUnits()); j++) {
-                m_matrix[i].replace(j,(FormWidget*)NO_FORM_WIDGET);
+        int maxRow = qMin(row + getHeightUnits(fw), m_rows);
+        int maxColumn = qMin(column + getWidthUnits(fw), m_columns);
+        for (int i = row; i < maxRow; i++) {
+            for (int j = column; j < maxColumn; j++) {
+                int index = cellIndex(i, j);
+                if (m_owners.at(index) == origin) {
+                    m_cells[index] = (FormWidget*)NO_FORM_WIDGET;
+                    m_owners[index] = -1;
+                    m_occupancy.clearBit(index);
+                }
             }
         }
+        m_placements.remove(fw);
     } else {
         return NULL;
     }
@@ -163,11 +161,13 @@ void FormLayoutMatrix::formWidgetMovement(AbstractFormWidget *fw, int newRow, in
 
     //remove widget (old widget if any) on target index and (eventually if any) widgets
     //on index + units needed to make sure the dragged widget has enough room
-    int maxRow = newRow + fw->getHeightUnits() - 1;
-    int maxColumn = newColumn + fw->getWidthUnits() - 1;
+    int widthUnits = getWidthUnits(fw);
+    int heightUnits = getHeightUnits(fw);
+    int maxRow = newRow + heightUnits - 1;
+    int maxColumn = newColumn + widthUnits - 1;
     for (int r = newRow; ((r <= maxRow) && (r < m_rows)); r++) {
         for (int c = newColumn; ((c <= maxColumn) && (c < m_columns)); c++) {
-            FormWidget *f = m_matrix[r][c];
+            FormWidget *f = m_cells.at(cellIndex(r, c));
             if (f != (FormWidget*)FormLayoutMatrix::NO_FORM_WIDGET) {
 
                 //if cell is an extension and part of another big FW, get its parent
@@ -185,6 +185,13 @@ void FormLayoutMatrix::formWidgetMovement(AbstractFormWidget *fw, int newRow, in
         }
     }
 
+    //remember sizes of the widgets to add, they are lost on removal
+    QList<QSize> sizesToAdd;
+    for (int i = 0; i < widgetsToAdd.size(); i++) {
+        FormWidget *f = widgetsToAdd.at(i);
+        sizesToAdd.append(QSize(getWidthUnits(f), getHeightUnits(f)));
+    }
+
     //remove marked widgets
     for (int i = 0; i < widgetsToRemove.size(); i++) {
         int rowIndex, columnIndex;
@@ -194,18 +201,20 @@ void FormLayoutMatrix::formWidgetMovement(AbstractFormWidget *fw, int newRow, in
     }
 
     //set the currently dragged FW to the drop position
-    setFormWidget(fw, newRow, newColumn);
+    setFormWidget(fw, newRow, newColumn, widthUnits, heightUnits);
 
     //add previously removed widgets again
     for (int i = 0; i < widgetsToAdd.size(); i++) {
-        addFormWidget(widgetsToAdd.at(i));
+        addFormWidget(widgetsToAdd.at(i), sizesToAdd.at(i).width(),
+                      sizesToAdd.at(i).height());
     }
 
     //remove empty rows/cols if they exist
     simplifyMatrix();
 }
 
-void FormLayoutMatrix::formWidgetResize(AbstractFormWidget *fw, int newWidthUnits, int newHeightUnits)
+void FormLayoutMatrix::formWidgetResize(AbstractFormWidget *fw, int newWidthUnits,
+                                         int newHeightUnits, bool updateFormWidget)
 {
     //get current index
     int row, column;
@@ -223,7 +232,7 @@ void FormLayoutMatrix::formWidgetResize(AbstractFormWidget *fw, int newWidthUnit
     int maxColumn = column + newWidthUnits - 1;
     for (int r = row; ((r <= maxRow) && (r < m_rows)); r++) {
         for (int c = column; ((c <= maxColumn) && (c < m_columns)); c++) {
-            FormWidget *f = m_matrix[r][c];
+            FormWidget *f = m_cells.at(cellIndex(r, c));
             if (f != (FormWidget*)FormLayoutMatrix::NO_FORM_WIDGET) {
 
                 //if cell is an extension and part of another big FW, get its parent
@@ -242,6 +251,13 @@ void FormLayoutMatrix::formWidgetResize(AbstractFormWidget *fw, int newWidthUnit
         }
     }
 
+    //remember sizes of the widgets to add, they are lost on removal
+    QList<QSize> sizesToAdd;
+    for (int i = 0; i < widgetsToAdd.size(); i++) {
+        FormWidget *f = widgetsToAdd.at(i);
+        sizesToAdd.append(QSize(getWidthUnits(f), getHeightUnits(f)));
+    }
+
     //remove marked widgets
     for (int i = 0; i < widgetsToRemove.size(); i++) {
         int rowIndex, columnIndex;
@@ -251,87 +267,71 @@ void FormLayoutMatrix::formWidgetResize(AbstractFormWidget *fw, int newWidthUnit
     }
 
     //set the selected widget at the same position but with its new size
-    fw->setWidthUnits(newWidthUnits);
-    fw->setHeightUnits(newHeightUnits);
-    setFormWidget(fw, row, column);
+    setFormWidget(fw, row, column, newWidthUnits, newHeightUnits);
+    if (updateFormWidget) {
+        fw->setWidthUnits(newWidthUnits);
+        fw->setHeightUnits(newHeightUnits);
+    }
 
     //add previously removed widgets again
     for (int i = 0; i < widgetsToAdd.size(); i++) {
-        addFormWidget(widgetsToAdd.at(i));
+        addFormWidget(widgetsToAdd.at(i), sizesToAdd.at(i).width(),
+                      sizesToAdd.at(i).height());
     }
 
     //remove empty rows/cols if they exist
     simplifyMatrix();
 }
 
-bool FormLayoutMatrix::findFormWidgetIndex(AbstractFormWidget *fw, int &row, int &column)
+int FormLayoutMatrix::getWidthUnits(AbstractFormWidget *fw) const
 {
-    bool found = false;
-    row = 0;
-    column = 0;
+    return m_placements.value(fw).widthUnits;
+}
 
-    QMap<int, QList<FormWidget*> >::const_iterator map_it;
+int FormLayoutMatrix::getHeightUnits(AbstractFormWidget *fw) const
+{
+    return m_placements.value(fw).heightUnits;
+}
 
-    for (map_it = m_matrix.begin(); map_it != m_matrix.end(); map_it++) {
-        column = map_it->indexOf(fw);
-        if ((found = (column != -1))) break;
-        row++;
+bool FormLayoutMatrix::findFormWidgetIndex(AbstractFormWidget *fw, int &row, int &column)
+{
+    int origin = m_placements.contains(fw) ? m_placements.value(fw).origin : -1;
+
+    if (origin == -1) {
+        row = m_rows;
+        column = -1;
+        return false;
     }
 
-    return found;
+    row = origin / m_columns;
+    column = origin % m_columns;
+
+    return true;
 }
 
 void FormLayoutMatrix::simplifyMatrix()
 {
-    bool rowRemoved = false;
+    //a row or column is empty if none of its cells is occupied
+    QBitArray keepRows(m_rows);
+    QBitArray keepColumns(m_columns);
 
-    //check for empty rows
     for (int i = 0; i < m_rows; i++) {
-        bool markedRow = false; //current row removal flag
-        QList<AbstractFormWidget*>& currentColumn = m_matrix[i];
-
-        if (currentColumn.isEmpty()) {
-            markedRow = true;
-        } else {
-            markedRow = true; //init value
-            //check if all elements of the row are empty
-            for (int c = 0; c < m_columns; c++) {
-                AbstractFormWidget* p = currentColumn.at(c);
-                //markedRow is only true if all previous and current cell is empty
-                markedRow = markedRow && ((p == NULL) || (p == (void*)NO_FORM_WIDGET));
+        for (int j = 0; j < m_columns; j++) {
+            if (m_occupancy.testBit(cellIndex(i, j))) {
+                keepRows.setBit(i);
+                keepColumns.setBit(j);
             }
         }
-
-        if (markedRow) {
-            removeRow(i);
-            rowRemoved = true;
-            simplifyMatrix(); //repeat for all rows but now with one row less
-            break; //break cycle because after removal the indexes are not coherent anymore
-        }
     }
 
-    //if no row was deleted the indexes are still valid, so we can check columns
-    if (!rowRemoved) {
-        //check for empty columns
-        for (int i = 0; i < m_columns; i++) {
-            bool markedColumn = true; //current column removal flag
-            int j = 0;
-            while (j < m_rows) {
-                AbstractFormWidget* p = m_matrix[j].at(i);
-                if ((p == (void*)NO_FORM_WIDGET) || (p == NULL)) {
-                    j++;
-                } else {
-                    markedColumn = false;
-                    break; //there is an item that is valid so exit cycle
-                }
-            }
+    int rows = keepRows.count(true);
+    int columns = keepColumns.count(true);
 
-            if (markedColumn) {
-                removeColumn(i);
-                simplifyMatrix(); //repeat for all columns but now with one column less
-                break; //break cycle because after removal the indexes are not coherent anymore
-            }
-        }
+    //remove all empty rows and columns in one pass
+    if ((rows != m_rows) || (columns != m_columns)) {
+        if ((rows == 0) || (columns == 0))
+            rows = columns = 0;
+        reshapeMatrix(keepRows, keepColumns, rows, columns);
     }
 }
 
@@ -342,7 +342,7 @@ QString FormLayoutMatrix::toString()
 
     for (int i = 0; i < m_rows; i++) {
         for (int j = 0; j < m_columns; j++) {
-            void* p = m_matrix[i].at(j);
+            void* p = m_cells.at(cellIndex(i, j));
             if (p == NULL)
                 s.append("NULL");
             else if (p == (void*)NO_FORM_WIDGET)
@@ -359,11 +359,11 @@ QString FormLayoutMatrix::toString()
     return s;
 }
 
-QList<FormWidget*>& FormLayoutMatrix::operator[] (const int row)
+FormWidget* const* FormLayoutMatrix::operator[] (const int row) const
 {
     Q_ASSERT(row < m_rows);
 
-    return m_matrix[row];
+    return m_cells.constData() + cellIndex(row, 0);
 }
 
 bool FormLayoutMatrix::operator== (const FormLayoutMatrix& other) const
@@ -374,7 +374,7 @@ bool FormLayoutMatrix::operator== (const FormLayoutMatrix& other) const
             this->rowCount() != other.rowCount()) {
         b = false;
     } else {
-        b = (m_matrix == other.m_matrix);
+        b = (m_cells == other.m_cells);
     }
 
     return b;
@@ -390,99 +390,185 @@ bool FormLayoutMatrix::operator!= (const FormLayoutMatrix& other) const
 // Private
 //-----------------------------------------------------------------------------
 
-void FormLayoutMatrix::removeColumn(int column)
+bool FormLayoutMatrix::isFormWidget(const FormWidget *fw)
 {
-    for (int i = 0; i < this->m_rows; i++)
-        m_matrix[i].removeAt(column);
-
-    m_columns--;
+    return (fw != NULL) &&
+            (fw != (FormWidget*)NO_FORM_WIDGET) &&
+            (fw != (FormWidget*)EXTENDED_FORM_WIDGET);
 }
 
-void FormLayoutMatrix::removeRow(int row)
+void FormLayoutMatrix::rebuildIndex()
 {
-    //clear list (rm all columns of the row)
-    m_matrix[row].clear();
+    int size = m_rows * m_columns;
+
+    //units are kept from the previous placements, origins are recomputed
+    QHash<FormWidget*, Placement> previousPlacements = m_placements;
 
-    //shift every row after the row to remove one position down
-    for (int i = row+1; i < this->m_rows; i++) {
-        m_matrix[i-1] = m_matrix[i];
+    m_owners.fill(-1, size);
+    m_occupancy.fill(false, size);
+    m_placements.clear();
+
+    for (int index = 0; index < size; index++) {
+        FormWidget *fw = m_cells.at(index);
+        if (fw != (FormWidget*)NO_FORM_WIDGET)
+            m_occupancy.setBit(index);
     }
 
-    m_rows--;
+    //assign extension cells to the widget whose origin covers them
+    for (int index = 0; index < size; index++) {
+        FormWidget *fw = m_cells.at(index);
+        if (!isFormWidget(fw))
+            continue;
+
+        Placement placement = previousPlacements.value(fw);
+        placement.origin = index;
+        m_placements.insert(fw, placement);
+
+        int row = index / m_columns;
+        int column = index % m_columns;
+        int maxRow = qMin(row + placement.heightUnits, m_rows);
+        int maxColumn = qMin(column + placement.widthUnits, m_columns);
+
+        m_owners[index] = index;
+        for (int i = row; i < maxRow; i++) {
+            for (int j = column; j < maxColumn; j++) {
+                int cell = cellIndex(i, j);
+                if (m_cells.at(cell) == (FormWidget*)EXTENDED_FORM_WIDGET)
+                    m_owners[cell] = index;
+            }
+        }
+    }
+}
 
-    //clear all unused rows above row size
-    for (int i = m_matrix.size() - 1; i >= this->m_rows; i--) {
-        m_matrix[i].clear();
+void FormLayoutMatrix::reshapeMatrix(const QBitArray &keepRows,
+                                     const QBitArray &keepColumns,
+                                     int rows, int columns)
+{
+    QVector<FormWidget*> cells(rows * columns, (FormWidget*)NO_FORM_WIDGET);
+
+    int newRow = 0;
+    for (int i = 0; (i < m_rows) && (newRow < rows); i++) {
+        if (!keepRows.testBit(i)) continue;
+
+        int newColumn = 0;
+        for (int j = 0; (j < m_columns) && (newColumn < columns); j++) {
+            if (!keepColumns.testBit(j)) continue;
+            cells[(newRow * columns) + newColumn] = m_cells.at(cellIndex(i, j));
+            newColumn++;
+        }
+        newRow++;
     }
+
+    m_cells = cells;
+    m_rows = rows;
+    m_columns = columns;
+    rebuildIndex();
 }
 
 void FormLayoutMatrix::growMatrixSize(int rows, int columns)
 {
-    if (rows > m_rows) {
-        //increment rows
-        int previousCount = m_rows;
-        m_rows += (rows-m_rows);
-
-        //add as many times as columns a no form widget pointer to new added rows
-        for (int i = previousCount; i < m_rows; i++) {
-            for (int j = 0; j < m_columns; j++) {
-                m_matrix[i].append((FormWidget*)NO_FORM_WIDGET);
-            }
+    if ((rows <= m_rows) && (columns <= m_columns))
+        return;
+
+    rows = qMax(rows, m_rows);
+    columns = qMax(columns, m_columns);
+    int size = rows * columns;
+
+    //appended rows keep the grid index of every existing cell,
+    //so only the new cells are initialized
+    if (columns == m_columns) {
+        int added = size - m_cells.size();
+        if (size > m_cells.capacity()) {
+            int capacity = qMax(size, m_cells.capacity() * 2);
+            m_cells.reserve(capacity);
+            m_owners.reserve(capacity);
         }
+        m_cells.insert(m_cells.size(), added, (FormWidget*)NO_FORM_WIDGET);
+        m_owners.insert(m_owners.size(), added, -1);
+        m_occupancy.resize(size);
+        m_rows = rows;
+        return;
     }
 
-    if (columns > m_columns) {
-        //increment columns
-        int delta = columns - m_columns;
-        m_columns += delta;
-
-        //add delta times a no form widget pointer to each row
-        for (int i = 0; i < m_rows; i++) {
-            for (int j = 0; j < delta; j++) {
-                m_matrix[i].append((FormWidget*)NO_FORM_WIDGET);
-            }
+    //new columns shift the grid index of the cells, remap them
+    QVector<FormWidget*> cells(size, (FormWidget*)NO_FORM_WIDGET);
+    QVector<int> owners(size, -1);
+    QBitArray occupancy(size);
+    for (int i = 0; i < m_rows; i++) {
+        for (int j = 0; j < m_columns; j++) {
+            int index = cellIndex(i, j);
+            int newIndex = (i * columns) + j;
+            int owner = m_owners.at(index);
+            cells[newIndex] = m_cells.at(index);
+            if (owner != -1)
+                owners[newIndex] = ((owner / m_columns) * columns) + (owner % m_columns);
+            if (m_occupancy.testBit(index))
+                occupancy.setBit(newIndex);
         }
     }
+
+    QHash<FormWidget*, Placement>::iterator it = m_placements.begin();
+    for (; it != m_placements.end(); ++it) {
+        int origin = it.value().origin;
+        it.value().origin = ((origin / m_columns) * columns) + (origin % m_columns);
+    }
+
+    m_cells = cells;
+    m_owners = owners;
+    m_occupancy = occupancy;
+    m_rows = rows;
+    m_columns = columns;
+}
+
+void FormLayoutMatrix::addFormWidget(AbstractFormWidget *fw, int widthUnits, int heightUnits)
+{
+    int row, column;
+    bool spaceAvailable = findFreeSpace(widthUnits, heightUnits, row, column);
+
+    if (!spaceAvailable)
+        createFreeSpace(widthUnits, heightUnits, row, column);
+
+    setFormWidget(fw, row, column, widthUnits, heightUnits);
 }
 
 bool FormLayoutMatrix::findFreeSpace(int widthUnits, int heightUnits, int &row, int &column)
 {
-    bool found = false;
+    if ((widthUnits > m_columns) || (heightUnits > m_rows))
+        return false;
+
+    //for every cell count the free cells on its right (itself included)
+    //so that a candidate rectangle is checked with one lookup per row,
+    //the buffer keeps its capacity so it is allocated only on growth
+    m_freeRun.resize(m_rows * m_columns);
+    int *freeRun = m_freeRun.data();
+    for (int i = 0; i < m_rows; i++) {
+        int run = 0;
+        for (int j = m_columns - 1; j >= 0; j--) {
+            int index = cellIndex(i, j);
+            run = m_occupancy.testBit(index) ? 0 : run + 1;
+            freeRun[index] = run;
+        }
+    }
 
     //iterate through every row and column
-    for (int i = 0; i < m_rows; i++) {
-        QList<FormWidget*>& currentRow = m_matrix[i];
-        for (int j = 0; j < m_columns; j++) {
-            //if current item is free, check for space requirement
-            if (currentRow.at(j) == (void*)NO_FORM_WIDGET) {
-                bool isFree = true;
-                //since a free item is available, space requirements are checked next
-                for (int r = 0; r < heightUnits; r++) {
-                    for (int c = 0; c < widthUnits; c++) {
-                        int rowOffset = i+r;
-                        int columnOffset = j+c;
-                        if ((rowOffset >= m_rows) || (columnOffset >= m_columns)) {
-                            isFree = false;
-                        } else {
-                            if (m_matrix[rowOffset].at(columnOffset) != (void*)NO_FORM_WIDGET) {
-                                //one of the needed fields is not empty
-                                isFree = false;
-                            }
-                        }
-                    }
-                }
-                //if there are enough free fields we break the iteration and set found flag
-                if ((found = isFree)) {
-                    row = i;
-                    column = j;
+    for (int i = 0; i <= (m_rows - heightUnits); i++) {
+        for (int j = 0; j <= (m_columns - widthUnits); j++) {
+            bool isFree = true;
+            for (int r = 0; r < heightUnits; r++) {
+                if (freeRun[cellIndex(i + r, j)] < widthUnits) {
+                    isFree = false;
                     break;
                 }
             }
-            if (found) break;
+            if (isFree) {
+                row = i;
+                column = j;
+                return true;
+            }
         }
-        if (found) break;
     }
-    return found;
+
+    return false;
 }
 
 void FormLayoutMatrix::createFreeSpace(int widthUnits, int heightUnits, int &row, int &column)
@@ -12,6 +12,12 @@
   *        heightUnits (rows). I f a FW is bigger than one cell i.e its width or/and height is bigger
   *        than 1, the cells that belong to the same FW are marked as EXTENDED_FORM_WIDGET and only
   *        the first cell (first column/row of the widget) coontains the actual widget (FW* pointer).
+  *        Cells are stored in a dense row-major grid. Beside the cell content, every cell keeps
+  *        the grid index of the cell holding its owner widget and an occupancy bit, so that
+  *        owner lookups are O(1) and free space can be searched without dereferencing widgets.
+  *        The matrix also records the units of every FW it holds, so layout changes are
+  *        solved on the matrix alone. A copy of the matrix is a snapshot which can be
+  *        changed from any thread, as long as only the overloads taking units are used.
   * \author Giorgio Wicklein - GIOWISYS Software
   * \date 10/04/2012
   */
@@ -24,8 +30,9 @@
 // Headers
 //-----------------------------------------------------------------------------
 
-#include <QtCore/QMap>
-#include <QtCore/QList>
+#include <QtCore/QVector>
+#include <QtCore/QHash>
+#include <QtCore/QBitArray>
 
 
 //-----------------------------------------------------------------------------
@@ -74,6 +81,17 @@ public:
       */
     void setFormWidget(AbstractFormWidget* fw, int row, int column);
 
+    /** Set the form widget to be on the given index position with the given size.
+      * Unlike the overload above, the form widget is not accessed.
+      * @param fw the widget to set
+      * @param row the targetted row (beginning with 0)
+      * @param column the targetted column (beginning with 0)
+      * @param widthUnits the width of the widget in the matrix
+      * @param heightUnits the height of the widget in the matrix
+      */
+    void setFormWidget(AbstractFormWidget* fw, int row, int column,
+                       int widthUnits, int heightUnits);
+
     /** Add a form widget to the matrix at a convienent index position
       * @param fw the widget to add to the matrix
       */
@@ -103,8 +121,21 @@ public:
       * @param fw - the form widget that should be resized
       * @param newWidthUnits - the new FW width
       * @param newHeightUnits - the new FW height
+      * @param updateFormWidget - whether the new size is also set on the FW,
+      *                           false when solving on a snapshot
+      */
+    void formWidgetResize(AbstractFormWidget* fw, int newWidthUnits, int newHeightUnits,
+                          bool updateFormWidget = true);
+
+    /** Return the width units recorded for the given form widget,
+      * 0 if the widget is not in the matrix
+      */
+    int getWidthUnits(AbstractFormWidget* fw) const;
+
+    /** Return the height units recorded for the given form widget,
+      * 0 if the widget is not in the matrix
       */
-    void formWidgetResize(AbstractFormWidget* fw, int newWidthUnits, int newHeightUnits);
+    int getHeightUnits(AbstractFormWidget* fw) const;
 
     /** Find the matrix index (row/column) of the given form widget
       * @param fw the form widget from which we want the index position
@@ -122,8 +153,11 @@ public:
     /** Create a QString representation of the layout matrix */
     QString toString();
 
-    /** Overload operator [] to access the given row */
-    QList<FormWidget*>& operator[] (const int row); //reference retuning could cause crash if out of scope
+    /** Overload operator [] to access the given row.
+      * The returned pointer addresses the first cell of the row
+      * and is only valid until the matrix is modified.
+      */
+    FormWidget* const* operator[] (const int row) const;
 
     /** Overload operator == for deep comparison */
     bool operator== (const FormLayoutMatrix& other) const;
@@ -145,18 +179,45 @@ public:
     };
 
 private:
-    /** helper function to remove an entire column */
-    void removeColumn(int column);
+    /** Position and size of a form widget in the matrix */
+    struct Placement {
+        int origin;      /**< Grid index of the first cell of the FW */
+        int widthUnits;
+        int heightUnits;
+    };
+
+    /** Return the grid index of the given cell */
+    inline int cellIndex(int row, int column) const { return (row * m_columns) + column; }
 
-    /** helper function to remove an entire row */
-    void removeRow(int row);
+    /** Return whether the given cell content is an actual form widget */
+    static bool isFormWidget(const FormWidget *fw);
+
+    /** Rebuild the owner index, occupancy bitmap and placements
+      * from the cell grid. Used after the grid has been reshaped.
+      */
+    void rebuildIndex();
+
+    /** Reshape the grid keeping only the marked rows and columns.
+      * Cells of kept rows and columns preserve their relative order.
+      * @param keepRows one flag per current row
+      * @param keepColumns one flag per current column
+      * @param rows the row count of the new grid (>= kept rows)
+      * @param columns the column count of the new grid (>= kept columns)
+      */
+    void reshapeMatrix(const QBitArray &keepRows, const QBitArray &keepColumns,
+                       int rows, int columns);
 
     /** Increment the size of the matrix.
+      * Rows are appended in place, the storage is doubled when full.
+      * The owner index and placements are updated incrementally.
       * @param rows how many rows are needed
       * @param columns how many columns are needed
       */
     void growMatrixSize(int rows, int columns);
 
+    /** Add a form widget with the given size at a convienent index position */
+    void addFormWidget(AbstractFormWidget* fw, int widthUnits, int heightUnits);
+
     /** Find a free space in the matrix that fits the needs
       * in width and height.
       * @param widthUnits the horizontal units needed
@@ -178,9 +239,16 @@ private:
 
     int m_rows;                              /**< Current row count    */
     int m_columns;                           /**< Current column count */
-    QMap<int, QList<FormWidget*> > m_matrix; /**< Map of form widgets in rows and columns.
-                                              *   the key (int) represents the row and the
-                                              *   list of FW represents current row's columns.
+    QVector<FormWidget*> m_cells;            /**< Row-major grid of cells, each cell holds either
+                                              *   a FW pointer or a MatrixEntryState constant
+                                              */
+    QVector<int> m_owners;                   /**< Grid index of the origin cell of the FW
+                                              *   that occupies each cell, -1 if free
+                                              */
+    QBitArray m_occupancy;                   /**< One bit per cell, set if the cell is not free */
+    QHash<FormWidget*, Placement> m_placements; /**< Origin cell and units of each FW */
+    QVector<int> m_freeRun;                  /**< Free cells on the right of each cell,
+                                              *   buffer of findFreeSpace() kept between calls
                                               */
 };
 
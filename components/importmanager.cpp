@@ -0,0 +1,468 @@
+/*
+ *  Copyright (c) 2017 Giorgio Wicklein <giowckln@gmail.com>
+ */
+
+//-----------------------------------------------------------------------------
+// Hearders
+//-----------------------------------------------------------------------------
+
+#include "importmanager.h"
+#include "databasemanager.h"
+#include "../utils/csvparser.h"
+#include "../utils/metadatapropertiesparser.h"
+#include "../utils/fieldformatter.h"
+
+#include <QtCore/QThread>
+#include <QtCore/QFile>
+#include <QtCore/QDateTime>
+#include <QtCore/QLocale>
+#include <QtCore/QRegExp>
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlQuery>
+#include <QtSql/QSqlError>
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define IMPORT_CONNECTION_NAME "import"
+
+
+//-----------------------------------------------------------------------------
+// ImportTask
+//-----------------------------------------------------------------------------
+
+ImportTask::ImportTask(const QString &databasePath,
+                       const QAtomicInt *canceled,
+                       QObject *parent)
+    : QObject(parent), m_hasHeader(true)
+{
+    m_dbPath = databasePath;
+    m_canceled = canceled;
+
+    //rows per transaction, a commit syncs the database file
+    m_batchSize = 5000;
+}
+
+ImportTask::~ImportTask()
+{
+}
+
+void ImportTask::configureTask(const QString &filePath,
+                               int collectionId,
+                               const QList<int> &fieldColumns,
+                               QChar separator,
+                               const QByteArray &codecName,
+                               bool hasHeader)
+{
+    MetadataEngine *meta = &MetadataEngine::getInstance();
+
+    m_filePath = filePath;
+    m_tableName = meta->getTableName(collectionId);
+    m_fieldColumns = fieldColumns;
+    m_separator = separator;
+    m_codecName = codecName;
+    m_hasHeader = hasHeader;
+
+    //field metadata is read here, on the thread that
+    //owns the main database connection
+    m_fieldKeys.clear();
+    m_fieldTypes.clear();
+    m_fieldItems.clear();
+    foreach (int column, m_fieldColumns) {
+        if (column <= 0) {
+            m_fieldKeys.append(0);
+            m_fieldTypes.append(MetadataEngine::TextType);
+            m_fieldItems.append(QStringList());
+            continue;
+        }
+
+        MetadataEngine::FieldType type = meta->getFieldType(column,
+                                                            collectionId);
+        QStringList items;
+        if (type == MetadataEngine::ComboboxType) {
+            MetadataPropertiesParser parser(meta->getFieldProperties(
+                                                MetadataEngine::DisplayProperty,
+                                                column, collectionId));
+            items = FieldFormatter::comboboxItems(parser.getValue("items"));
+        }
+
+        m_fieldKeys.append(meta->getFieldKey(column, collectionId));
+        m_fieldTypes.append(type);
+        m_fieldItems.append(items);
+    }
+}
+
+QVariant ImportTask::convertValue(const QString &value,
+                                  MetadataEngine::FieldType type,
+                                  const QStringList &items)
+{
+    QString s = value.trimmed();
+    if (s.isEmpty())
+        return QVariant();
+
+    switch (type) {
+    case MetadataEngine::NumericType:
+    {
+        //CSV files usually have '.' as decimal point,
+        //fall back to the system locale
+        bool ok;
+        double d = s.toDouble(&ok);
+        if (!ok)
+            d = QLocale().toDouble(s, &ok);
+        return ok ? QVariant(d) : QVariant();
+    }
+    case MetadataEngine::CheckboxType:
+    {
+        QString l = s.toLower();
+        bool checked = (l == "1") || (l == "true") || (l == "yes") ||
+                (l == "y") || (l == "x");
+        return checked ? 1 : 0;
+    }
+    case MetadataEngine::ComboboxType:
+    {
+        int index = items.indexOf(s);
+        if (index == -1) {
+            bool ok;
+            index = s.toInt(&ok);
+            if (!ok || (index < 0) || (index >= items.size()))
+                return QVariant();
+        }
+        return index;
+    }
+    case MetadataEngine::ProgressType:
+    {
+        s.remove('%');
+        bool ok;
+        int p = qRound(s.toDouble(&ok));
+        return ok ? QVariant(qBound(0, p, 100)) : QVariant();
+    }
+    case MetadataEngine::DateType:
+    case MetadataEngine::CreationDateType:
+    case MetadataEngine::ModDateType:
+    {
+        QDateTime dateTime = QDateTime::fromString(s, Qt::ISODate);
+        if (!dateTime.isValid())
+            dateTime = QDateTime::fromString(s, "yyyy-MM-dd hh:mm:ss");
+        if (!dateTime.isValid())
+            dateTime = QDateTime::fromString(s, "yyyy-MM-dd hh:mm");
+        if (!dateTime.isValid())
+            dateTime = QDateTime(QDate::fromString(s, Qt::ISODate));
+        if (!dateTime.isValid())
+            dateTime = QLocale().toDateTime(s, QLocale::ShortFormat);
+        if (!dateTime.isValid())
+            dateTime = QDateTime(QLocale().toDate(s, QLocale::ShortFormat));
+        return dateTime.isValid() ? QVariant(dateTime) : QVariant();
+    }
+    case MetadataEngine::ImageType:
+    case MetadataEngine::FilesType:
+        //content files can't be imported from text
+        return QVariant();
+    default:
+        return s;
+    }
+}
+
+MetadataEngine::FieldType ImportTask::detectFieldType(const QStringList &values)
+{
+    bool numeric = true, date = true, url = true, email = true;
+    int count = 0;
+
+    QRegExp emailRegExp("[^@\\s]+@[^@\\s]+\\.[^@\\s]+");
+    foreach (const QString &value, values) {
+        QString s = value.trimmed();
+        if (s.isEmpty())
+            continue;
+        count++;
+
+        if (numeric) {
+            bool ok;
+            s.toDouble(&ok);
+            numeric = ok;
+        }
+        if (date) {
+            date = !convertValue(s, MetadataEngine::DateType).isNull() &&
+                    (s.contains('-') || s.contains('/') || s.contains('.'));
+        }
+        if (url)
+            url = s.startsWith("http://") || s.startsWith("https://");
+        if (email)
+            email = emailRegExp.exactMatch(s);
+
+        if (!(numeric || date || url || email))
+            break;
+    }
+
+    if (!count)
+        return MetadataEngine::TextType;
+    else if (numeric)
+        return MetadataEngine::NumericType;
+    else if (date)
+        return MetadataEngine::DateType;
+    else if (url)
+        return MetadataEngine::URLTextType;
+    else if (email)
+        return MetadataEngine::EmailTextType;
+    else
+        return MetadataEngine::TextType;
+}
+
+void ImportTask::startImportTask()
+{
+    int recordCount = 0;
+    QString errMessage;
+
+    bool error = !import(recordCount, errMessage);
+
+    //the connection must be unused when removed
+    QSqlDatabase::removeDatabase(IMPORT_CONNECTION_NAME);
+
+    if (error) {
+        emit errorSignal(errMessage);
+        return;
+    }
+
+    if (m_canceled->load()) {
+        emit canceledSignal();
+        return;
+    }
+
+    emit finishedSignal(recordCount);
+}
+
+bool ImportTask::import(int &recordCount, QString &errorMessage)
+{
+    QFile file(m_filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        errorMessage = file.errorString();
+        return false;
+    }
+
+    //mapped CSV columns
+    QList<int> csvColumns;
+    QStringList columnNames;
+    QStringList placeholders;
+    for (int i = 0; i < m_fieldColumns.size(); i++) {
+        if (m_fieldColumns.at(i) <= 0)
+            continue;
+        csvColumns.append(i);
+        columnNames.append(QString("\"%1\"").arg(m_fieldKeys.at(i)));
+        placeholders.append("?");
+    }
+    if (csvColumns.isEmpty()) {
+        errorMessage = tr("No column selected");
+        return false;
+    }
+
+    //the main connection belongs to the GUI thread
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE",
+                                                IMPORT_CONNECTION_NAME);
+    db.setDatabaseName(m_dbPath);
+    if (!db.open()) {
+        errorMessage = db.lastError().text();
+        return false;
+    }
+
+    QSqlQuery query(db);
+    if (!query.prepare(QString("INSERT INTO '%1' (%2) VALUES (%3)")
+                       .arg(m_tableName)
+                       .arg(columnNames.join(","))
+                       .arg(placeholders.join(",")))) {
+        errorMessage = query.lastError().text();
+        return false;
+    }
+
+    CsvParser parser(&file, m_separator, m_codecName);
+    QStringList fields;
+    if (m_hasHeader)
+        parser.readRow(fields);
+
+    int totalSteps = qMax(1, int(file.size() / 1024));
+    QVariant importDateTime = QDateTime::currentDateTime();
+    int batchCount = 0;
+    bool ok = true;
+
+    bool inTransaction = db.transaction();
+    while (parser.readRow(fields)) {
+        for (int i = 0; i < csvColumns.size(); i++) {
+            int c = csvColumns.at(i);
+            QVariant value;
+            if (c < fields.size())
+                value = convertValue(fields.at(c), m_fieldTypes.at(c),
+                                     m_fieldItems.at(c));
+
+            //like new records, missing dates are set to import time
+            if (value.isNull() &&
+                    ((m_fieldTypes.at(c) == MetadataEngine::CreationDateType) ||
+                     (m_fieldTypes.at(c) == MetadataEngine::ModDateType)))
+                value = importDateTime;
+
+            query.bindValue(i, value);
+        }
+
+        if (!query.exec()) {
+            errorMessage = query.lastError().text();
+            ok = false;
+            break;
+        }
+
+        if (++batchCount == m_batchSize) {
+            db.commit();
+            inTransaction = false;
+            recordCount += batchCount;
+            batchCount = 0;
+
+            emit progressSignal(qMin(totalSteps, int(file.pos() / 1024)),
+                                totalSteps);
+
+            if (m_canceled->load())
+                break;
+
+            inTransaction = db.transaction();
+        }
+    }
+
+    //a failed or canceled batch is discarded
+    if (inTransaction) {
+        if (ok && !m_canceled->load()) {
+            db.commit();
+            recordCount += batchCount;
+        } else {
+            db.rollback();
+        }
+    }
+
+    if (ok)
+        emit progressSignal(totalSteps, totalSteps);
+
+    query.clear();
+    db.close();
+    return ok;
+}
+
+
+//-----------------------------------------------------------------------------
+// Public
+//-----------------------------------------------------------------------------
+
+ImportManager::ImportManager(QObject *parent) :
+    QObject(parent), m_importTaskThread(nullptr)
+{
+    m_databasePath = DatabaseManager::getInstance().getDatabasePath();
+}
+
+ImportManager::~ImportManager()
+{
+    //the task must not outlive the canceled flag
+    if (m_importTaskThread) {
+        m_canceled.store(1);
+        m_importTaskThread->wait();
+    }
+}
+
+bool ImportManager::isImportRunning() const
+{
+    return m_importTaskThread != 0;
+}
+
+void ImportManager::startImport(const QString &filePath,
+                                int collectionId,
+                                const QList<int> &fieldColumns,
+                                QChar separator,
+                                const QByteArray &codecName,
+                                bool hasHeader)
+{
+    //create import task thread
+    m_canceled.store(0);
+    m_importTaskThread = new QThread;
+    ImportTask *importTask = new ImportTask(m_databasePath, &m_canceled);
+
+    //call config task before moving to thread
+    //because field metadata is read from the main connection
+    importTask->configureTask(filePath, collectionId, fieldColumns,
+                              separator, codecName, hasHeader);
+
+    importTask->moveToThread(m_importTaskThread);
+    createImportThreadConnections(m_importTaskThread, importTask);
+
+    m_importTaskThread->start();
+}
+
+
+//-----------------------------------------------------------------------------
+// Public slots
+//-----------------------------------------------------------------------------
+
+void ImportManager::stopImportTask()
+{
+    //the task stops after the current batch and emits canceledSignal(),
+    //terminating would leave the transaction open
+    if (m_importTaskThread)
+        m_canceled.store(1);
+}
+
+
+//-----------------------------------------------------------------------------
+// Private slots
+//-----------------------------------------------------------------------------
+
+void ImportManager::importTaskErrorSlot(const QString &message)
+{
+    m_importTaskThread = 0;
+    emit importTaskFailed(message);
+}
+
+void ImportManager::importTaskFinishedSlot(int recordCount)
+{
+    m_importTaskThread = 0;
+    emit importCompleted(recordCount);
+}
+
+void ImportManager::importTaskCanceledSlot()
+{
+    m_importTaskThread = 0;
+    emit importCanceled();
+}
+
+
+//-----------------------------------------------------------------------------
+// Private
+//-----------------------------------------------------------------------------
+
+void ImportManager::createImportThreadConnections(QThread *thread,
+                                                  ImportTask *importTask)
+{
+    //thread start and stop, quit directly from the task thread,
+    //so the thread stops even while the GUI thread waits on it
+    connect(thread, SIGNAL(started()),
+            importTask, SLOT(startImportTask()));
+    connect(importTask, SIGNAL(finishedSignal(int)),
+            thread, SLOT(quit()), Qt::DirectConnection);
+    connect(importTask, SIGNAL(canceledSignal()),
+            thread, SLOT(quit()), Qt::DirectConnection);
+    connect(importTask, SIGNAL(errorSignal(QString)),
+            thread, SLOT(quit()), Qt::DirectConnection);
+
+    //importTask delete
+    connect(importTask, SIGNAL(finishedSignal(int)),
+            importTask, SLOT(deleteLater()));
+    connect(importTask, SIGNAL(canceledSignal()),
+            importTask, SLOT(deleteLater()));
+    connect(importTask, SIGNAL(errorSignal(QString)),
+            importTask, SLOT(deleteLater()));
+
+    //thread delete
+    connect(thread, SIGNAL(finished()),
+            thread, SLOT(deleteLater()));
+
+    //importTask signals
+    connect(importTask, SIGNAL(errorSignal(QString)),
+            this, SLOT(importTaskErrorSlot(QString)));
+    connect(importTask, SIGNAL(finishedSignal(int)),
+            this, SLOT(importTaskFinishedSlot(int)));
+    connect(importTask, SIGNAL(canceledSignal()),
+            this, SLOT(importTaskCanceledSlot()));
+    connect(importTask, SIGNAL(progressSignal(int,int)),
+            this, SIGNAL(progressSignal(int,int)));
+}
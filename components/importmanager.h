@@ -0,0 +1,159 @@
+/**
+  * \class ImportManager
+  * \brief This class is used to import records from delimited text
+  *        files (CSV, TSV) into a collection. The file is streamed on a
+  *        worker thread which has its own database connection. CSV
+  *        columns are mapped to fields, values are converted by field
+  *        type and inserted with a single prepared statement in batched
+  *        transactions. Views are not notified while importing, the
+  *        caller resets its model once the import is completed.
+  * \author Giorgio Wicklein - GIOWISYS Software
+  * \date 19/10/2026
+  */
+
+#ifndef IMPORTMANAGER_H
+#define IMPORTMANAGER_H
+
+
+//-----------------------------------------------------------------------------
+// Headers
+//-----------------------------------------------------------------------------
+
+#include "metadataengine.h"
+
+#include <QtCore/QObject>
+#include <QtCore/QAtomicInt>
+#include <QtCore/QStringList>
+
+
+//-----------------------------------------------------------------------------
+// Forward declarations
+//-----------------------------------------------------------------------------
+
+class QThread;
+
+class ImportTask : public QObject
+{
+    Q_OBJECT
+public:
+    ImportTask(const QString &databasePath,
+               const QAtomicInt *canceled,
+               QObject *parent = nullptr);
+    ~ImportTask();
+    void configureTask(const QString &filePath,
+                       int collectionId,
+                       const QList<int> &fieldColumns,
+                       QChar separator,
+                       const QByteArray &codecName,
+                       bool hasHeader);
+
+    /**
+     * Convert a CSV value to the storage format of the field type
+     * @param value - the CSV field value
+     * @param type - the data type of the field
+     * @param items - the item names of combobox fields
+     * @return the converted value, null if empty or not valid
+     */
+    static QVariant convertValue(const QString &value,
+                                 MetadataEngine::FieldType type,
+                                 const QStringList &items = QStringList());
+
+    /**
+     * Guess the field type of a CSV column from sample values.
+     * Numbers, dates, URLs and email addresses are detected,
+     * anything else is text. Empty values are ignored.
+     */
+    static MetadataEngine::FieldType detectFieldType(const QStringList &values);
+public slots:
+    void startImportTask();
+signals:
+    void finishedSignal(int recordCount);
+    void canceledSignal();
+    void progressSignal(int currentStep, int totalSteps);
+    void errorSignal(const QString &message);
+private:
+    bool import(int &recordCount, QString &errorMessage);
+    QString m_dbPath;
+    QString m_filePath;
+    QString m_tableName;
+    QList<int> m_fieldColumns; /**< Collection column of each CSV column */
+    QList<int> m_fieldKeys;
+    QList<MetadataEngine::FieldType> m_fieldTypes;
+    QList<QStringList> m_fieldItems;
+    QChar m_separator;
+    QByteArray m_codecName;
+    bool m_hasHeader;
+    const QAtomicInt *m_canceled; /**< Set by ImportManager to stop the task */
+    int m_batchSize;
+};
+
+
+//-----------------------------------------------------------------------------
+// ImportManager
+//-----------------------------------------------------------------------------
+
+class ImportManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ImportManager(QObject *parent = nullptr);
+    ~ImportManager();
+
+    /**
+     * Start an async import of a delimited text file.
+     * Once completed, the importCompleted() signal is emitted.
+     * @param filePath - the path of the file to import
+     * @param collectionId - the collection where records are added
+     * @param fieldColumns - for each CSV column the collection column
+     *                       of the target field, 0 to skip the CSV column
+     * @param separator - the field separator
+     * @param codecName - the text encoding of the file
+     * @param hasHeader - whether the first row holds field names
+     */
+    void startImport(const QString &filePath,
+                     int collectionId,
+                     const QList<int> &fieldColumns,
+                     QChar separator,
+                     const QByteArray &codecName,
+                     bool hasHeader = true);
+
+    /** Whether an import task is running */
+    bool isImportRunning() const;
+
+public slots:
+    /**
+     * Cancel the import task, if running. This doesn't block,
+     * importCanceled() is emitted once the task has stopped.
+     * Records of already committed batches are kept.
+     */
+    void stopImportTask();
+
+signals:
+    /** This signal is emitted when a startImport() request completes */
+    void importCompleted(int recordCount);
+
+    /** This signal is emitted when the import task has been canceled */
+    void importCanceled();
+
+    /** Emitted when an error occurred during the import task */
+    void importTaskFailed(const QString &message);
+
+    /** Emitted to signal progress state of the import task */
+    void progressSignal(int currentStep, int totalSteps);
+
+private slots:
+    void importTaskErrorSlot(const QString &message);
+    void importTaskFinishedSlot(int recordCount);
+    void importTaskCanceledSlot();
+
+private:
+    void createImportThreadConnections(QThread *thread,
+                                       ImportTask *importTask);
+
+    QThread *m_importTaskThread;
+    QAtomicInt m_canceled;
+    QString m_databasePath; /**< The path where database file is saved */
+};
+
+#endif // IMPORTMANAGER_H
@@ -16,12 +16,19 @@
 #include <QtCore/QStringList>
 #include <QtCore/QDateTime>
 #include <QtCore/QCryptographicHash>
+#include <QtCore/QTimer>
 
 
 //-----------------------------------------------------------------------------
 // Static init
 //-----------------------------------------------------------------------------
 
+/** Field usage count after which an index is created */
+static const int INDEX_USAGE_THRESHOLD = 2;
+
+/** Time without field usage after which queued indexes are created */
+static const int INDEX_IDLE_DELAY_MS = 1000;
+
 MetadataEngine* MetadataEngine::m_instance = 0;
 int MetadataEngine::m_currentCollectionId = 0;
 QStringList* MetadataEngine::m_currentCollectionFieldNameList = 0;
@@ -49,16 +56,9 @@ QString MetadataEngine::getCollectionName(const int collectionId) const
 {
     QString name("_collection_invalid_"); //invalid placeholder
 
-    QSqlDatabase db = DatabaseManager::getInstance().getDatabase();
-    QSqlQuery query(db);
-
-    query.prepare("SELECT name FROM collections WHERE _id=:collectionId");
-    query.bindValue(":collectionId", collectionId);
-    query.exec();
-
-    if (query.next()) {
-        name = query.value(0).toString();
-    }
+    CollectionInfo info;
+    if (getCollectionInfo(collectionId, info))
+        name = info.name;
 
     return name;
 }
@@ -112,6 +112,10 @@ void MetadataEngine::setCurrentCollectionId(const int id)
 
 QString MetadataEngine::getCurrentCollectionName() const
 {
+    //if the current id is cached, so is the name
+    if (m_currentCollectionId)
+        return getCollectionName(m_currentCollectionId);
+
     QString name("_collection_invalid_"); //invalid placeholder
 
     QSqlDatabase db = DatabaseManager::getInstance().getDatabase();
@@ -145,17 +149,25 @@ QString MetadataEngine::getTableName(const int collectionId) const
 {
     QString tableName("_invalid_table_name_"); //placeholder for invalid table name
 
-    QSqlQuery query(DatabaseManager::getInstance().getDatabase());
-    query.prepare("SELECT table_name FROM collections WHERE _id=:id");
-    query.bindValue(":id", collectionId);
-    query.exec();
-
-    if (query.next())
-        tableName = query.value(0).toString();
+    CollectionInfo info;
+    if (getCollectionInfo(collectionId, info))
+        tableName = info.tableName;
 
     return tableName;
 }
 
+MetadataEngine::CollectionType MetadataEngine::getCollectionType(
+        const int collectionId) const
+{
+    CollectionType type = StandardCollection; //for now the only supported type
+
+    CollectionInfo info;
+    if (getCollectionInfo(collectionId, info) && info.type)
+        type = (CollectionType) info.type;
+
+    return type;
+}
+
 QString MetadataEngine::getFieldName(const int column, int collectionId) const
 {
     QString name("_invalid_column_name_"); //placeholder for invalid column name
@@ -177,7 +189,7 @@ void MetadataEngine::setFieldName(const int column, const QString &name,
 {
     QString metadataTable = getTableName(collectionId).append("_metadata");
     QSqlQuery query(DatabaseManager::getInstance().getDatabase());
-    QString columnKey = QString("col%1_name").arg(column);
+    QString columnKey = QString("col%1_name").arg(getFieldKey(column, collectionId));
 
     query.prepare(QString("UPDATE '%1' SET value=:name WHERE key=:column_id")
                          .arg(metadataTable)); //arg because bindValue() fails
@@ -197,13 +209,28 @@ int MetadataEngine::getFieldCount(int collectionId) const
         return getFieldCountFromDatabase(collectionId);
 }
 
+int MetadataEngine::getFieldKey(const int column, int collectionId) const
+{
+    QList<int> fieldKeys = fieldKeyList(collectionId);
+
+    if ((column < 0) || (column >= fieldKeys.size()))
+        return -1;
+
+    return fieldKeys.at(column);
+}
+
+int MetadataEngine::getFieldColumn(const int fieldKey, int collectionId) const
+{
+    return fieldKeyList(collectionId).indexOf(fieldKey);
+}
+
 MetadataEngine::FieldType MetadataEngine::getFieldType(int column,
                                                        int collectionId) const
 {
     FieldType type = TextType; //default
 
     QSqlQuery query(DatabaseManager::getInstance().getDatabase());
-    QString columnKey = QString("col%1_type").arg(column);
+    QString columnKey = QString("col%1_type").arg(getFieldKey(column, collectionId));
     QString metadataTable = getTableName(collectionId).append("_metadata");
 
     query.prepare(QString("SELECT value FROM '%1' WHERE key=:key").arg(metadataTable));
@@ -223,7 +250,7 @@ bool MetadataEngine::getFieldCoordinate(const int column, int &xpos,
     xpos = ypos = 0; //avoid random garbage values
 
     QSqlQuery query(DatabaseManager::getInstance().getDatabase());
-    QString columnKey = QString("col%1_pos").arg(column);
+    QString columnKey = QString("col%1_pos").arg(getFieldKey(column, collectionId));
     QString metadataTable = getTableName(collectionId).append("_metadata");
 
     query.prepare(QString("SELECT value FROM '%1' WHERE key=:key").arg(metadataTable));
@@ -252,7 +279,7 @@ void MetadataEngine::setFieldCoordinate(const int column, const int xpos,
 {
     QString metadataTable = getTableName(collectionId).append("_metadata");
     QSqlQuery query(DatabaseManager::getInstance().getDatabase());
-    QString columnKey = QString("col%1_pos").arg(column);
+    QString columnKey = QString("col%1_pos").arg(getFieldKey(column, collectionId));
 
     //buid coordinate string
     QString posString = QString::number(xpos) + ";" + QString::number(ypos);
@@ -270,7 +297,7 @@ void MetadataEngine::getFieldFormLayoutSize(const int column, int &widthUnits,
     heightUnits = widthUnits = -1; //-1 means not set (use default)
 
     QSqlQuery query(DatabaseManager::getInstance().getDatabase());
-    QString columnKey = QString("col%1_size").arg(column);
+    QString columnKey = QString("col%1_size").arg(getFieldKey(column, collectionId));
     QString metadataTable = getTableName(collectionId).append("_metadata");
 
     query.prepare(QString("SELECT value FROM '%1' WHERE key=:key").arg(metadataTable));
@@ -294,7 +321,7 @@ void MetadataEngine::setFieldFormLayoutSize(const int column, const int widthUni
 {
     QString metadataTable = getTableName(collectionId).append("_metadata");
     QSqlQuery query(DatabaseManager::getInstance().getDatabase());
-    QString columnKey = QString("col%1_size").arg(column);
+    QString columnKey = QString("col%1_size").arg(getFieldKey(column, collectionId));
 
     //buid size string
     QString sizeString = QString::number(widthUnits) + ";"
@@ -319,13 +346,13 @@ QString MetadataEngine::getFieldProperties(FieldProperty propertyType,
 
     switch (propertyType) {
     case DisplayProperty:
-        columnKey = QString("col%1_display").arg(column);
+        columnKey = QString("col%1_display").arg(getFieldKey(column, collectionId));
         break;
     case EditProperty:
-        columnKey = QString("col%1_edit").arg(column);
+        columnKey = QString("col%1_edit").arg(getFieldKey(column, collectionId));
         break;
     case TriggerProperty:
-        columnKey = QString("col%1_trigger").arg(column);
+        columnKey = QString("col%1_trigger").arg(getFieldKey(column, collectionId));
         break;
     }
 
@@ -351,13 +378,13 @@ void MetadataEngine::setFieldProperties(FieldProperty propertyType,
 
     switch (propertyType) {
     case DisplayProperty:
-        columnKey = QString("col%1_display").arg(column);
+        columnKey = QString("col%1_display").arg(getFieldKey(column, collectionId));
         break;
     case EditProperty:
-        columnKey = QString("col%1_edit").arg(column);
+        columnKey = QString("col%1_edit").arg(getFieldKey(column, collectionId));
         break;
     case TriggerProperty:
-        columnKey = QString("col%1_trigger").arg(column);
+        columnKey = QString("col%1_trigger").arg(getFieldKey(column, collectionId));
         break;
     }
 
@@ -392,11 +419,13 @@ int MetadataEngine::createNewCollection()
     //since a new entry in the collection table
     //is added by the CollectionListView
     //get last created collection
-    query.exec("SELECT _id FROM collections ORDER BY _id DESC");
+    QString name;
+    query.exec("SELECT _id,name FROM collections ORDER BY _id DESC");
 
     if (query.next()) {
         //get the first, which is the last created collection
         id = query.value(0).toInt();
+        name = query.value(1).toString();
     }
 
     //create table name hash
@@ -424,10 +453,21 @@ int MetadataEngine::createNewCollection()
                        " , \"key\" TEXT, \"value\" TEXT)").arg(metadataTableName));
     query.exec(QString("INSERT INTO '%1' (\"key\",\"value\") VALUES (\"column_count\", 1)")
                .arg(metadataTableName));
+    query.exec(QString("INSERT INTO '%1' (\"key\",\"value\") VALUES (\"next_field_id\", 1)")
+               .arg(metadataTableName));
 
     //commit transaction
     db.commit();
 
+    //update collection cache
+    if (id) {
+        CollectionInfo info;
+        info.name = name;
+        info.tableName = tableName;
+        info.type = type;
+        m_collectionHash.insert(id, info);
+    }
+
     return id;
 }
 
@@ -439,19 +479,22 @@ void MetadataEngine::deleteCollection(int collectionId)
     QSqlQuery query(db);
 
     //get table name
-    query.prepare("SELECT table_name FROM collections WHERE _id=:id");
-    query.bindValue(":id", collectionId);
-    query.exec();
-
-    if (query.next()) {
-        //get the first, which is the last created collection
-        tableName = query.value(0).toString();
+    CollectionInfo info;
+    if (getCollectionInfo(collectionId, info)) {
+        tableName = info.tableName;
         metadataTableName = tableName + "_metadata";
     }
 
     //start transaction to speed up writes
     db.transaction();
 
+    //delete sort key tables, if any
+    foreach (int fieldKey, fieldKeyList(collectionId)) {
+        QString sortTable = sortKeyTableName(tableName, fieldKey);
+        query.exec(QString("DROP TABLE IF EXISTS '%1'").arg(sortTable));
+        m_sortKeyStampHash.remove(sortTable);
+    }
+
     //delete content data table
     query.exec(QString("DROP TABLE '%1'").arg(tableName));
 
@@ -460,6 +503,11 @@ void MetadataEngine::deleteCollection(int collectionId)
 
     //commit transaction
     db.commit();
+
+    m_fieldUsageHash.remove(collectionId);
+    m_pendingIndexHash.remove(collectionId);
+    m_fieldKeyHash.remove(collectionId);
+    m_collectionHash.remove(collectionId);
 }
 
 void MetadataEngine::deleteAllRecords(int collectionId)
@@ -478,7 +526,7 @@ int MetadataEngine::createField(const QString &fieldName, FieldType type,
     QSqlDatabase db = DatabaseManager::getInstance().getDatabase();
     QSqlQuery query(db);
 
-    int fieldId = getFieldCount(collectionId);
+    int column = getFieldCount(collectionId);
     QString tableName = getTableName(collectionId);
     QString metadataTable = tableName + "_metadata";
     QString dataTypeName = dataTypeSqlName(type);
@@ -486,12 +534,15 @@ int MetadataEngine::createField(const QString &fieldName, FieldType type,
     //start transaction to speed up writes
     db.transaction();
 
+    //the field is appended at column count, but named by a new id
+    int fieldKey = allocateFieldKey(collectionId);
+
     //add column to data table
     query.exec(QString("ALTER TABLE '%1' ADD '%2' %3").arg(tableName)
-               .arg(fieldId).arg(dataTypeName));
+               .arg(fieldKey).arg(dataTypeName));
 
     //update metadata field count
-    int columnCount = fieldId + 1;
+    int columnCount = column + 1;
     query.prepare(QString("UPDATE '%1' SET value=:count WHERE key='column_count'")
                          .arg(metadataTable)); //arg because bindValue() fails
     query.bindValue(":count", columnCount);
@@ -499,52 +550,53 @@ int MetadataEngine::createField(const QString &fieldName, FieldType type,
 
     //metadata column pos
     query.exec(QString("INSERT INTO '%1' (\"key\",\"value\") VALUES (\"col%2_pos\","
-                       "\"-1;-1\")").arg(metadataTable).arg(fieldId));
+                       "\"-1;-1\")").arg(metadataTable).arg(fieldKey));
 
     //metadata column size
     query.exec(QString("INSERT INTO '%1' (\"key\",\"value\") VALUES (\"col%2_size\","
-                       "\"-1;-1\")").arg(metadataTable).arg(fieldId));
+                       "\"-1;-1\")").arg(metadataTable).arg(fieldKey));
 
     //metadata display properties
     query.exec(QString("INSERT INTO '%1' (\"key\",\"value\") VALUES (\"col%2_display\","
-                       "\"%3\")").arg(metadataTable).arg(fieldId)
+                       "\"%3\")").arg(metadataTable).arg(fieldKey)
                .arg(displayProperties));
 
     //metadata edit properties
     query.exec(QString("INSERT INTO '%1' (\"key\",\"value\") VALUES (\"col%2_edit\","
-                       "\"%3\")").arg(metadataTable).arg(fieldId)
+                       "\"%3\")").arg(metadataTable).arg(fieldKey)
                .arg(editProperties));
 
     //metadata trigger properties
     query.exec(QString("INSERT INTO '%1' (\"key\",\"value\") VALUES (\"col%2_trigger\","
-                       "\"%3\")").arg(metadataTable).arg(fieldId)
+                       "\"%3\")").arg(metadataTable).arg(fieldKey)
                .arg(triggerProperties));
 
     //metadata column name
     QString fieldNameEscaped = QString(fieldName).replace("\"", "\"\""); //escape double quotes for SQL
     query.exec(QString("INSERT INTO '%1' (\"key\",\"value\") VALUES (\"col%2_name\","
-                       "\"%3\")").arg(metadataTable).arg(fieldId)
+                       "\"%3\")").arg(metadataTable).arg(fieldKey)
                .arg(fieldNameEscaped));
 
     //metadata column type
     query.exec(QString("INSERT INTO '%1' (\"key\",\"value\") VALUES (\"col%2_type\","
-                       "\"%3\")").arg(metadataTable).arg(fieldId)
+                       "\"%3\")").arg(metadataTable).arg(fieldKey)
                .arg((int) type));
 
     //commit transaction
     db.commit();
 
     //update cached metadata
+    m_fieldKeyHash.remove(collectionId);
     updateFieldNameCache();
 
     //notify the change
     if (collectionId == m_currentCollectionId)
         emit currentCollectionChanged();
 
-    return fieldId;
+    return column;
 }
 
-void MetadataEngine::modifyField(const int &fieldId, const QString &fieldName,
+void MetadataEngine::modifyField(const int &column, const QString &fieldName,
                                  const QString &displayProperties,
                                  const QString &editProperties,
                                  const QString &triggerProperties,
@@ -555,6 +607,7 @@ void MetadataEngine::modifyField(const int &fieldId, const QString &fieldName,
 
     QString tableName = getTableName(collectionId);
     QString metadataTable = tableName + "_metadata";
+    int fieldKey = getFieldKey(column, collectionId);
 
     //start transaction to speed up writes
     db.transaction();
@@ -563,28 +616,28 @@ void MetadataEngine::modifyField(const int &fieldId, const QString &fieldName,
     query.prepare(QString("UPDATE '%1' SET value=:fieldName WHERE key=:columnKey")
                          .arg(metadataTable));
     query.bindValue(":fieldName", fieldName);
-    query.bindValue(":columnKey", QString("col%1_name").arg(fieldId));
+    query.bindValue(":columnKey", QString("col%1_name").arg(fieldKey));
     query.exec();
 
     //update display properties
     query.prepare(QString("UPDATE '%1' SET value=:properties WHERE key=:columnKey")
                          .arg(metadataTable));
     query.bindValue(":properties", displayProperties);
-    query.bindValue(":columnKey", QString("col%1_display").arg(fieldId));
+    query.bindValue(":columnKey", QString("col%1_display").arg(fieldKey));
     query.exec();
 
     //update edit properties
     query.prepare(QString("UPDATE '%1' SET value=:properties WHERE key=:columnKey")
                          .arg(metadataTable));
     query.bindValue(":properties", editProperties);
-    query.bindValue(":columnKey", QString("col%1_edit").arg(fieldId));
+    query.bindValue(":columnKey", QString("col%1_edit").arg(fieldKey));
     query.exec();
 
     //update trigger properties
     query.prepare(QString("UPDATE '%1' SET value=:properties WHERE key=:columnKey")
                          .arg(metadataTable));
     query.bindValue(":properties", triggerProperties);
-    query.bindValue(":columnKey", QString("col%1_trigger").arg(fieldId));
+    query.bindValue(":columnKey", QString("col%1_trigger").arg(fieldKey));
     query.exec();
 
     //commit transaction
@@ -598,61 +651,39 @@ void MetadataEngine::modifyField(const int &fieldId, const QString &fieldName,
         emit currentCollectionChanged();
 }
 
-void MetadataEngine::deleteField(const int fieldId, int collectionId)
+void MetadataEngine::deleteField(const int column, int collectionId)
 {
     QSqlDatabase db = DatabaseManager::getInstance().getDatabase();
     QSqlQuery query(db);
 
     QString tableName = getTableName(collectionId);
     QString metadataTable = tableName + "_metadata";
+    int fieldCount = getFieldCount(collectionId);
+    int fieldKey = getFieldKey(column, collectionId);
 
     //start transaction to speed up writes
     db.transaction();
 
-    //SQLite has no support form column dropping
-    //so build custom procedure
-    int fieldCount = getFieldCount(collectionId);
+    //other fields keep their ids, so only the own index is affected
+    query.exec(QString("DROP INDEX IF EXISTS \"%1\"")
+               .arg(fieldIndexName(tableName, fieldKey)));
+    query.exec(QString("DROP TABLE IF EXISTS '%1'")
+               .arg(sortKeyTableName(tableName, fieldKey)));
+    m_sortKeyStampHash.remove(sortKeyTableName(tableName, fieldKey));
+
+    //delete column keys, GLOB because '_' is a wildcard in LIKE
+    //and col1_% would match col10_* too
+    query.exec(QString("DELETE FROM '%1' WHERE key GLOB 'col%2_*'")
+               .arg(metadataTable).arg(fieldKey));
+
+    if (DatabaseManager::getInstance().hasDropColumn()) {
+        query.exec(QString("ALTER TABLE '%1' DROP COLUMN \"%2\"")
+                   .arg(tableName).arg(fieldKey));
+    } else {
+        rebuildDataTable(tableName, fieldKey);
 
-    //generate column list to keep
-    QString columnsToKeep;
-    columnsToKeep.append("\"_id\"");
-    for (int i = 1; i < fieldCount; i++) {
-        columnsToKeep.append(QString(",\"%1\"").arg(i));
-    }
-    //remove the field id marked for deletion from list
-    columnsToKeep.remove(QString(",\"%1\"").arg(fieldId));
-
-    //create field type list
-    QStringList fieldTypes;
-    fieldTypes.append("INTEGER PRIMARY KEY"); //0 is _id
-    for (int i = 1; i < fieldCount; i++) {
-        FieldType type = getFieldType(i, collectionId);
-        fieldTypes.append(dataTypeSqlName(type));
-    }
-    //remove fieldType for column marked for deletion
-    fieldTypes.removeAt(fieldId);
-
-    //generate column definition for new table without specified column
-    QString columnDefinition;
-    columnDefinition.append("\"_id\" INTEGER PRIMARY KEY"); //_id column 0
-    for (int i = 1; i < (fieldCount - 1);i++) {
-        columnDefinition.append(QString(",\"%1\" %2").arg(i).arg(fieldTypes.at(i)));
-    }
-
-    QString dropSQL = QString(
-                "CREATE TEMPORARY TABLE t_backup(%1);"
-                "INSERT INTO t_backup SELECT %2 FROM '%3';"
-                "DROP TABLE '%3';"
-                "CREATE TABLE '%3'(%1);"
-                "INSERT INTO '%3' SELECT * FROM t_backup;"
-                "DROP TABLE t_backup;"
-                ).arg(columnDefinition).arg(columnsToKeep).arg(tableName);
-    //execute drop column procedure
-    //splitting commands because query.exec()
-    //can execute only one command at time
-    QStringList commands = dropSQL.split(';', QString::SkipEmptyParts);
-    foreach (QString q, commands) {
-        query.exec(q);
+        //indexes were dropped with the old table
+        restoreFieldIndexes(collectionId);
     }
 
     //update metadata column count
@@ -661,45 +692,14 @@ void MetadataEngine::deleteField(const int fieldId, int collectionId)
     query.bindValue(":count", fieldCount - 1);
     query.exec();
 
-    //mark column keys for deletion
-    query.exec(QString("UPDATE '%1' SET key='del_me' WHERE key LIKE 'col%2%'")
-               .arg(metadataTable).arg(fieldId));
-
-    //make a list of all column keys after the one to delete
-    //that need to be decremented
-    QStringList columnsToDecrement;
-    QStringList decrementedColumns;
-    query.exec(QString("SELECT key FROM '%1' WHERE key LIKE 'col%_%' "
-                       "AND key != 'column_count'")
-               .arg(metadataTable));
-    while (query.next()) {
-        QString key = query.value(0).toString();
-        QString s = key;
-        int column = s.remove(QRegExp("\\D")).toInt(); //extract column id
-        if (column > fieldId) {
-            columnsToDecrement.append(key);
-            QString newKey = key;
-            newKey.replace(QString::number(column), QString::number(column-1));
-            decrementedColumns.append(newKey);
-        }
-    }
-
-    //write new column keys
-    for (int i = 0; i < columnsToDecrement.size(); i++) {
-        query.prepare(QString("UPDATE '%1' SET key=:newKey WHERE key=:oldKey")
-                      .arg(metadataTable));
-        query.bindValue(":newKey", decrementedColumns.at(i));
-        query.bindValue(":oldKey", columnsToDecrement.at(i));
-        query.exec();
-    }
-
-    //delete column keys marked for deletion
-    query.exec(QString("DELETE FROM '%1' WHERE key='del_me'").arg(metadataTable));
-
     //commit transaction
     db.commit();
 
+    //usage counts are by field key, only this field is gone
+    m_fieldUsageHash[collectionId].remove(fieldKey);
+
     //update cached metadata
+    m_fieldKeyHash.remove(collectionId);
     updateFieldNameCache();
 
     //notify the change
@@ -707,6 +707,230 @@ void MetadataEngine::deleteField(const int fieldId, int collectionId)
         emit currentCollectionChanged();
 }
 
+void MetadataEngine::registerFieldUsage(const int column, FieldUsage usage,
+                                        int collectionId)
+{
+    Q_UNUSED(usage); //for now all accesses are weighted the same
+
+    if ((column < 1) || (column >= getFieldCount(collectionId)))
+        return; //_id is the primary key
+
+    int &count = m_fieldUsageHash[collectionId][getFieldKey(column, collectionId)];
+    count++;
+
+    //check only once per session when the threshold is reached,
+    //creating the index can take long, so it is queued
+    if ((count == INDEX_USAGE_THRESHOLD) && !hasFieldIndex(column, collectionId))
+        m_pendingIndexHash[collectionId].append(getFieldKey(column, collectionId));
+
+    //restart the delay on every access
+    if (!m_pendingIndexHash.isEmpty())
+        m_indexTimer->start();
+}
+
+bool MetadataEngine::hasFieldIndex(const int column, int collectionId) const
+{
+    QSqlQuery query(DatabaseManager::getInstance().getDatabase());
+    QString metadataTable = getTableName(collectionId).append("_metadata");
+
+    query.prepare(QString("SELECT value FROM '%1' WHERE key=:key")
+                  .arg(metadataTable));
+    query.bindValue(":key", QString("col%1_index")
+                    .arg(getFieldKey(column, collectionId)));
+    query.exec();
+
+    return query.next();
+}
+
+void MetadataEngine::createFieldIndex(const int column, int collectionId)
+{
+    QSqlDatabase db = DatabaseManager::getInstance().getDatabase();
+    QSqlQuery query(db);
+
+    QString tableName = getTableName(collectionId);
+    QString metadataTable = tableName + "_metadata";
+    int fieldKey = getFieldKey(column, collectionId);
+
+    if (hasFieldIndex(column, collectionId))
+        return;
+
+    //text is sorted by its sort keys, so these are indexed
+    bool sortKey = hasSortKey(column, collectionId);
+    if (sortKey)
+        updateSortKeys(column, collectionId);
+
+    //start transaction to speed up writes
+    db.transaction();
+
+    createFieldKeyIndex(tableName, fieldKey, sortKey);
+
+    //mark field as indexed
+    query.exec(QString("INSERT INTO '%1' (\"key\",\"value\") VALUES (\"col%2_index\","
+                       "\"1\")").arg(metadataTable).arg(fieldKey));
+
+    //commit transaction
+    db.commit();
+}
+
+void MetadataEngine::dropFieldIndex(const int column, int collectionId)
+{
+    QSqlDatabase db = DatabaseManager::getInstance().getDatabase();
+    QSqlQuery query(db);
+
+    QString tableName = getTableName(collectionId);
+    QString metadataTable = tableName + "_metadata";
+    int fieldKey = getFieldKey(column, collectionId);
+
+    //start transaction to speed up writes
+    db.transaction();
+
+    query.exec(QString("DROP INDEX IF EXISTS \"%1\"")
+               .arg(fieldIndexName(tableName, fieldKey)));
+    query.exec(QString("DELETE FROM '%1' WHERE key='col%2_index'")
+               .arg(metadataTable).arg(fieldKey));
+
+    //commit transaction
+    db.commit();
+
+    m_fieldUsageHash[collectionId].remove(fieldKey);
+}
+
+bool MetadataEngine::hasSortKey(const int column, int collectionId) const
+{
+    if ((column < 1) || (column >= getFieldCount(collectionId)))
+        return false; //_id is sorted by value
+
+    switch (getFieldType(column, collectionId)) {
+    case TextType:
+    case URLTextType:
+    case EmailTextType:
+        return true;
+    default:
+        return false;
+    }
+}
+
+QString MetadataEngine::getSortKeyTableName(const int column,
+                                            int collectionId) const
+{
+    return sortKeyTableName(getTableName(collectionId),
+                            getFieldKey(column, collectionId));
+}
+
+void MetadataEngine::updateSortKeys(const int column, int collectionId)
+{
+    if (!hasSortKey(column, collectionId))
+        return;
+
+    QSqlQuery query(DatabaseManager::getInstance().getDatabase());
+    QString tableName = getTableName(collectionId);
+    int fieldKey = getFieldKey(column, collectionId);
+    QString sortTable = sortKeyTableName(tableName, fieldKey);
+
+    //nothing written since the last update, keys are current
+    QString changeStamp = databaseChangeStamp();
+    if (m_sortKeyStampHash.value(sortTable) == changeStamp)
+        return;
+
+    //a savepoint, because the caller may have started a transaction
+    query.exec("SAVEPOINT sort_keys");
+
+    query.prepare("SELECT name FROM sqlite_master WHERE type='table' AND name=:name");
+    query.bindValue(":name", sortTable);
+    query.exec();
+    if (!query.next()) {
+        query.exec(QString("CREATE TABLE '%1' (\"record_id\" INTEGER PRIMARY KEY,"
+                           " \"source\" TEXT, \"key\" TEXT)").arg(sortTable));
+
+        //fields indexed by their text before they had a sort key
+        if (hasFieldIndex(column, collectionId)) {
+            query.exec(QString("DROP INDEX IF EXISTS \"%1\"")
+                       .arg(fieldIndexName(tableName, fieldKey)));
+            createFieldKeyIndex(tableName, fieldKey, true);
+        }
+    }
+
+    //keys of deleted records
+    query.exec(QString("DELETE FROM '%1' WHERE \"record_id\" NOT IN"
+                       " (SELECT \"_id\" FROM '%2')")
+               .arg(sortTable).arg(tableName));
+
+    //records without key or changed since their key was created
+    QVariantList recordIds;
+    QVariantList sources;
+    QVariantList keys;
+    query.exec(QString("SELECT d.\"_id\", d.\"%3\" FROM '%1' d LEFT JOIN '%2' s"
+                       " ON s.\"record_id\" = d.\"_id\" WHERE"
+                       " s.\"record_id\" IS NULL OR s.\"source\" IS NOT d.\"%3\"")
+               .arg(tableName).arg(sortTable).arg(fieldKey));
+    while (query.next()) {
+        QVariant source = query.value(1);
+        recordIds.append(query.value(0));
+        sources.append(source);
+        if (source.isNull())
+            keys.append(QVariant(QVariant::String));
+        else
+            keys.append(createSortKey(source.toString()));
+    }
+
+    if (!recordIds.isEmpty()) {
+        query.prepare(QString("INSERT OR REPLACE INTO '%1' (\"record_id\","
+                              "\"source\",\"key\") VALUES (?,?,?)")
+                      .arg(sortTable));
+        query.addBindValue(recordIds);
+        query.addBindValue(sources);
+        query.addBindValue(keys);
+        query.execBatch();
+    }
+
+    query.exec("RELEASE sort_keys");
+
+    //after the own writes, so they don't cause another update
+    m_sortKeyStampHash.insert(sortTable, databaseChangeStamp());
+}
+
+QString MetadataEngine::createSortKey(const QString &text)
+{
+    //compatibility decomposition splits umlauts and accented letters
+    //into base letter and combining mark, the mark is dropped below
+    QString folded = text.normalized(QString::NormalizationForm_KD)
+            .toCaseFolded();
+    folded.replace(QChar(0x00DF), "ss"); //sharp s
+
+    QString key;
+    key.reserve(folded.size() + 4);
+
+    int size = folded.size();
+    int i = 0;
+    while (i < size) {
+        QChar c = folded.at(i);
+
+        if (c.isDigit()) {
+            //digit sequences compare by value: leading zeros are skipped
+            //and the digit count is prepended, so 9 sorts before 10
+            QString number;
+            while ((i < size) && folded.at(i).isDigit()) {
+                int digit = folded.at(i).digitValue();
+                if (!number.isEmpty() || digit)
+                    number.append(QChar('0' + digit));
+                i++;
+            }
+            if (number.isEmpty())
+                number = "0";
+            key.append(QString("%1").arg(qMin(number.size(), 99), 2, 10,
+                                         QChar('0')));
+            key.append(number);
+            continue;
+        }
+
+        if (c.category() != QChar::Mark_NonSpacing)
+            key.append(c);
+        i++;
+    }
+
+    return key;
+}
+
 int MetadataEngine::addContentFile(const QString &fileName,
                                     const QString &hashName)
 {
@@ -840,6 +1064,44 @@ int MetadataEngine::getContentFileId(const QString &hashName)
 void MetadataEngine::setDirtyCurrentColleectionId()
 {
     m_currentCollectionId = 0;
+    m_fieldKeyHash.clear();
+    m_fieldUsageHash.clear();
+    m_pendingIndexHash.clear();
+    m_sortKeyStampHash.clear();
+    setDirtyCollectionCache();
+}
+
+void MetadataEngine::setDirtyCollectionCache(int collectionId)
+{
+    if (collectionId) {
+        m_collectionHash.remove(collectionId);
+    } else {
+        m_collectionHash.clear();
+        m_collectionHashLoaded = false;
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Public slots
+//-----------------------------------------------------------------------------
+
+void MetadataEngine::createPendingFieldIndexes()
+{
+    m_indexTimer->stop();
+
+    QHash<int, QList<int> > pending = m_pendingIndexHash;
+    m_pendingIndexHash.clear();
+
+    QHash<int, QList<int> >::const_iterator it = pending.constBegin();
+    for (; it != pending.constEnd(); ++it) {
+        foreach (int fieldKey, it.value()) {
+            //the field may have been deleted meanwhile
+            int column = getFieldColumn(fieldKey, it.key());
+            if (column > 0)
+                createFieldIndex(column, it.key());
+        }
+    }
 }
 
 
@@ -848,10 +1110,16 @@ void MetadataEngine::setDirtyCurrentColleectionId()
 //-----------------------------------------------------------------------------
 
 MetadataEngine::MetadataEngine(QObject *parent) :
-    QObject(parent)
+    QObject(parent), m_collectionHashLoaded(false)
 {
     m_currentCollectionFieldNameList = new QStringList;
     getCurrentCollectionId(); //load last used collection id to cache
+
+    m_indexTimer = new QTimer(this);
+    m_indexTimer->setSingleShot(true);
+    m_indexTimer->setInterval(INDEX_IDLE_DELAY_MS);
+    connect(m_indexTimer, SIGNAL(timeout()),
+            this, SLOT(createPendingFieldIndexes()));
 }
 
 MetadataEngine::~MetadataEngine()
@@ -860,6 +1128,50 @@ MetadataEngine::~MetadataEngine()
     delete m_currentCollectionFieldNameList;
 }
 
+bool MetadataEngine::getCollectionInfo(const int collectionId,
+                                       CollectionInfo &info) const
+{
+    QHash<int, CollectionInfo>::const_iterator it =
+            m_collectionHash.constFind(collectionId);
+    if (it != m_collectionHash.constEnd()) {
+        info = it.value();
+        return true;
+    }
+
+    QSqlQuery query(DatabaseManager::getInstance().getDatabase());
+    bool found = false;
+
+    if (!m_collectionHashLoaded) {
+        //load all collections at once, they are few
+        query.exec("SELECT _id,name,table_name,type FROM collections");
+        m_collectionHashLoaded = true;
+    } else {
+        //added after loading
+        query.prepare("SELECT _id,name,table_name,type FROM collections"
+                      " WHERE _id=:id");
+        query.bindValue(":id", collectionId);
+        query.exec();
+    }
+
+    //collections without tables yet are cached too,
+    //createNewCollection() replaces them
+    while (query.next()) {
+        CollectionInfo c;
+        c.name = query.value(1).toString();
+        c.tableName = query.value(2).toString();
+        c.type = query.value(3).toInt();
+
+        int id = query.value(0).toInt();
+        m_collectionHash.insert(id, c);
+        if (id == collectionId) {
+            info = c;
+            found = true;
+        }
+    }
+
+    return found;
+}
+
 QAbstractItemModel* MetadataEngine::createStandardModel(const int collectionId)
 {
     StandardModel *model = new StandardModel(this, 0);
@@ -877,6 +1189,7 @@ QAbstractItemModel* MetadataEngine::createStandardModel(const int collectionId)
 void MetadataEngine::updateFieldNameCache()
 {
     m_currentCollectionFieldNameList->clear();
+    m_fieldKeyHash.remove(m_currentCollectionId);
 
     int columnCount = getFieldCountFromDatabase(m_currentCollectionId);
     for (int i = 0; i < columnCount; i++) {
@@ -895,7 +1208,7 @@ QString MetadataEngine::getFieldNameFromDatabase(const int column,
     QSqlDatabase db = DatabaseManager::getInstance().getDatabase();
     QSqlQuery query(db);
     QString tableName = getTableName(collectionId);
-    QString columnKey = QString("col%1_name").arg(column);
+    QString columnKey = QString("col%1_name").arg(getFieldKey(column, collectionId));
 
     //using sql string because bindValue() fails when using placeholder in table names
     QString sql = QString("SELECT value FROM '%1' WHERE key='%2'")
@@ -936,6 +1249,148 @@ void MetadataEngine::setFieldCount(const int collectionId, int columnCount)
     query.exec();
 }
 
+QList<int> MetadataEngine::fieldKeyList(int collectionId) const
+{
+    QHash<int, QList<int> >::const_iterator it =
+            m_fieldKeyHash.constFind(collectionId);
+    if (it != m_fieldKeyHash.constEnd())
+        return it.value();
+
+    //the column order of the data table is the column order of the model,
+    //column names are the field keys
+    QList<int> fieldKeys;
+    QSqlQuery query(DatabaseManager::getInstance().getDatabase());
+    query.exec(QString("PRAGMA table_info('%1')").arg(getTableName(collectionId)));
+    while (query.next()) {
+        QString name = query.value(1).toString();
+        fieldKeys.append((name == "_id") ? 0 : name.toInt());
+    }
+
+    //don't cache missing tables, they may be created later
+    if (!fieldKeys.isEmpty())
+        m_fieldKeyHash.insert(collectionId, fieldKeys);
+
+    return fieldKeys;
+}
+
+int MetadataEngine::allocateFieldKey(int collectionId)
+{
+    QSqlQuery query(DatabaseManager::getInstance().getDatabase());
+    QString metadataTable = getTableName(collectionId).append("_metadata");
+    int fieldKey = 1; //0 is _id
+
+    query.exec(QString("SELECT value FROM '%1' WHERE key='next_field_id'")
+               .arg(metadataTable));
+
+    //the counter is created with the collection or by the v3 upgrade
+    if (query.next())
+        fieldKey = query.value(0).toInt();
+    query.exec(QString("UPDATE '%1' SET value=%2 WHERE key='next_field_id'")
+               .arg(metadataTable).arg(fieldKey + 1));
+
+    return fieldKey;
+}
+
+QString MetadataEngine::fieldIndexName(const QString &tableName,
+                                       const int fieldKey) const
+{
+    return QString("%1_col%2_index").arg(tableName).arg(fieldKey);
+}
+
+QString MetadataEngine::sortKeyTableName(const QString &tableName,
+                                         const int fieldKey) const
+{
+    return QString("%1_col%2_sort").arg(tableName).arg(fieldKey);
+}
+
+void MetadataEngine::createFieldKeyIndex(const QString &tableName,
+                                         const int fieldKey, bool sortKey)
+{
+    QSqlQuery query(DatabaseManager::getInstance().getDatabase());
+
+    if (sortKey) {
+        query.exec(QString("CREATE INDEX IF NOT EXISTS \"%1\" ON '%2' (\"key\")")
+                   .arg(fieldIndexName(tableName, fieldKey))
+                   .arg(sortKeyTableName(tableName, fieldKey)));
+    } else {
+        query.exec(QString("CREATE INDEX IF NOT EXISTS \"%1\" ON '%2' (\"%3\")")
+                   .arg(fieldIndexName(tableName, fieldKey))
+                   .arg(tableName).arg(fieldKey));
+    }
+}
+
+QString MetadataEngine::databaseChangeStamp() const
+{
+    QSqlQuery query(DatabaseManager::getInstance().getDatabase());
+    QString stamp;
+
+    //rows changed by this connection and commits of other connections
+    if (query.exec("SELECT total_changes()") && query.next())
+        stamp = query.value(0).toString();
+    if (query.exec("PRAGMA data_version") && query.next())
+        stamp.append(":").append(query.value(0).toString());
+
+    return stamp;
+}
+
+void MetadataEngine::rebuildDataTable(const QString &tableName, const int fieldKey)
+{
+    QSqlQuery query(DatabaseManager::getInstance().getDatabase());
+    QString newTableName = tableName + "_new";
+
+    //take column types from the table itself
+    QStringList columnDefinitions;
+    QStringList columnsToKeep;
+    query.exec(QString("PRAGMA table_info('%1')").arg(tableName));
+    while (query.next()) {
+        QString name = query.value(1).toString();
+        QString type = query.value(2).toString();
+
+        if (name == "_id") {
+            columnDefinitions.append("\"_id\" INTEGER PRIMARY KEY");
+            columnsToKeep.append("\"_id\"");
+            continue;
+        }
+
+        if (name.toInt() == fieldKey)
+            continue;
+
+        columnDefinitions.append(QString("\"%1\" %2").arg(name).arg(type));
+        columnsToKeep.append(QString("\"%1\"").arg(name));
+    }
+
+    //copy data only once into the new table, then replace the old one
+    query.exec(QString("CREATE TABLE '%1' (%2)")
+               .arg(newTableName).arg(columnDefinitions.join(",")));
+    query.exec(QString("INSERT INTO '%1' SELECT %2 FROM '%3'")
+               .arg(newTableName).arg(columnsToKeep.join(",")).arg(tableName));
+    query.exec(QString("DROP TABLE '%1'").arg(tableName));
+    query.exec(QString("ALTER TABLE '%1' RENAME TO '%2'")
+               .arg(newTableName).arg(tableName));
+}
+
+void MetadataEngine::restoreFieldIndexes(int collectionId)
+{
+    QSqlQuery query(DatabaseManager::getInstance().getDatabase());
+    QString tableName = getTableName(collectionId);
+    QString metadataTable = tableName + "_metadata";
+
+    QList<int> fieldKeys;
+    query.exec(QString("SELECT key FROM '%1' WHERE key LIKE 'col%_index'")
+               .arg(metadataTable));
+    while (query.next()) {
+        QString key = query.value(0).toString();
+        fieldKeys.append(key.remove(QRegExp("\\D")).toInt()); //extract field key
+    }
+
+    //sort key indexes are on their own table and still exist
+    foreach (int fieldKey, fieldKeys) {
+        createFieldKeyIndex(tableName, fieldKey,
+                            hasSortKey(getFieldColumn(fieldKey, collectionId),
+                                       collectionId));
+    }
+}
+
 QString MetadataEngine::dataTypeSqlName(FieldType type)
 {
     QString s;
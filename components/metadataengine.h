@@ -20,6 +20,7 @@
 #include <QtCore/QObject>
 #include <QtCore/QDateTime>
 #include <QtCore/QHash>
+#include <QtCore/QList>
 
 
 //-----------------------------------------------------------------------------
@@ -27,6 +28,7 @@
 //-----------------------------------------------------------------------------
 
 class QAbstractItemModel;
+class QTimer;
 
 
 //-----------------------------------------------------------------------------
@@ -73,6 +75,13 @@ public:
                             condition is met */
     };
 
+    /** This enum holds the kind of field accesses tracked for indexing */
+    enum FieldUsage {
+        SortUsage,  /**< The collection has been sorted by the field */
+        FilterUsage /**< The field has been used in a filter which can make
+                         use of an index (equality, range or prefix match) */
+    };
+
     static MetadataEngine& getInstance();
     static void destroy();
 
@@ -94,6 +103,9 @@ public:
     /** Get the table name for the specified collection id */
     QString getTableName(const int collectionId) const;
 
+    /** Get the collection type of the specified collection id */
+    CollectionType getCollectionType(const int collectionId) const;
+
     /**
      * Get current field name (column name) for the specified column
      * and collection. If the collectionId is not specified the current
@@ -119,6 +131,26 @@ public:
     /** Get the column/field count (including _id) of the specified colledtion id */
     int getFieldCount(int collectionId = m_currentCollectionId) const;
 
+    /**
+     * Get the permanent key of the field at the specified column.
+     * The field key names the data table column and the metadata keys,
+     * it never changes and is never reused within a collection.
+     * The column is only the display ordinal of the field among the
+     * existing ones, it shifts when a field before it is deleted.
+     * @param column - the column/section number
+     * @param collectionId - the collection id, if not specified active one is used
+     * @return the field key, 0 for _id or -1 if the column is not valid
+     */
+    int getFieldKey(const int column,
+                    int collectionId = m_currentCollectionId) const;
+
+    /**
+     * Get the current column of the field with the specified field key
+     * @return the column or -1 if the field doesn't exist (anymore)
+     */
+    int getFieldColumn(const int fieldKey,
+                       int collectionId = m_currentCollectionId) const;
+
     /**
      * Get the field type of a column (field)
      * @param column - the column number
@@ -240,7 +272,7 @@ public:
      * @param editProperties - the metadata string for edit properties
      * @param triggerProperties - the metadata string for trigger properties
      * @param collectionId - the collection id, if not specified default is used
-     * @return int - the id of the newly created field
+     * @return int - the column of the newly created field, which is the last one
      */
     int createField(const QString &fieldName, FieldType type,
                     const QString &displayProperties,
@@ -250,22 +282,85 @@ public:
 
     /**
      * Modify a field
-     * @param fieldId - the id of the field which is being edited
+     * @param column - the column of the field which is being edited
      * @param fieldName - the new name for the field
      * @param displayProperties - the metadata string for display properties
      * @param editProperties - the metadata string for edit properties
      * @param triggerProperties - the metadata string for trigger properties
      * @param collectionId - the collection id, if not specified default is used
      */
-    void modifyField(const int &fieldId,
+    void modifyField(const int &column,
                      const QString &fieldName,
                      const QString &displayProperties,
                      const QString &editProperties,
                      const QString &triggerProperties,
                      int collectionId = m_currentCollectionId);
 
-    /** Delete the specified field from collection and update metadata */
-    void deleteField(const int fieldId, int collectionId = m_currentCollectionId);
+    /**
+     * Delete the field at the specified column from collection and update
+     * metadata. The following fields move one column back, but keep their
+     * field keys, so no other column or metadata key is rewritten.
+     */
+    void deleteField(const int column, int collectionId = m_currentCollectionId);
+
+    /**
+     * Register a sort or filter access to a field. Once a field
+     * has been used often enough, an index is created for it,
+     * so later sort and filter operations don't need a full table scan.
+     * The index is created when no field has been used for a while,
+     * not during the access that reached the threshold.
+     * See createPendingFieldIndexes()
+     * @param column - the field number
+     * @param usage - the kind of access
+     * @param collectionId - if not specified, current collection is used
+     */
+    void registerFieldUsage(const int column, FieldUsage usage,
+                            int collectionId = m_currentCollectionId);
+
+    /** Whether the specified field has an index */
+    bool hasFieldIndex(const int column,
+                       int collectionId = m_currentCollectionId) const;
+
+    /** Create an index for the specified field, if not already present */
+    void createFieldIndex(const int column,
+                          int collectionId = m_currentCollectionId);
+
+    /** Drop the index of the specified field, if any */
+    void dropFieldIndex(const int column,
+                        int collectionId = m_currentCollectionId);
+
+    /**
+     * Whether the specified field is sorted by a sort key instead of
+     * its value. This is the case for all text fields, see createSortKey()
+     */
+    bool hasSortKey(const int column,
+                    int collectionId = m_currentCollectionId) const;
+
+    /**
+     * Get the name of the table holding the sort keys of the specified
+     * field. The table has a "record_id" and a "key" column, and the
+     * "source" column with the text the key was created from
+     */
+    QString getSortKeyTableName(const int column,
+                                int collectionId = m_currentCollectionId) const;
+
+    /**
+     * Create the sort keys of the specified field for records that are
+     * new or changed since the last update, and remove the keys of
+     * deleted records. The sort key table is created if needed.
+     */
+    void updateSortKeys(const int column,
+                        int collectionId = m_currentCollectionId);
+
+    /**
+     * Get the sort key of the specified text. Sort keys compare with the
+     * BINARY collation of SQLite like the text with a case insensitive
+     * German collator in numeric mode: case is folded, accents and umlauts
+     * are removed, ß is expanded and digit sequences compare by value.
+     * Unlike a collation, keys can be indexed and the database stays
+     * usable by connections that don't know how they are created.
+     */
+    static QString createSortKey(const QString &text);
 
     /**
      * Add file metadata to the database.
@@ -322,6 +417,19 @@ public:
      */
     void setDirtyCurrentColleectionId();
 
+    /**
+     * Set cached collection info (name, table name and type)
+     * of the specified collection dirty, or of all collections
+     * if collectionId is 0. This is used after the collections table
+     * has been modified outside of MetadataEngine, like collection
+     * renames in CollectionListModel
+     */
+    void setDirtyCollectionCache(int collectionId = 0);
+
+public slots:
+    /** Create the indexes queued by registerFieldUsage() */
+    void createPendingFieldIndexes();
+
 signals:
     /**
      * This signal is emitted whenever the currently active collection
@@ -338,6 +446,22 @@ private:
     MetadataEngine(const MetadataEngine&) : QObject(0) {}
     ~MetadataEngine();
 
+    /** Cached info of a collection, from the collections table */
+    struct CollectionInfo {
+        QString name;
+        QString tableName;
+        int type;
+    };
+
+    /**
+     * Get the cached info of the specified collection.
+     * All collections are loaded on first use, ids not in the cache
+     * are queried again because new collections are added to the
+     * collections table outside of MetadataEngine
+     * @return false if the collection doesn't exist
+     */
+    bool getCollectionInfo(const int collectionId, CollectionInfo &info) const;
+
     /**
      * Helper function used by createModel() to build a standard model,
      * if collectionId is != 0, then the model will be initialized with
@@ -362,6 +486,50 @@ private:
     /** Set the column/field count of the specified collection id */
     void setFieldCount(const int collectionId, int columnCount);
 
+    /**
+     * Get the field keys of the specified collection ordered by column,
+     * read from the data table column names and cached
+     */
+    QList<int> fieldKeyList(int collectionId) const;
+
+    /**
+     * Reserve the next field key of the specified collection,
+     * keys of deleted fields are not reused
+     */
+    int allocateFieldKey(int collectionId);
+
+    /** Get the index name for the specified field key */
+    QString fieldIndexName(const QString &tableName, const int fieldKey) const;
+
+    /** Get the sort key table name for the specified field key */
+    QString sortKeyTableName(const QString &tableName, const int fieldKey) const;
+
+    /**
+     * Create the index of the specified field key. Fields with a sort key
+     * are indexed by their sort key table instead of the data table.
+     */
+    void createFieldKeyIndex(const QString &tableName, const int fieldKey,
+                             bool sortKey);
+
+    /**
+     * Get a stamp that changes whenever rows are written to the database,
+     * by this or by other connections
+     */
+    QString databaseChangeStamp() const;
+
+    /**
+     * Rebuild the data table without the specified field key column
+     * by copying it once into a new table.
+     * This is used when SQLite has no DROP COLUMN support.
+     */
+    void rebuildDataTable(const QString &tableName, const int fieldKey);
+
+    /**
+     * Create the indexes of all fields marked as indexed in metadata,
+     * this is used after the data table has been altered
+     */
+    void restoreFieldIndexes(int collectionId);
+
     /** Get the SQL column data type name for the specified field type */
     QString dataTypeSqlName(FieldType type);
 
@@ -370,6 +538,19 @@ private:
     static QStringList *m_currentCollectionFieldNameList; /**< cached list of field
                                                         names for the active
                                                         collection */
+    QHash<int, QHash<int,int> > m_fieldUsageHash; /**< usage counts by field key
+                                                       and collection id */
+    QHash<int, QList<int> > m_pendingIndexHash; /**< field keys waiting for an
+                                                     index, by collection id */
+    QTimer *m_indexTimer; /**< Delays index creation until fields are idle */
+    mutable QHash<int, QList<int> > m_fieldKeyHash; /**< cached field keys ordered
+                                                         by column, by collection id */
+    QHash<QString, QString> m_sortKeyStampHash; /**< database change stamp of the
+                                                     last sort key update, by
+                                                     sort key table */
+    mutable QHash<int, CollectionInfo> m_collectionHash; /**< cached collections
+                                                              by collection id */
+    mutable bool m_collectionHashLoaded; /**< whether all collections are cached */
 };
 
 #endif // METADATAENGINE_H
@@ -0,0 +1,590 @@
+/*
+ *  Copyright (c) 2017 Giorgio Wicklein <giowckln@gmail.com>
+ */
+
+//-----------------------------------------------------------------------------
+// Hearders
+//-----------------------------------------------------------------------------
+
+#include "printengine.h"
+#include "databasemanager.h"
+#include "filemanager.h"
+#include "../utils/metadatapropertiesparser.h"
+
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlQuery>
+#include <QtGui/QPagedPaintDevice>
+#include <QtGui/QPainter>
+#include <QtGui/QPdfWriter>
+#include <QtGui/QTextDocument>
+#include <QtGui/QAbstractTextDocumentLayout>
+#include <QtGui/QImageReader>
+#include <QtGui/QPageLayout>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QThread>
+#include <QtCore/QDateTime>
+#include <QtCore/QLocale>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QJsonValue>
+#include <QtCore/QFile>
+
+
+//-----------------------------------------------------------------------------
+// Public
+//-----------------------------------------------------------------------------
+
+PrintEngine::PrintEngine(const int collectionId, const QList<int> &recordIdList,
+                         bool allRecords, QObject *parent) :
+    QObject(parent),
+    m_recordList(recordIdList),
+    m_allRecords(allRecords),
+    m_layoutDevice(1, 1, QImage::Format_ARGB32),
+    m_cancelled(0)
+{
+    //dots per meter for LAYOUT_DPI
+    int dotsPerMeter = qRound(LAYOUT_DPI / 0.0254);
+    m_layoutDevice.setDotsPerMeterX(dotsPerMeter);
+    m_layoutDevice.setDotsPerMeterY(dotsPerMeter);
+
+    MetadataEngine *me = &MetadataEngine::getInstance();
+    FileManager fm;
+
+    m_tableName = me->getTableName(collectionId);
+    m_databasePath = DatabaseManager::getInstance().getDatabasePath();
+    m_filesDir = fm.getFilesDirectory();
+    m_imageMetaJsonPath = fm.getPlantImageMetaJsonFilePath();
+
+    //cache field metadata, MetadataEngine is not thread safe
+    int fieldCount = me->getFieldCount(collectionId);
+    for (int i = 1; i < fieldCount; i++) { // 1 because of _id
+        FieldInfo field;
+        field.column = i;
+        field.name = me->getFieldName(i, collectionId);
+        field.type = me->getFieldType(i, collectionId);
+        field.displayProperties = me->getFieldProperties(
+                    MetadataEngine::DisplayProperty, i, collectionId);
+        m_fields.append(field);
+    }
+}
+
+PrintEngine::~PrintEngine()
+{
+}
+
+void PrintEngine::setHeaderHtml(const QString &html)
+{
+    m_headerHtml = html;
+}
+
+void PrintEngine::setPdfOutputPath(const QString &path)
+{
+    m_pdfOutputPath = path;
+}
+
+bool PrintEngine::render(QPagedPaintDevice *device)
+{
+    m_printedPlantImages.clear();
+    bool success = true;
+
+    //use a private connection, so this works from any thread
+    QString connectionName = QString("printEngine_%1")
+            .arg((quintptr) this);
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+        db.setDatabaseName(m_databasePath);
+        if (!db.open()) {
+            success = false;
+        } else {
+            QSqlQuery query(db);
+            QSqlQuery fileQuery(db);
+            int total = 0;
+
+            fileQuery.prepare("SELECT hash_name FROM files WHERE _id=:fileId");
+
+            if (m_allRecords) {
+                query.exec(QString("SELECT COUNT(*) FROM %1").arg(m_tableName));
+                if (query.next())
+                    total = query.value(0).toInt();
+                query.finish();
+                query.setForwardOnly(true);
+                query.exec(QString("SELECT * FROM %1").arg(m_tableName));
+            } else {
+                QString recordListString;
+                foreach (int id, m_recordList) {
+                    recordListString.append(QString::number(id) + ",");
+                }
+                //remove last ','
+                recordListString.remove(recordListString.size()-1, 1);
+                total = m_recordList.size();
+                query.setForwardOnly(true);
+                query.exec(QString("SELECT * FROM %1 WHERE _id IN (%2)")
+                           .arg(m_tableName).arg(recordListString));
+            }
+
+            QPainter painter;
+            if (!painter.begin(device)) {
+                success = false;
+            } else {
+                //lay out at a fixed resolution and scale to the device
+                qreal scaleX = device->logicalDpiX() / (qreal) LAYOUT_DPI;
+                qreal scaleY = device->logicalDpiY() / (qreal) LAYOUT_DPI;
+                painter.scale(scaleX, scaleY);
+                m_pageSize = QSizeF(device->width() / scaleX,
+                                    device->height() / scaleY);
+                qreal y = 0;
+                int done = 0;
+
+                //header
+                QTextDocument headerDoc;
+                initDocument(headerDoc, m_headerHtml + "</body></html>");
+                drawDocument(headerDoc, painter, device, y);
+
+                //records are laid out one at a time
+                while (query.next()) {
+                    QTextDocument recordDoc;
+                    initDocument(recordDoc, recordHtml(query, fileQuery));
+                    drawDocument(recordDoc, painter, device, y);
+
+                    emit progressSignal(++done, total);
+                    if (isCancelled()) {
+                        success = false;
+                        break;
+                    }
+                }
+
+                //image licensing
+                if (success && !m_printedPlantImages.isEmpty()) {
+                    QTextDocument licenseDoc;
+                    initDocument(licenseDoc, generateImgLicensingInfo());
+                    drawDocument(licenseDoc, painter, device, y);
+                }
+
+                painter.end();
+            }
+        }
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+
+    return success;
+}
+
+void PrintEngine::cancel()
+{
+    m_cancelled.fetchAndStoreOrdered(1);
+}
+
+bool PrintEngine::isCancelled() const
+{
+    return m_cancelled.load();
+}
+
+
+//-----------------------------------------------------------------------------
+// Public slots
+//-----------------------------------------------------------------------------
+
+void PrintEngine::renderPdf()
+{
+    bool success;
+    {
+        QPdfWriter writer(m_pdfOutputPath);
+        writer.setPageMargins(QMarginsF(15, 15, 15, 15), QPageLayout::Millimeter);
+        writer.setCreator(QCoreApplication::applicationName());
+        success = render(&writer);
+    }
+
+    //hand back to the main thread, so the owner can safely delete us
+    moveToThread(QCoreApplication::instance()->thread());
+    emit finishedSignal(success);
+}
+
+
+//-----------------------------------------------------------------------------
+// Private
+//-----------------------------------------------------------------------------
+
+void PrintEngine::initDocument(QTextDocument &doc, const QString &html)
+{
+    //reuse the style sheet from the header for all documents
+    int bodyIndex = m_headerHtml.indexOf("<body>");
+    QString head = (bodyIndex != -1) ?
+                m_headerHtml.left(bodyIndex + 6) : QString("<html><body>");
+
+    doc.documentLayout()->setPaintDevice(&m_layoutDevice);
+    doc.setPageSize(QSizeF(m_pageSize.width(), -1)); // -1 for unlimited height
+    doc.setHtml(html.startsWith("<html>") ? html :
+                                            head + html + "</body></html>");
+}
+
+void PrintEngine::drawDocument(QTextDocument &doc, QPainter &painter,
+                               QPagedPaintDevice *device, qreal &y)
+{
+    qreal pageHeight = m_pageSize.height();
+    qreal docHeight = doc.size().height();
+
+    //start a new page if the document doesn't fit the remaining space
+    if ((y > 0) && (y + docHeight > pageHeight)) {
+        device->newPage();
+        y = 0;
+    }
+
+    if (docHeight <= pageHeight) {
+        painter.save();
+        painter.translate(0, y);
+        doc.drawContents(&painter);
+        painter.restore();
+        y += docHeight;
+    } else {
+        //document taller than a page, draw it slice by slice
+        qreal offset = 0;
+        while (offset < docHeight) {
+            if (offset > 0) {
+                device->newPage();
+            }
+            QRectF clip(0, offset, m_pageSize.width(), pageHeight);
+            painter.save();
+            painter.translate(0, -offset);
+            doc.drawContents(&painter, clip);
+            painter.restore();
+            offset += pageHeight;
+        }
+        y = docHeight - (offset - pageHeight);
+    }
+}
+
+QString PrintEngine::recordHtml(const QSqlQuery &recordQuery,
+                                QSqlQuery &fileQuery)
+{
+    QString html;
+    html.append("<table>");
+
+    foreach (const FieldInfo &field, m_fields) {
+        QVariant data = recordQuery.value(field.column);
+
+        html.append("<tr>");
+        html.append(QString("<td>%1:</td>").arg(field.name));
+        html.append("<td>");
+
+        switch (field.type) {
+        case MetadataEngine::TextType:
+        case MetadataEngine::URLTextType:
+        case MetadataEngine::EmailTextType:
+            html.append(textTypeItemHtml(data, field));
+            break;
+        case MetadataEngine::NumericType:
+            html.append(numericTypeItemHtml(data, field));
+            break;
+        case MetadataEngine::CreationDateType:
+        case MetadataEngine::ModDateType:
+        case MetadataEngine::DateType:
+            html.append(dateTypeItemHtml(data, field));
+            break;
+        case MetadataEngine::CheckboxType:
+            html.append(checkboxTypeItemHtml(data, field));
+            break;
+        case MetadataEngine::ComboboxType:
+            html.append(comboboxTypeItemHtml(data, field));
+            break;
+        case MetadataEngine::ProgressType:
+            html.append(progressTypeItemHtml(data, field));
+            break;
+        case MetadataEngine::ImageType:
+            html.append(imageTypeItemHtml(data, fileQuery));
+            break;
+        case MetadataEngine::FilesType:
+            html.append(filesTypeItemHtml(data, field));
+            break;
+        default:
+            html.append(textTypeItemHtml(data, field));
+            break;
+        }
+
+        html.append("</td>");
+        html.append("</tr>");
+    }
+
+    html.append("</table><br /><hr />");
+
+    return html;
+}
+
+QString PrintEngine::textTypeItemHtml(const QVariant &data,
+                                      const FieldInfo &field)
+{
+    Q_UNUSED(field);
+
+    return data.toString();
+}
+
+QString PrintEngine::numericTypeItemHtml(const QVariant &data,
+                                         const FieldInfo &field)
+{
+    QString html;
+    html.append("<span style=\"");
+
+    QString dataString;
+    bool empty = data.toString().isEmpty();
+
+    //adapt to display properties
+    MetadataPropertiesParser parser(field.displayProperties);
+    QString v;
+
+    v = parser.getValue("markNegative");
+    if ((v == "1") && (data.toDouble() < 0.0)) {
+        html.append("color:red;");
+    }
+
+    int precision;
+    v = parser.getValue("precision");
+    precision = v.toInt();
+
+    v = parser.getValue("displayMode");
+    if (v == "auto") {
+        if (!empty)
+            dataString = data.toString();
+    } else if (v == "decimal") {
+        if (!empty)
+            dataString = QString::number(data.toDouble(), 'f', precision);
+    } else if (v == "scientific") {
+        if (!empty)
+            dataString = QString::number(data.toDouble(), 'e', precision);
+    } else {
+        if (!empty)
+            dataString = data.toString(); //if display mode not specified
+    }
+
+    //make use of the correct decimal point char
+    QLocale locale;
+    dataString.replace(".", locale.decimalPoint());
+
+    html.append("\">");
+    html.append(dataString);
+    html.append("</span>");
+
+    return html;
+}
+
+QString PrintEngine::dateTypeItemHtml(const QVariant &data,
+                                      const FieldInfo &field)
+{
+    QLocale locale;
+    QString dateFormat = locale.dateTimeFormat(QLocale::ShortFormat);
+
+    //adapt to display properties
+    MetadataPropertiesParser parser(field.displayProperties);
+    if (field.displayProperties.size() > 0) {
+        QString v;
+
+        v = parser.getValue("dateFormat");
+        if (v == "1")
+            dateFormat = locale.dateTimeFormat(QLocale::ShortFormat);
+        else if (v == "2")
+            dateFormat = locale.dateFormat(QLocale::ShortFormat);
+        else if (v == "3")
+            dateFormat = "ddd MMM d hh:mm yyyy";
+        else if (v == "4")
+            dateFormat = "ddd MMM d yyyy";
+        else if (v == "5")
+            dateFormat = "yyyy-MM-dd hh:mm";
+        else if (v == "6")
+            dateFormat = "yyyy-MM-dd";
+    }
+
+    return data.toDateTime().toString(dateFormat);
+}
+
+QString PrintEngine::checkboxTypeItemHtml(const QVariant &data,
+                                          const FieldInfo &field)
+{
+    Q_UNUSED(field);
+
+    QString html;
+    bool checked = data.toInt();
+
+    if(checked)
+        html.append(QCoreApplication::translate("PrintDialog", "Yes"));
+    else
+        html.append(QCoreApplication::translate("PrintDialog", "No"));
+
+    return html;
+}
+
+QString PrintEngine::comboboxTypeItemHtml(const QVariant &data,
+                                          const FieldInfo &field)
+{
+    bool ok;
+    int itemId = data.toInt(&ok);
+    if (!ok) itemId = -1;
+    QString itemString;
+
+    //adapt to display properties
+    MetadataPropertiesParser parser(field.displayProperties);
+    if (field.displayProperties.size() > 0) {
+        QString v;
+
+        //load items from display properties
+        QStringList items = parser.getValue("items")
+                .split(',', QString::SkipEmptyParts);
+
+        //handle default
+        v = parser.getValue("default");
+        if ((!v.isEmpty()) && (itemId == -1)) {
+            bool ok;
+            itemId = v.toInt(&ok);
+            if (!ok) itemId = -1;
+        }
+
+        if ((itemId != -1) && (itemId < items.size()))
+            itemString = items.at(itemId);
+
+        //replace some escape codes
+        itemString.replace("\\comma", ",");
+        itemString.replace("\\colon", ":");
+        itemString.replace("\\semicolon", ";");
+        itemString.replace("\\doublequote", "\"");
+        itemString.replace("\\singlequote", "'");
+    }
+
+    return itemString;
+}
+
+QString PrintEngine::progressTypeItemHtml(const QVariant &data,
+                                          const FieldInfo &field)
+{
+    QString html;
+
+    int max = 100;
+    int value = data.toInt();
+
+    //display properties
+    MetadataPropertiesParser parser(field.displayProperties);
+    if (field.displayProperties.size() > 0) {
+        max = parser.getValue("max").toInt();
+    }
+
+    //calc percentage
+    int percentage = (((double) value) / max) * 100.0;
+    html.append(QString::number(percentage) + "%");
+
+    return html;
+}
+
+QString PrintEngine::imageTypeItemHtml(const QVariant &data,
+                                       QSqlQuery &fileQuery)
+{
+    QString html;
+    int fileId = data.toInt();
+    if (fileId) {
+        QString fileHash;
+
+        fileQuery.bindValue(":fileId", fileId);
+        fileQuery.exec();
+        if (fileQuery.next())
+            fileHash = fileQuery.value(0).toString();
+        fileQuery.finish();
+
+        QString filePath = m_filesDir + fileHash;
+
+        //calc size, only the image header is read
+        QSize imageSize = QImageReader(filePath).size();
+        QSize newSize(256, 256);
+        if (imageSize.isValid()) {
+            if ((newSize.width() > imageSize.width()) &&
+                    (newSize.height() > imageSize.height())) {
+                newSize = imageSize;
+            } else {
+                newSize = imageSize.scaled(newSize, Qt::KeepAspectRatio);
+            }
+        }
+
+        html.append(QString("<img border=\"0\" src=\"%1\" width=\"%2\" height=\"%3\">")
+                    .arg(filePath).arg(newSize.width()).arg(newSize.height()));
+
+        //save image hash for later licensing info
+        m_printedPlantImages.insert(fileHash);
+    }
+
+    return html;
+}
+
+QString PrintEngine::filesTypeItemHtml(const QVariant &data,
+                                       const FieldInfo &field)
+{
+    Q_UNUSED(field);
+
+    QString dataString = data.toString();
+
+    int fileCount = dataString.split(',', QString::SkipEmptyParts).size();
+    //BUG workaround: plurals don't work (see PrintDialog)
+    QString countString = (fileCount == 1 )?
+                QCoreApplication::translate("PrintDialog", "%1 file").arg(fileCount) :
+                QCoreApplication::translate("PrintDialog", "%1 files").arg(fileCount);
+
+    return countString;
+}
+
+QString PrintEngine::generateImgLicensingInfo()
+{
+    QString html = "";
+
+    if (!m_printedPlantImages.isEmpty()) {
+
+        //init html
+        html.append(QCoreApplication::translate(
+                        "PrintDialog",
+                        "<p class=\"header\">The contained images are under the following "
+                        "licensing conditions: <br />"));
+
+        //parse json file
+        QFile jsonFile(m_imageMetaJsonPath);
+        bool error = false;
+        QString errorMessage = "";
+        QJsonDocument jsonDoc;
+
+        if (!jsonFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            error = true;
+            errorMessage.append(QCoreApplication::translate(
+                                    "PrintDialog",
+                                    "Filed to open image metadata json file. "));
+        } else {
+            QString raw = jsonFile.readAll();
+            jsonDoc = QJsonDocument::fromJson(raw.toUtf8());
+            jsonFile.close();
+            if (jsonDoc.isNull()) {
+                error = true;
+                errorMessage.append(QCoreApplication::translate(
+                                        "PrintDialog", "Invalid json format. "));
+            }
+        }
+        if (error) {
+            return errorMessage;
+        }
+
+        QJsonObject jsonObject = jsonDoc.object();
+        QJsonArray jsonArray = jsonObject["plant"].toArray();
+
+        foreach (const QJsonValue &value, jsonArray) {
+            QJsonObject obj = value.toObject();
+            QString fileName = obj["database file name"].toString();
+
+            if (m_printedPlantImages.contains(fileName)) {
+                QString plantName = obj["name"].toString();
+                QString licenseHtml = obj["license html"].toString();
+                html.append("<br /><b>" + plantName + "</b><br />");
+                html.append(licenseHtml);
+                html.append("<br />" + fileName + "<br />");
+            }
+
+            if (isCancelled())
+                break;
+        }
+
+        //html outro
+        html.append("</p>");
+    }
+
+    return html;
+}
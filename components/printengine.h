@@ -0,0 +1,139 @@
+/**
+  * \class PrintEngine
+  * \brief This class renders records of a collection page by page to
+  *        a printer or PDF file. Records are streamed from the database
+  *        and laid out one at a time, so memory does not grow with the
+  *        record count. All metadata is collected on construction, so
+  *        rendering can run in a worker thread with its own database
+  *        connection (see renderPdf()).
+  * \author Giorgio Wicklein - GIOWISYS Software
+  * \date 19/10/2026
+  */
+
+#ifndef PRINTENGINE_H
+#define PRINTENGINE_H
+
+
+//-----------------------------------------------------------------------------
+// Headers
+//-----------------------------------------------------------------------------
+
+#include "metadataengine.h"
+
+#include <QtCore/QObject>
+#include <QtCore/QAtomicInt>
+#include <QtCore/QSet>
+#include <QtCore/QStringList>
+#include <QtCore/QSizeF>
+#include <QtGui/QImage>
+
+
+//-----------------------------------------------------------------------------
+// Forward declarations
+//-----------------------------------------------------------------------------
+
+class QPagedPaintDevice;
+class QPainter;
+class QTextDocument;
+class QSqlQuery;
+
+
+//-----------------------------------------------------------------------------
+// PrintEngine
+//-----------------------------------------------------------------------------
+
+class PrintEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructor, must be called from the GUI thread
+     * @param collectionId - the collection to print
+     * @param recordIdList - list of record ids to print
+     * @param allRecords - if true, recordIdList is ignored and all records are printed
+     * @param parent - parent object
+     */
+    PrintEngine(const int collectionId, const QList<int> &recordIdList,
+                bool allRecords, QObject *parent = 0);
+    ~PrintEngine();
+
+    /**
+     * Set the html printed on top of the first page, the html head
+     * (style sheet) up to <body> is reused for all records
+     */
+    void setHeaderHtml(const QString &html);
+
+    /** Set the output file used by renderPdf() */
+    void setPdfOutputPath(const QString &path);
+
+    /**
+     * Render all records to the specified device, page by page.
+     * A new page is started when a record doesn't fit the rest of a page.
+     * @param device - printer or pdf writer, painting must not be active
+     * @return false on error or if cancelled
+     */
+    bool render(QPagedPaintDevice *device);
+
+    /** Cancel rendering, can be called from any thread */
+    void cancel();
+
+    /** Whether rendering was cancelled */
+    bool isCancelled() const;
+
+public slots:
+    /**
+     * Render to the pdf file set with setPdfOutputPath(), this is meant to
+     * be started from a worker thread. Once done, the object is moved
+     * back to the main thread and finishedSignal() is emitted.
+     */
+    void renderPdf();
+
+signals:
+    /** Rendering progress, done out of total records */
+    void progressSignal(int done, int total);
+
+    /** Emitted by renderPdf() when completed */
+    void finishedSignal(bool success);
+
+private:
+    static const int LAYOUT_DPI = 96;
+
+    /** Field metadata, cached to avoid metadata queries while rendering */
+    struct FieldInfo {
+        int column;
+        QString name;
+        MetadataEngine::FieldType type;
+        QString displayProperties;
+    };
+
+    void initDocument(QTextDocument &doc, const QString &html);
+    void drawDocument(QTextDocument &doc, QPainter &painter,
+                      QPagedPaintDevice *device, qreal &y);
+    QString recordHtml(const QSqlQuery &recordQuery, QSqlQuery &fileQuery);
+    QString textTypeItemHtml(const QVariant &data, const FieldInfo &field);
+    QString numericTypeItemHtml(const QVariant &data, const FieldInfo &field);
+    QString dateTypeItemHtml(const QVariant &data, const FieldInfo &field);
+    QString checkboxTypeItemHtml(const QVariant &data, const FieldInfo &field);
+    QString comboboxTypeItemHtml(const QVariant &data, const FieldInfo &field);
+    QString progressTypeItemHtml(const QVariant &data, const FieldInfo &field);
+    QString imageTypeItemHtml(const QVariant &data, QSqlQuery &fileQuery);
+    QString filesTypeItemHtml(const QVariant &data, const FieldInfo &field);
+    QString generateImgLicensingInfo();
+
+    QList<int> m_recordList; /**< List of record ids to print */
+    bool m_allRecords;
+    QString m_tableName;
+    QString m_databasePath;
+    QString m_filesDir;
+    QString m_imageMetaJsonPath;
+    QString m_headerHtml;
+    QString m_pdfOutputPath;
+    QList<FieldInfo> m_fields;
+    QSet<QString> m_printedPlantImages;
+    QImage m_layoutDevice; /**< Fixed resolution device for text layout */
+    QSizeF m_pageSize; /**< Page size in layout units */
+    QAtomicInt m_cancelled;
+};
+
+#endif // PRINTENGINE_H
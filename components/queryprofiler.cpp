@@ -0,0 +1,273 @@
+/*
+ *  Copyright (c) 2017 Giorgio Wicklein <giowckln@gmail.com>
+ */
+
+//-----------------------------------------------------------------------------
+// Hearders
+//-----------------------------------------------------------------------------
+
+#include "queryprofiler.h"
+
+#include <QtSql/QSqlDatabase>
+#include <QtCore/QFile>
+#include <QtCore/QDateTime>
+#include <QtCore/QTextStream>
+#include <QtCore/QList>
+#include <QtCore/QPair>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QVariant>
+
+#ifdef PASSIFLORA_SQL_TRACE
+#include <QtSql/QSqlDriver>
+#include <sqlite3.h>
+#endif
+
+
+//-----------------------------------------------------------------------------
+// Static init
+//-----------------------------------------------------------------------------
+
+/** Upper bounds of the histogram buckets in ns, the last one is open */
+static const qint64 BUCKET_LIMITS[QueryProfiler::BucketCount - 1] = {
+    100000LL, 1000000LL, 10000000LL, 100000000LL
+};
+
+
+//-----------------------------------------------------------------------------
+// Public
+//-----------------------------------------------------------------------------
+
+QueryProfiler::Entry::Entry() :
+    count(0), totalNs(0), maxNs(0)
+{
+    for (int i = 0; i < BucketCount; i++)
+        histogram[i] = 0;
+}
+
+QueryProfiler::QueryProfiler() :
+    m_handle(0),
+    m_statementCount(0),
+    m_slowQueryThresholdNs(0)
+{
+}
+
+QueryProfiler::~QueryProfiler()
+{
+    uninstall();
+}
+
+bool QueryProfiler::install(QSqlDatabase &database)
+{
+#ifdef PASSIFLORA_SQL_TRACE
+    uninstall();
+
+    QVariant handle = database.driver()->handle();
+    if (!handle.isValid() || (qstrcmp(handle.typeName(), "sqlite3*") != 0))
+        return false;
+
+    sqlite3 *sqliteHandle = *static_cast<sqlite3**>(handle.data());
+    if (!sqliteHandle)
+        return false;
+
+    if (sqlite3_trace_v2(sqliteHandle, SQLITE_TRACE_PROFILE,
+                         profileCallback, this) != SQLITE_OK)
+        return false;
+
+    m_handle = sqliteHandle;
+    return true;
+#else
+    Q_UNUSED(database);
+    return false;
+#endif
+}
+
+void QueryProfiler::uninstall()
+{
+#ifdef PASSIFLORA_SQL_TRACE
+    if (m_handle)
+        sqlite3_trace_v2(static_cast<sqlite3*>(m_handle), 0, 0, 0);
+#endif
+    m_handle = 0;
+}
+
+bool QueryProfiler::isInstalled() const
+{
+    return m_handle != 0;
+}
+
+void QueryProfiler::setSlowQueryLog(const QString &filePath, int thresholdMs)
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_slowQueryLogPath = filePath;
+    m_slowQueryThresholdNs = qint64(thresholdMs) * 1000000LL;
+}
+
+qint64 QueryProfiler::statementCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_statementCount;
+}
+
+QHash<QString, QueryProfiler::Entry> QueryProfiler::entries() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_entries;
+}
+
+void QueryProfiler::reset()
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_entries.clear();
+    m_statementCount = 0;
+}
+
+QString QueryProfiler::report() const
+{
+    QHash<QString, Entry> entries = this->entries();
+
+    //sort by total time, descending
+    QList<QPair<qint64, QString> > order;
+    QHash<QString, Entry>::const_iterator it;
+    for (it = entries.constBegin(); it != entries.constEnd(); ++it)
+        order.append(qMakePair(-it.value().totalNs, it.key()));
+    qSort(order);
+
+    QString s;
+    QTextStream out(&s);
+    out << "count\ttotal ms\tavg ms\tmax ms\t"
+           "<0.1ms\t<1ms\t<10ms\t<100ms\t>=100ms\tsql\n";
+    for (int i = 0; i < order.size(); i++) {
+        const Entry &e = entries[order.at(i).second];
+        out << e.count << "\t"
+            << QString::number(e.totalNs / 1e6, 'f', 3) << "\t"
+            << QString::number((e.totalNs / 1e6) / e.count, 'f', 3) << "\t"
+            << QString::number(e.maxNs / 1e6, 'f', 3);
+        for (int b = 0; b < BucketCount; b++)
+            out << "\t" << e.histogram[b];
+        out << "\t" << order.at(i).second << "\n";
+    }
+
+    return s;
+}
+
+QString QueryProfiler::normalizeSql(const QString &sql)
+{
+    QString s;
+    s.reserve(sql.size());
+
+    int i = 0;
+    int size = sql.size();
+    while (i < size) {
+        QChar c = sql.at(i);
+
+        if (c == '\'') {
+            //string literal, '' is an escaped quote
+            i++;
+            while (i < size) {
+                if (sql.at(i) == '\'') {
+                    if (((i + 1) < size) && (sql.at(i + 1) == '\'')) {
+                        i += 2;
+                        continue;
+                    }
+                    break;
+                }
+                i++;
+            }
+            i++;
+            s.append('?');
+        } else if (c == '"') {
+            //quoted identifier, keep it
+            int end = sql.indexOf('"', i + 1);
+            if (end == -1)
+                end = size - 1;
+            s.append(sql.midRef(i, end - i + 1));
+            i = end + 1;
+        } else if (c.isDigit() && (s.isEmpty() ||
+                                   !(s.at(s.size() - 1).isLetterOrNumber() ||
+                                     (s.at(s.size() - 1) == '_')))) {
+            //number literal
+            while ((i < size) && (sql.at(i).isDigit() || (sql.at(i) == '.')))
+                i++;
+            s.append('?');
+        } else {
+            s.append(c);
+            i++;
+        }
+    }
+
+    return s.simplified();
+}
+
+
+//-----------------------------------------------------------------------------
+// Private
+//-----------------------------------------------------------------------------
+
+bool QueryProfiler::isSlowQuery(qint64 ns) const
+{
+    QMutexLocker locker(&m_mutex);
+    return !m_slowQueryLogPath.isEmpty() && (ns >= m_slowQueryThresholdNs);
+}
+
+void QueryProfiler::record(const QString &sql, const QString &expandedSql,
+                           qint64 ns)
+{
+    QString key = normalizeSql(sql);
+
+    QMutexLocker locker(&m_mutex);
+
+    m_statementCount++;
+
+    Entry &e = m_entries[key];
+    e.count++;
+    e.totalNs += ns;
+    e.maxNs = qMax(e.maxNs, ns);
+
+    int bucket = 0;
+    while ((bucket < (BucketCount - 1)) && (ns >= BUCKET_LIMITS[bucket]))
+        bucket++;
+    e.histogram[bucket]++;
+
+    if (!m_slowQueryLogPath.isEmpty() && (ns >= m_slowQueryThresholdNs)) {
+        QFile log(m_slowQueryLogPath);
+        if (log.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+            QTextStream out(&log);
+            out << QDateTime::currentDateTime().toString(Qt::ISODate) << "\t"
+                << QString::number(ns / 1e6, 'f', 3) << " ms\t"
+                << expandedSql << "\n";
+        }
+    }
+}
+
+int QueryProfiler::profileCallback(unsigned type, void *context,
+                                   void *statement, void *nanoseconds)
+{
+#ifdef PASSIFLORA_SQL_TRACE
+    if (type != SQLITE_TRACE_PROFILE)
+        return 0;
+
+    QueryProfiler *profiler = static_cast<QueryProfiler*>(context);
+    sqlite3_stmt *stmt = static_cast<sqlite3_stmt*>(statement);
+    qint64 ns = *static_cast<sqlite3_int64*>(nanoseconds);
+
+    QString sql = QString::fromUtf8(sqlite3_sql(stmt));
+
+    //bound values are only needed for the slow query log
+    QString expandedSql;
+    if (profiler->isSlowQuery(ns)) {
+        char *expanded = sqlite3_expanded_sql(stmt);
+        expandedSql = QString::fromUtf8(expanded);
+        sqlite3_free(expanded);
+    }
+
+    profiler->record(sql, expandedSql, ns);
+#else
+    Q_UNUSED(type);
+    Q_UNUSED(context);
+    Q_UNUSED(statement);
+    Q_UNUSED(nanoseconds);
+#endif
+    return 0;
+}
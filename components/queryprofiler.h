@@ -0,0 +1,114 @@
+/**
+  * \class QueryProfiler
+  * \brief This class records every SQL statement executed on a database
+  *        connection by using the SQLite profile hook of the driver handle.
+  *        Statements are grouped by their SQL text, with literal values
+  *        replaced by ?, so each group corresponds to one call site.
+  *        For each group count, total and max time and a latency
+  *        histogram are kept. Statements slower than a threshold are
+  *        appended to a slow query log. Needs CONFIG+=system_sqlite,
+  *        without it install() fails and nothing is recorded.
+  *        See DatabaseManager for how profiling is enabled.
+  * \author Giorgio Wicklein - GIOWISYS Software
+  * \date 19/10/2026
+  */
+
+#ifndef QUERYPROFILER_H
+#define QUERYPROFILER_H
+
+
+//-----------------------------------------------------------------------------
+// Headers
+//-----------------------------------------------------------------------------
+
+#include <QtCore/QString>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+
+
+//-----------------------------------------------------------------------------
+// Forward declarations
+//-----------------------------------------------------------------------------
+
+class QSqlDatabase;
+
+
+//-----------------------------------------------------------------------------
+// QueryProfiler
+//-----------------------------------------------------------------------------
+
+class QueryProfiler
+{
+public:
+    /** Latency histogram buckets, upper bounds are 0.1, 1, 10 and 100 ms */
+    enum { BucketCount = 5 };
+
+    /** Statistics of one statement group */
+    struct Entry {
+        Entry();
+        int count;
+        qint64 totalNs;
+        qint64 maxNs;
+        int histogram[BucketCount];
+    };
+
+    QueryProfiler();
+    ~QueryProfiler();
+
+    /**
+     * Install the profile hook on the specified connection,
+     * only one connection can be profiled at a time
+     * @return whether the hook has been installed
+     */
+    bool install(QSqlDatabase &database);
+
+    /** Remove the profile hook from the profiled connection, if any */
+    void uninstall();
+
+    /** Whether the hook is installed */
+    bool isInstalled() const;
+
+    /**
+     * Set the slow query log. Statements taking at least thresholdMs
+     * are appended with their bound values to the specified file.
+     * An empty file path disables the log.
+     */
+    void setSlowQueryLog(const QString &filePath, int thresholdMs);
+
+    /** Return the count of statements executed since the last reset */
+    qint64 statementCount() const;
+
+    /** Return the statistics of all statement groups */
+    QHash<QString, Entry> entries() const;
+
+    /** Clear all statistics */
+    void reset();
+
+    /** Return a plain text report, groups sorted by total time */
+    QString report() const;
+
+    /** Return the SQL with string and number literals replaced by ? */
+    static QString normalizeSql(const QString &sql);
+
+private:
+    QueryProfiler(const QueryProfiler&) {}
+
+    /** Whether the statement time is above the slow query log threshold */
+    bool isSlowQuery(qint64 ns) const;
+
+    /** Add a statement execution to the statistics */
+    void record(const QString &sql, const QString &expandedSql, qint64 ns);
+
+    /** SQLite trace callback */
+    static int profileCallback(unsigned type, void *context,
+                               void *statement, void *nanoseconds);
+
+    mutable QMutex m_mutex;
+    void *m_handle; /**< Profiled sqlite3 handle or 0 */
+    QHash<QString, Entry> m_entries;
+    qint64 m_statementCount;
+    QString m_slowQueryLogPath;
+    qint64 m_slowQueryThresholdNs;
+};
+
+#endif // QUERYPROFILER_H
@@ -314,75 +314,34 @@ bool SettingsManager::restoreCheckUpdates()
     return b;
 }
 
-void SettingsManager::saveToUploadList(const QStringList &list)
+void SettingsManager::restoreLegacySyncLists(QStringList &uploadList,
+                                             QStringList &deleteList,
+                                             QHash<QString,QDateTime> &watchMap) const
 {
-    m_settings->beginGroup("cloudSync");
-    m_settings->setValue("toUpload", list);
-    m_settings->endGroup();
-}
-
-QStringList SettingsManager::restoreToUploadList()
-{
-    QStringList s;
-
-    m_settings->beginGroup("cloudSync");
-    s = m_settings->value("toUpload").toStringList();
-    m_settings->endGroup();
-
-    return s;
-}
-
-void SettingsManager::saveToDeleteList(const QStringList &list)
-{
-    m_settings->beginGroup("cloudSync");
-    m_settings->setValue("toDelete", list);
-    m_settings->endGroup();
-}
-
-QStringList SettingsManager::restoreToDeleteList()
-{
-    QStringList s;
-
-    m_settings->beginGroup("cloudSync");
-    s = m_settings->value("toDelete").toStringList();
-    m_settings->endGroup();
-
-    return s;
-}
-
-void SettingsManager::saveToWatchList(const QHash<QString, QDateTime> &map)
-{
-    QList<QVariant> keys;
-    QList<QVariant> values;
-
-    QList<QString> t_keys = map.keys();
-    for (int i = 0; i < map.size(); i++) {
-        keys.append(t_keys.at(i));
-        values.append(map.value(t_keys.at(i)));
-    }
-
-    m_settings->beginGroup("cloudSync");
-    m_settings->setValue("toWatchKeys", keys);
-    m_settings->setValue("toWatchValues", values);
-    m_settings->endGroup();
-}
-
-QHash<QString, QDateTime> SettingsManager::restoreToWatchList()
-{
-    QHash<QString,QDateTime> map;
     QList<QVariant> keys;
     QList<QVariant> values;
 
     m_settings->beginGroup("cloudSync");
+    uploadList = m_settings->value("toUpload").toStringList();
+    deleteList = m_settings->value("toDelete").toStringList();
     keys = m_settings->value("toWatchKeys").toList();
     values = m_settings->value("toWatchValues").toList();
     m_settings->endGroup();
 
-    for (int i = 0; i < keys.size(); i++) {
-        map.insert(keys.at(i).toString(), values.at(i).toDateTime());
+    watchMap.clear();
+    for (int i = 0; (i < keys.size()) && (i < values.size()); i++) {
+        watchMap.insert(keys.at(i).toString(), values.at(i).toDateTime());
     }
+}
 
-    return map;
+void SettingsManager::removeLegacySyncLists()
+{
+    m_settings->beginGroup("cloudSync");
+    m_settings->remove("toUpload");
+    m_settings->remove("toDelete");
+    m_settings->remove("toWatchKeys");
+    m_settings->remove("toWatchValues");
+    m_settings->endGroup();
 }
 
 void SettingsManager::saveLicenseKey(const QString &keyString,
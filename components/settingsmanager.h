@@ -151,23 +151,20 @@ public:
     /** Check updates automatically at startup */
     bool restoreCheckUpdates();
 
-    /** Save list of files to upload */
-    void saveToUploadList(const QStringList &list);
-
-    /** Restore list of files to upload */
-    QStringList restoreToUploadList();
-
-    /** Save list of files to delete */
-    void saveToDeleteList(const QStringList &list);
-
-    /** Restore list of files to delete */
-    QStringList restoreToDeleteList();
-
-    /** Save list of files to watch/check for changes */
-    void saveToWatchList(const QHash<QString,QDateTime> &map);
+    /**
+     * Restore file lists of the old settings based sync state storage.
+     * Those lists are now kept in the sync state database,
+     * see DatabaseManager::getSyncStateDatabase().
+     * @param uploadList - list where files to upload are restored to
+     * @param deleteList - list where files to delete are restored to
+     * @param watchMap - hash where watched files are restored to
+     */
+    void restoreLegacySyncLists(QStringList &uploadList,
+                                QStringList &deleteList,
+                                QHash<QString,QDateTime> &watchMap) const;
 
-    /** Restore list of files to watch/check for changes */
-    QHash<QString,QDateTime> restoreToWatchList();
+    /** Delete file lists of the old settings based sync state storage */
+    void removeLegacySyncLists();
 
     /** Save license key details */
     void saveLicenseKey(const QString &keyString,
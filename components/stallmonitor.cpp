@@ -0,0 +1,179 @@
+/*
+ *  Copyright (c) 2017 Giorgio Wicklein <giowckln@gmail.com>
+ */
+
+//-----------------------------------------------------------------------------
+// Hearders
+//-----------------------------------------------------------------------------
+
+#include "stallmonitor.h"
+
+#include <QtCore/QTimer>
+#include <QtCore/QFile>
+#include <QtCore/QDateTime>
+#include <QtCore/QTextStream>
+#include <QtCore/QList>
+#include <QtCore/QPair>
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define TICK_INTERVAL_MS 50
+#define NO_OPERATION_NAME "other"
+
+
+//-----------------------------------------------------------------------------
+// Static init
+//-----------------------------------------------------------------------------
+
+StallMonitor* StallMonitor::m_instance = 0;
+
+
+//-----------------------------------------------------------------------------
+// Public
+//-----------------------------------------------------------------------------
+
+StallMonitor& StallMonitor::getInstance()
+{
+    if (!m_instance)
+        m_instance = new StallMonitor();
+    return *m_instance;
+}
+
+void StallMonitor::destroy()
+{
+    if (m_instance)
+        delete m_instance;
+    m_instance = 0;
+}
+
+bool StallMonitor::isActive()
+{
+    return m_instance && m_instance->m_tickTimer->isActive();
+}
+
+void StallMonitor::start(const QString &logFilePath, int thresholdMs)
+{
+    m_logFilePath = logFilePath;
+    m_thresholdMs = qMax(1, thresholdMs);
+    m_summary.clear();
+    m_tickOperations = m_activeOperations;
+
+    m_elapsedTimer.start();
+    m_tickTimer->start(TICK_INTERVAL_MS);
+}
+
+void StallMonitor::stop()
+{
+    if (!m_tickTimer->isActive())
+        return;
+    m_tickTimer->stop();
+
+    QFile log(m_logFilePath);
+    if (log.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        QTextStream out(&log);
+        out << "# summary " << QDateTime::currentDateTime().toString(Qt::ISODate)
+            << "\n" << report();
+    }
+}
+
+void StallMonitor::beginOperation(const QString &name)
+{
+    if (!isActive())
+        return;
+
+    m_instance->m_activeOperations.append(name);
+    if (!m_instance->m_tickOperations.contains(name))
+        m_instance->m_tickOperations.append(name);
+}
+
+void StallMonitor::endOperation()
+{
+    if (!m_instance || m_instance->m_activeOperations.isEmpty())
+        return;
+
+    m_instance->m_activeOperations.removeLast();
+}
+
+QHash<QString, StallMonitor::Entry> StallMonitor::summary() const
+{
+    return m_summary;
+}
+
+QString StallMonitor::report() const
+{
+    //sort by total time, descending
+    QList<QPair<qint64, QString> > order;
+    QHash<QString, Entry>::const_iterator it;
+    for (it = m_summary.constBegin(); it != m_summary.constEnd(); ++it)
+        order.append(qMakePair(-it.value().totalMs, it.key()));
+    qSort(order);
+
+    QString s;
+    QTextStream out(&s);
+    out << "stalls\ttotal ms\tmax ms\toperation\n";
+    for (int i = 0; i < order.size(); i++) {
+        const Entry &e = m_summary[order.at(i).second];
+        out << e.count << "\t" << e.totalMs << "\t" << e.maxMs << "\t"
+            << order.at(i).second << "\n";
+    }
+
+    return s;
+}
+
+
+//-----------------------------------------------------------------------------
+// Private slots
+//-----------------------------------------------------------------------------
+
+void StallMonitor::tickSlot()
+{
+    qint64 delay = m_elapsedTimer.restart() - TICK_INTERVAL_MS;
+
+    if (delay >= m_thresholdMs) {
+        QString operation = m_tickOperations.isEmpty() ?
+                    QString(NO_OPERATION_NAME) : m_tickOperations.join("/");
+        recordStall(delay, operation);
+    }
+
+    //operations still running belong to the next tick too
+    m_tickOperations = m_activeOperations;
+    m_tickOperations.removeDuplicates();
+}
+
+
+//-----------------------------------------------------------------------------
+// Private
+//-----------------------------------------------------------------------------
+
+StallMonitor::StallMonitor(QObject *parent) :
+    QObject(parent),
+    m_thresholdMs(0)
+{
+    m_tickTimer = new QTimer(this);
+    m_tickTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_tickTimer, SIGNAL(timeout()),
+            this, SLOT(tickSlot()));
+}
+
+StallMonitor::~StallMonitor()
+{
+    stop();
+}
+
+void StallMonitor::recordStall(qint64 ms, const QString &operation)
+{
+    Entry &e = m_summary[operation];
+    e.count++;
+    e.totalMs += ms;
+    e.maxMs = qMax(e.maxMs, ms);
+
+    QFile log(m_logFilePath);
+    if (log.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        QTextStream out(&log);
+        out << QDateTime::currentDateTime().toString(Qt::ISODate) << "\t"
+            << ms << " ms\t" << operation << "\n";
+    }
+}
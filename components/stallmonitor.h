@@ -0,0 +1,112 @@
+/**
+  * \class StallMonitor
+  * \brief This class measures the latency of the GUI event loop with a
+  *        watchdog timer. On each tick the actual interval is compared
+  *        with the expected one, a tick late by at least the threshold
+  *        is recorded as a stall. Each stall is attributed to the
+  *        operations (search, delete, backup, print, sync...) that were
+  *        running since the previous tick, so freezes can be traced
+  *        to code paths. Stalls are appended to a log file as they
+  *        happen and a summary per operation is written on stop.
+  *        The monitor is optional, operations are only tracked
+  *        while it is active.
+  * \author Giorgio Wicklein - GIOWISYS Software
+  * \date 19/10/2026
+  */
+
+#ifndef STALLMONITOR_H
+#define STALLMONITOR_H
+
+
+//-----------------------------------------------------------------------------
+// Headers
+//-----------------------------------------------------------------------------
+
+#include <QtCore/QObject>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+
+//-----------------------------------------------------------------------------
+// Forward declarations
+//-----------------------------------------------------------------------------
+
+class QTimer;
+
+
+//-----------------------------------------------------------------------------
+// StallMonitor
+//-----------------------------------------------------------------------------
+
+class StallMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    /** Stall statistics of one operation */
+    struct Entry {
+        Entry() : count(0), totalMs(0), maxMs(0) {}
+        int count;
+        qint64 totalMs;
+        qint64 maxMs;
+    };
+
+    /** Marks an operation as running for the lifetime of the object */
+    class Operation
+    {
+    public:
+        Operation(const QString &name) { StallMonitor::beginOperation(name); }
+        ~Operation() { StallMonitor::endOperation(); }
+    };
+
+    static StallMonitor& getInstance(); //singleton
+    static void destroy();
+
+    /** Return whether the monitor has been started (without creating it) */
+    static bool isActive();
+
+    /**
+     * Start the watchdog timer
+     * @param logFilePath - file where stalls and the summary are appended
+     * @param thresholdMs - minimum tick delay recorded as stall
+     */
+    void start(const QString &logFilePath, int thresholdMs);
+
+    /** Stop the watchdog timer and append the summary to the log file */
+    void stop();
+
+    /** Mark the start of the named operation, no-op if not active */
+    static void beginOperation(const QString &name);
+
+    /** Mark the end of the last started operation, no-op if not active */
+    static void endOperation();
+
+    /** Return the stall statistics by operation name */
+    QHash<QString, Entry> summary() const;
+
+    /** Return a plain text summary, operations sorted by total stall time */
+    QString report() const;
+
+private slots:
+    void tickSlot();
+
+private:
+    StallMonitor(QObject *parent = 0); //singleton
+    ~StallMonitor();
+
+    /** Record a stall for the specified operations */
+    void recordStall(qint64 ms, const QString &operation);
+
+    static StallMonitor *m_instance;
+    QTimer *m_tickTimer;
+    QElapsedTimer m_elapsedTimer;
+    QString m_logFilePath;
+    int m_thresholdMs;
+    QStringList m_activeOperations; /**< Running operations, innermost last */
+    QStringList m_tickOperations; /**< Operations seen since the last tick */
+    QHash<QString, Entry> m_summary;
+};
+
+#endif // STALLMONITOR_H
@@ -12,8 +12,15 @@
 #include "../utils/formviewlayoutstate.h"
 #include "../views/formview/formview.h"
 #include "../utils/metadatapropertiesparser.h"
+#include "databasemanager.h"
 
 #include <QtCore/QAbstractItemModel>
+#include <QtCore/QDataStream>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlQuery>
+#include <QtSql/QSqlRecord>
 
 
 //-----------------------------------------------------------------------------
@@ -248,6 +255,223 @@ void ModFieldCommand::handleEditTriggers()
 }
 
 
+//-----------------------------------------------------------------------------
+// RecordSnapshot
+//-----------------------------------------------------------------------------
+
+RecordSnapshot::RecordSnapshot(int collectionId, const QList<int> &recordIds,
+                               int byteBudget) :
+    m_collectionId(collectionId),
+    m_recordIds(recordIds),
+    m_hasValues(false)
+{
+    m_tableName = MetadataEngine::getInstance().getTableName(m_collectionId);
+
+    //check the size before reading any value
+    if ((byteBudget != -1) &&
+            (estimateByteSize(m_collectionId, m_recordIds) > byteBudget))
+        return;
+
+    save();
+}
+
+RecordSnapshot::RecordSnapshot(int collectionId) :
+    m_collectionId(collectionId),
+    m_hasValues(false)
+{
+    m_tableName = MetadataEngine::getInstance().getTableName(m_collectionId);
+
+    int recordId = lastRecordId(m_collectionId);
+    if (recordId)
+        m_recordIds.append(recordId);
+
+    save();
+}
+
+void RecordSnapshot::remove() const
+{
+    if (m_recordIds.isEmpty()) return;
+
+    QSqlQuery query(DatabaseManager::getInstance().getDatabase());
+    query.exec(QString("DELETE FROM '%1' WHERE _id IN (%2)")
+               .arg(m_tableName).arg(recordIdList(m_recordIds)));
+
+    reloadModel();
+}
+
+void RecordSnapshot::restore() const
+{
+    if (m_data.isEmpty()) return;
+
+    //restore column values
+    QByteArray data = qUncompress(m_data);
+    QDataStream in(&data, QIODevice::ReadOnly);
+    QStringList columnNames;
+    in >> columnNames;
+
+    QStringList placeholders;
+    QVector<QVariantList> columns(columnNames.size());
+    for (int i = 0; i < columns.size(); i++) {
+        in >> columns[i];
+        columnNames[i] = "\"" + columnNames.at(i) + "\"";
+        placeholders.append("?");
+    }
+
+    //insert all records with their original ids
+    DatabaseManager &db = DatabaseManager::getInstance();
+    db.beginTransaction();
+    QSqlQuery query(db.getDatabase());
+    query.prepare(QString("INSERT INTO '%1' (%2) VALUES (%3)")
+                  .arg(m_tableName)
+                  .arg(columnNames.join(","))
+                  .arg(placeholders.join(",")));
+    for (int i = 0; i < columns.size(); i++)
+        query.addBindValue(columns.at(i));
+    query.execBatch();
+    db.endTransaction();
+
+    reloadModel();
+}
+
+int RecordSnapshot::recordCount() const
+{
+    return m_recordIds.size();
+}
+
+bool RecordSnapshot::hasValues() const
+{
+    return m_hasValues;
+}
+
+int RecordSnapshot::byteSize() const
+{
+    return m_data.size() + (m_recordIds.size() * int(sizeof(int)));
+}
+
+int RecordSnapshot::lastRecordId(int collectionId)
+{
+    QString tableName = MetadataEngine::getInstance().getTableName(collectionId);
+
+    QSqlQuery query(DatabaseManager::getInstance().getDatabase());
+    query.exec(QString("SELECT MAX(_id) FROM '%1'").arg(tableName));
+    if (query.next() && !query.value(0).isNull())
+        return query.value(0).toInt();
+
+    return 0;
+}
+
+QList<int> RecordSnapshot::recordIdsAfter(int collectionId, int recordId)
+{
+    QString tableName = MetadataEngine::getInstance().getTableName(collectionId);
+    QList<int> recordIds;
+
+    QSqlQuery query(DatabaseManager::getInstance().getDatabase());
+    query.setForwardOnly(true);
+    query.exec(QString("SELECT _id FROM '%1' WHERE _id > %2 ORDER BY _id")
+               .arg(tableName).arg(recordId));
+    while (query.next())
+        recordIds.append(query.value(0).toInt());
+
+    return recordIds;
+}
+
+QList<int> RecordSnapshot::recordIdsAtRows(const QList<int> &rows)
+{
+    QList<int> ids;
+
+    //the rows are already fetched since they are selected
+    QAbstractItemModel *model = MainWindow::getCurrentModel();
+    if (model) {
+        foreach (int row, rows) {
+            QModelIndex index = model->index(row, 0);
+            if (index.isValid())
+                ids.append(index.data().toInt());
+        }
+    }
+
+    return ids;
+}
+
+qint64 RecordSnapshot::estimateByteSize(int collectionId,
+                                        const QList<int> &recordIds)
+{
+    if (recordIds.isEmpty()) return 0;
+
+    QString tableName = MetadataEngine::getInstance().getTableName(collectionId);
+    QSqlDatabase db = DatabaseManager::getInstance().getDatabase();
+    QSqlRecord record = db.record(tableName);
+    QStringList lengths;
+    for (int i = 0; i < record.count(); i++)
+        lengths.append(QString("total(length(\"%1\"))").arg(record.fieldName(i)));
+
+    //row count times average row size, computed by SQLite
+    QSqlQuery query(db);
+    query.exec(QString("SELECT COUNT(*), %1 FROM '%2' WHERE _id IN (%3)")
+               .arg(lengths.join("+"))
+               .arg(tableName)
+               .arg(recordIdList(recordIds)));
+    if (!query.next())
+        return 0;
+
+    //each value is streamed with a type header
+    qint64 count = query.value(0).toLongLong();
+    qint64 bytes = qint64(query.value(1).toDouble());
+    return bytes + (count * record.count() * 8);
+}
+
+void RecordSnapshot::save()
+{
+    if (m_recordIds.isEmpty()) return;
+
+    //read all records with a single query, column by column
+    QSqlQuery query(DatabaseManager::getInstance().getDatabase());
+    query.setForwardOnly(true);
+    query.exec(QString("SELECT * FROM '%1' WHERE _id IN (%2)")
+               .arg(m_tableName).arg(recordIdList(m_recordIds)));
+
+    QSqlRecord record = query.record();
+    QStringList columnNames;
+    for (int i = 0; i < record.count(); i++)
+        columnNames.append(record.fieldName(i));
+
+    QVector<QVariantList> columns(record.count());
+    while (query.next()) {
+        for (int i = 0; i < columns.size(); i++)
+            columns[i].append(query.value(i));
+    }
+
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out << columnNames;
+    for (int i = 0; i < columns.size(); i++)
+        out << columns.at(i);
+
+    m_data = qCompress(data);
+    m_hasValues = true;
+}
+
+void RecordSnapshot::reloadModel() const
+{
+    if (MetadataEngine::getInstance().getCurrentCollectionId() != m_collectionId)
+        return;
+
+    //assuming StandardModel only
+    StandardModel *sModel = qobject_cast<StandardModel*>(
+                MainWindow::getCurrentModel());
+    if (sModel)
+        sModel->select();
+}
+
+QString RecordSnapshot::recordIdList(const QList<int> &recordIds)
+{
+    QStringList ids;
+    foreach (int id, recordIds)
+        ids.append(QString::number(id));
+
+    return ids.join(",");
+}
+
+
 //-----------------------------------------------------------------------------
 // ModRecordCommand
 //-----------------------------------------------------------------------------
@@ -258,12 +482,19 @@ ModRecordCommand::ModRecordCommand(int collectionId,
                                    const QVariant &newRecordData) :
     m_collectionId(collectionId),
     m_avoidConstructorRedo(true),
-    m_row(row),
+    m_recordId(-1),
     m_column(column),
     m_oldRecordData(oldRecordData),
     m_newRecordData(newRecordData)
 {
     setText(QObject::tr("record edit"));
+
+    QAbstractItemModel *model = MainWindow::getCurrentModel();
+    if (model) {
+        QModelIndex index = model->index(row, 0);
+        if (index.isValid())
+            m_recordId = index.data().toInt();
+    }
 }
 
 ModRecordCommand::~ModRecordCommand()
@@ -273,14 +504,8 @@ ModRecordCommand::~ModRecordCommand()
 
 void ModRecordCommand::undo()
 {
-    QAbstractItemModel *model = MainWindow::getCurrentModel();
-    if (!model) return;
-
-    QModelIndex index = model->index(m_row, m_column);
-    if (index.isValid()) {
-        model->setData(index, m_oldRecordData);
-        handleEditTriggers(m_oldRecordData);
-    }
+    setRecordData(m_oldRecordData);
+    handleEditTriggers(m_oldRecordData);
 }
 
 void ModRecordCommand::redo()
@@ -292,14 +517,8 @@ void ModRecordCommand::redo()
         return;
     }
 
-    QAbstractItemModel *model = MainWindow::getCurrentModel();
-    if (!model) return;
-
-    QModelIndex index = model->index(m_row, m_column);
-    if (index.isValid()) {
-        model->setData(index, m_newRecordData);
-        handleEditTriggers(m_newRecordData);
-    }
+    setRecordData(m_newRecordData);
+    handleEditTriggers(m_newRecordData);
 }
 
 void ModRecordCommand::handleEditTriggers(const QVariant &data)
@@ -316,13 +535,7 @@ void ModRecordCommand::handleEditTriggers(const QVariant &data)
         if (parser.size() > 0) {
             //update alarm
             if (parser.getValue("alarmOnDate") == "1") {
-                int id = -1;
-                QAbstractItemModel *model = MainWindow::getCurrentModel();
-                if (model) {
-                    QModelIndex index = model->index(m_row, 0);
-                    if (index.isValid())
-                        id = index.data().toInt();
-                }
+                int id = m_recordId;
                 QDateTime dateTime(data.toDateTime());
                 AlarmManager a;
                 a.addOrUpdateAlarm(m_collectionId,
@@ -340,11 +553,41 @@ void ModRecordCommand::handleEditTriggers(const QVariant &data)
 }
 
 
+void ModRecordCommand::setRecordData(const QVariant &data)
+{
+    if (m_recordId == -1) return;
+
+    //assuming StandardModel only
+    StandardModel *sModel = qobject_cast<StandardModel*>(
+                MainWindow::getCurrentModel());
+    if (sModel && (MetadataEngine::getInstance().getCurrentCollectionId()
+                   == m_collectionId)) {
+        int row = sModel->findRecordRow(m_recordId);
+        if (row != -1) {
+            sModel->setData(sModel->index(row, m_column), data, Qt::EditRole);
+            return;
+        }
+    }
+
+    //the record is not loaded, update it directly
+    QSqlQuery query(DatabaseManager::getInstance().getDatabase());
+    MetadataEngine *meta = &MetadataEngine::getInstance();
+    query.prepare(QString("UPDATE '%1' SET \"%2\"=? WHERE _id=?")
+                  .arg(meta->getTableName(m_collectionId))
+                  .arg(meta->getFieldKey(m_column, m_collectionId)));
+    query.addBindValue(data);
+    query.addBindValue(m_recordId);
+    query.exec();
+}
+
+
 //-----------------------------------------------------------------------------
 // NewRecordCommand
 //-----------------------------------------------------------------------------
 
-NewRecordCommand::NewRecordCommand() : m_avoidConstructorRedo(true)
+NewRecordCommand::NewRecordCommand() :
+    m_avoidConstructorRedo(true),
+    m_snapshot(MetadataEngine::getInstance().getCurrentCollectionId())
 {
     setText(QObject::tr("record creation"));
 }
@@ -356,17 +599,7 @@ NewRecordCommand::~NewRecordCommand()
 
 void NewRecordCommand::undo()
 {
-    QAbstractItemModel *model = MainWindow::getCurrentModel();
-    if (!model) return;
-
-    QModelIndex index;
-    while (model->canFetchMore(index))
-        model->fetchMore(index);
-
-    int rowCount = model->rowCount();
-
-    //delete last record
-    model->removeRow(rowCount - 1);
+    m_snapshot.remove();
 }
 
 void NewRecordCommand::redo()
@@ -378,15 +611,12 @@ void NewRecordCommand::redo()
         return;
     }
 
-    QAbstractItemModel *model = MainWindow::getCurrentModel();
-    if (!model) return;
+    m_snapshot.restore();
+}
 
-    //add new record
-    //assuming StandardModel only
-    StandardModel *sModel = qobject_cast<StandardModel*>(model);
-    if (sModel) {
-        sModel->addRecord();
-    }
+int NewRecordCommand::byteSize() const
+{
+    return m_snapshot.byteSize();
 }
 
 
@@ -394,24 +624,13 @@ void NewRecordCommand::redo()
 // DeleteRecordCommand
 //-----------------------------------------------------------------------------
 
-DeleteRecordCommand::DeleteRecordCommand(int row, QUndoCommand *parent) :
-    QUndoCommand(parent), m_avoidConstructorRedo(true),
-    m_rowToDelete(row)
+DeleteRecordCommand::DeleteRecordCommand(const QList<int> &rows, QUndoCommand *parent) :
+    QUndoCommand(parent),
+    m_snapshot(MetadataEngine::getInstance().getCurrentCollectionId(),
+               RecordSnapshot::recordIdsAtRows(rows),
+               RecordSnapshot::UNDO_BYTE_BUDGET)
 {
     setText(QObject::tr("record deletion"));
-
-    //save old data
-    QAbstractItemModel *model = MainWindow::getCurrentModel();
-    if (model) {
-        QModelIndex index;
-        while (model->canFetchMore(index))
-            model->fetchMore(index);
-
-        for (int i = 1; i < model->columnCount(); i++) { //1 cause 0 is _id
-            index = model->index(m_rowToDelete, i);
-            m_dataList.append(index.data());
-        }
-    }
 }
 
 DeleteRecordCommand::~DeleteRecordCommand()
@@ -421,46 +640,27 @@ DeleteRecordCommand::~DeleteRecordCommand()
 
 void DeleteRecordCommand::undo()
 {
-    QAbstractItemModel *model = MainWindow::getCurrentModel();
-    if (!model) return;
-
-    QModelIndex index;
-    while (model->canFetchMore(index))
-        model->fetchMore(index);
-    int rowCount = model->rowCount();
-
-    //insert row again at the end
-    model->insertRow(rowCount++);
-    index = model->index(rowCount - 1, 0);
-
-    //set old data
-    for (int i = 1; i < model->columnCount(); i++) {
-        index = model->index(index.row(), i);
-        model->setData(index, m_dataList.at(i-1)); //-1 cause list starts at 0
-                                                   //but column at 1 (0 is _id)
-    }
-
-    model->submit();
+    m_snapshot.restore();
 }
 
 void DeleteRecordCommand::redo()
 {
-    //since redo() is called automatically from constructor
-    //use this to prevent the call
-    if (m_avoidConstructorRedo) {
-        m_avoidConstructorRedo = false;
-        return;
-    }
+    m_snapshot.remove();
+}
 
-    QAbstractItemModel *model = MainWindow::getCurrentModel();
-    if (!model) return;
+int DeleteRecordCommand::recordCount() const
+{
+    return m_snapshot.recordCount();
+}
 
-    QModelIndex index;
-    while (model->canFetchMore(index))
-        model->fetchMore(index);
-    int rowCount = model->rowCount();
+int DeleteRecordCommand::byteSize() const
+{
+    return m_snapshot.byteSize();
+}
 
-    model->removeRow(rowCount - 1); //delete last record
+bool DeleteRecordCommand::isUndoable() const
+{
+    return m_snapshot.hasValues() || (!m_snapshot.recordCount());
 }
 
 
@@ -468,9 +668,17 @@ void DeleteRecordCommand::redo()
 // DuplicateRecordCommand
 //-----------------------------------------------------------------------------
 
-DuplicateRecordCommand::DuplicateRecordCommand(int row, QUndoCommand *parent) :
+DuplicateRecordCommand::DuplicateRecordCommand(QUndoCommand *parent) :
+    QUndoCommand(parent), m_avoidConstructorRedo(true),
+    m_snapshot(MetadataEngine::getInstance().getCurrentCollectionId())
+{
+    setText(QObject::tr("record duplication"));
+}
+
+DuplicateRecordCommand::DuplicateRecordCommand(const QList<int> &recordIds,
+                                               QUndoCommand *parent) :
     QUndoCommand(parent), m_avoidConstructorRedo(true),
-    m_rowToDuplicate(row)
+    m_snapshot(MetadataEngine::getInstance().getCurrentCollectionId(), recordIds)
 {
     setText(QObject::tr("record duplication"));
 }
@@ -482,15 +690,7 @@ DuplicateRecordCommand::~DuplicateRecordCommand()
 
 void DuplicateRecordCommand::undo()
 {
-    QAbstractItemModel *model = MainWindow::getCurrentModel();
-    if (!model) return;
-
-    QModelIndex index;
-    while (model->canFetchMore(index))
-        model->fetchMore(index);
-    int rowCount = model->rowCount();
-
-    model->removeRow(rowCount - 1); //delete last record
+    m_snapshot.remove();
 }
 
 void DuplicateRecordCommand::redo()
@@ -502,15 +702,12 @@ void DuplicateRecordCommand::redo()
         return;
     }
 
-    QAbstractItemModel *model = MainWindow::getCurrentModel();
-    if (!model) return;
+    m_snapshot.restore();
+}
 
-    //duplicate record
-    //assuming StandardModel only
-    StandardModel *sModel = qobject_cast<StandardModel*>(model);
-    if (sModel) {
-        sModel->duplicateRecord(m_rowToDuplicate);
-    }
+int DuplicateRecordCommand::byteSize() const
+{
+    return m_snapshot.byteSize();
 }
 
 
@@ -16,6 +16,7 @@
 #include <QtWidgets/QUndoCommand>
 #include <QtCore/QVariant>
 #include <QtCore/QList>
+#include <QtCore/QByteArray>
 
 #include "metadataengine.h"
 
@@ -177,6 +178,98 @@ private:
 };
 
 
+//-----------------------------------------------------------------------------
+// RecordSnapshot
+//-----------------------------------------------------------------------------
+
+/**
+  * \class RecordSnapshot
+  * \brief Saved values of a set of records of a collection.
+  *        Records are addressed by _id, so a snapshot stays valid
+  *        if the model is filtered or sorted. The values are kept as
+  *        a compressed column-major blob and removed or restored
+  *        with single SQL statements. Used by record commands.
+  * \author Giorgio Wicklein - GIOWISYS Software
+  * \date 19/10/2026
+  */
+class RecordSnapshot
+{
+public:
+    /**
+     * Save the records with the specified ids
+     * @param byteBudget - values are saved only if their estimated size
+     *                     is within this number of bytes, -1 for no limit.
+     *                     Without values the records can be removed
+     *                     but not restored
+     */
+    RecordSnapshot(int collectionId, const QList<int> &recordIds,
+                   int byteBudget = -1);
+
+    /**
+     * Save the most recently created record of the collection.
+     * This is the record with the highest _id, which relies on _id
+     * being the implicit rowid (INTEGER PRIMARY KEY without
+     * AUTOINCREMENT), so new records get a higher id than all others
+     */
+    explicit RecordSnapshot(int collectionId);
+
+    /** Delete the saved records from the database */
+    void remove() const;
+
+    /** Insert the saved records again with their original ids */
+    void restore() const;
+
+    /** Return the number of saved records */
+    int recordCount() const;
+
+    /** Return whether the values are saved, so records can be restored */
+    bool hasValues() const;
+
+    /** Return the memory used by the snapshot in bytes */
+    int byteSize() const;
+
+    /**
+     * Return the highest _id of the collection, 0 if it is empty.
+     * Records created later have higher ids (see implicit rowid above)
+     */
+    static int lastRecordId(int collectionId);
+
+    /** Return the ids of the records created after the specified _id */
+    static QList<int> recordIdsAfter(int collectionId, int recordId);
+
+    /** Return the _id of the records at the specified rows of the current model */
+    static QList<int> recordIdsAtRows(const QList<int> &rows);
+
+    /**
+     * Estimate the snapshot size of the specified records from the
+     * stored value lengths, without reading the values
+     */
+    static qint64 estimateByteSize(int collectionId, const QList<int> &recordIds);
+
+    /**
+     * Max memory in bytes for record snapshots in the undo stack.
+     * Record operations over this size cannot be undone.
+     */
+    static const int UNDO_BYTE_BUDGET = 32 * 1024 * 1024;
+
+private:
+    /** Read the values of m_recordIds from database */
+    void save();
+
+    /** Reload the model if it shows the collection of the records */
+    void reloadModel() const;
+
+    /** Return the record ids as comma separated list for SQL */
+    static QString recordIdList(const QList<int> &recordIds);
+
+    int m_collectionId;
+    QString m_tableName;
+    QList<int> m_recordIds;  /**< _id of every saved record */
+    QByteArray m_data;       /**< Compressed column values of the records */
+    bool m_hasValues;        /**< Whether m_data has been saved */
+};
+
+
 //-----------------------------------------------------------------------------
 // ModRecordCommand
 //-----------------------------------------------------------------------------
@@ -184,12 +277,21 @@ private:
 /**
   * \class ModRecordCommand
   * \brief Command to undo/redo record modification.
+  *        The record is addressed by _id, its row is resolved
+  *        on undo/redo, so the command survives model filtering.
   * \author Giorgio Wicklein - GIOWISYS Software
   * \date 03/08/2012
   */
 class ModRecordCommand : public QUndoCommand
 {
 public:
+    /**
+     * @param collectionId - the collection of the record
+     * @param row - the current model row of the record, used to get its _id
+     * @param column - the modified field
+     * @param oldRecordData - data before modification
+     * @param newRecordData - data after modification
+     */
     ModRecordCommand(int collectionId,
                      int row, int column,
                      const QVariant &oldRecordData,
@@ -202,11 +304,17 @@ public:
 private:
     void handleEditTriggers(const QVariant &data);
 
+    /**
+     * Set the field of the record through the model if the record
+     * is loaded, otherwise (ie. filtered out) directly in the database
+     */
+    void setRecordData(const QVariant &data);
+
     int m_collectionId;
     bool m_avoidConstructorRedo;
 
     //data
-    int m_row;
+    int m_recordId;
     int m_column;
     QVariant m_oldRecordData;
     QVariant m_newRecordData;
@@ -220,6 +328,7 @@ private:
 /**
   * \class NewRecordCommand
   * \brief Command to undo/redo record creation.
+  *        Must be created after the record, which is saved by _id.
   * \author Giorgio Wicklein - GIOWISYS Software
   * \date 03/08/2012
   */
@@ -232,8 +341,12 @@ public:
     void undo();
     void redo();
 
+    /** Return the memory used by the record snapshot in bytes */
+    int byteSize() const;
+
 private:
     bool m_avoidConstructorRedo;
+    RecordSnapshot m_snapshot;
 };
 
 
@@ -244,22 +357,42 @@ private:
 /**
   * \class DeleteRecordCommand
   * \brief Command to undo/redo record deletion.
+  *        The deleted records are saved in a RecordSnapshot, so undo
+  *        and redo are executed as a single SQL batch.
+  *        Unlike other commands, the deletion is
+  *        done by the first redo() call, so by pushing the command.
   * \author Giorgio Wicklein - GIOWISYS Software
   * \date 03/08/2012
   */
 class DeleteRecordCommand : public QUndoCommand
 {
 public:
-    DeleteRecordCommand(int row, QUndoCommand *parent = 0);
+    /**
+     * Save a snapshot of the records at the specified model rows
+     * @param rows - the rows of the current model to delete
+     * @param parent - parent command
+     */
+    DeleteRecordCommand(const QList<int> &rows, QUndoCommand *parent = 0);
     ~DeleteRecordCommand();
 
     void undo();
     void redo();
 
+    /** Return the number of records to delete */
+    int recordCount() const;
+
+    /** Return the memory used by the records snapshot in bytes */
+    int byteSize() const;
+
+    /**
+     * Return whether the records have been saved for undo.
+     * Records are not saved if their estimated size is over
+     * RecordSnapshot::UNDO_BYTE_BUDGET, the command can still delete them
+     */
+    bool isUndoable() const;
+
 private:
-    bool m_avoidConstructorRedo;
-    int m_rowToDelete;
-    QList<QVariant> m_dataList;
+    RecordSnapshot m_snapshot;
 };
 
 
@@ -270,21 +403,28 @@ private:
 /**
   * \class DuplicateRecordCommand
   * \brief Command to undo/redo record duplication.
+  *        Must be created after the duplicates, which are saved by _id.
+  *        Without ids the most recently created record is saved.
   * \author Giorgio Wicklein - GIOWISYS Software
   * \date 03/08/2012
   */
 class DuplicateRecordCommand : public QUndoCommand
 {
 public:
-    DuplicateRecordCommand(int row, QUndoCommand *parent = 0);
+    DuplicateRecordCommand(QUndoCommand *parent = 0);
+    DuplicateRecordCommand(const QList<int> &recordIds,
+                           QUndoCommand *parent = 0);
     ~DuplicateRecordCommand();
 
     void undo();
     void redo();
 
+    /** Return the memory used by the duplicates snapshot in bytes */
+    int byteSize() const;
+
 private:
     bool m_avoidConstructorRedo;
-    int m_rowToDuplicate;
+    RecordSnapshot m_snapshot;
 };
 
 #endif // UNDOCOMMANDS_H
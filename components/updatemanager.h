@@ -45,6 +45,8 @@ public:
         QString plantName;
         QString licenseString;
         QString filename;
+        qint64 fileSize; /**< Expected file size, -1 if unknown */
+        QString md5Hash; /**< Expected md5 hash (hex), empty if unknown */
     };
 
     static UpdateManager& getInstance(); //singleton
@@ -8,6 +8,7 @@
 
 #include "collectionlistmodel.h"
 #include "../components/databasemanager.h"
+#include "../components/metadataengine.h"
 
 #include <QtSql/QSqlRecord>
 #include <QtGui/QIcon>
@@ -42,7 +43,15 @@ bool CollectionListModel::setData(const QModelIndex &index,
 {
     //avoid empty collection names
     if (!value.toString().trimmed().isEmpty()) {
-        return QSqlTableModel::setData(index, value, role);
+        bool r = QSqlTableModel::setData(index, value, role);
+
+        //collection names are cached by metadata engine
+        if (r) {
+            MetadataEngine::getInstance().setDirtyCollectionCache(
+                        this->index(index.row(), 0).data().toInt());
+        }
+
+        return r;
     } else {
         return false;
     }
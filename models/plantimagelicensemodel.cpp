@@ -0,0 +1,94 @@
+/*
+ *  Copyright (c) 2017 Giorgio Wicklein <giowckln@gmail.com>
+ */
+
+//-----------------------------------------------------------------------------
+// Hearders
+//-----------------------------------------------------------------------------
+
+#include "plantimagelicensemodel.h"
+
+#include <QtCore/QCoreApplication>
+
+
+//-----------------------------------------------------------------------------
+// Public
+//-----------------------------------------------------------------------------
+
+PlantImageLicenseModel::PlantImageLicenseModel(const QString &filesDir,
+                                               QObject *parent) :
+    QAbstractListModel(parent), m_filesDir(filesDir)
+{
+}
+
+int PlantImageLicenseModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+
+    return m_images.size();
+}
+
+QVariant PlantImageLicenseModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || (index.row() >= m_images.size()))
+        return QVariant();
+
+    const UpdateManager::PlantImageMetadata &p = m_images.at(index.row());
+
+    switch (role) {
+    case Qt::DisplayRole:
+        return entryHtml(p);
+    case Qt::ToolTipRole:
+        return p.filename;
+    default:
+        return QVariant();
+    }
+}
+
+void PlantImageLicenseModel::appendImages(
+        const QList<UpdateManager::PlantImageMetadata*> &images)
+{
+    if (images.isEmpty())
+        return;
+
+    int first = m_images.size();
+    beginInsertRows(QModelIndex(), first, first + images.size() - 1);
+    foreach (UpdateManager::PlantImageMetadata *m, images) {
+        m_images.append(*m);
+    }
+    endInsertRows();
+}
+
+void PlantImageLicenseModel::clear()
+{
+    beginResetModel();
+    m_images.clear();
+    endResetModel();
+}
+
+
+//-----------------------------------------------------------------------------
+// Private
+//-----------------------------------------------------------------------------
+
+QString PlantImageLicenseModel::entryHtml(
+        const UpdateManager::PlantImageMetadata &p) const
+{
+    QString htmlString;
+    htmlString.append("<table><tr><td>");
+#ifdef Q_OS_WIN
+    htmlString.append("<a href=\"file:///" + m_filesDir + p.filename);
+#else
+    htmlString.append("<a href=\"file://" + m_filesDir + p.filename);
+#endif
+    //keep translation context of the former dialog label
+    htmlString.append(QCoreApplication::translate("DatabaseSyncDialog",
+                                                  "\">Click<br />to view</a></td>"));
+    htmlString.append("<td><b>" + p.plantName + "</b><br />");
+    htmlString.append(p.licenseString);
+    htmlString.append("<br />" + p.filename + "<br />");
+    htmlString.append("</td></tr></table>");
+
+    return htmlString;
+}
@@ -0,0 +1,58 @@
+/**
+  * \class PlantImageLicenseModel
+  * \brief This model holds the license info of all plant database images
+  *        and is used by the image license page of DatabaseSyncDialog.
+  *        The html of each entry is built on demand when the view requests
+  *        it, so large image lists don't need to be rendered at once.
+  * \author Giorgio Wicklein - GIOWISYS Software
+  * \date 19/10/2026
+  */
+
+#ifndef PLANTIMAGELICENSEMODEL_H
+#define PLANTIMAGELICENSEMODEL_H
+
+
+//-----------------------------------------------------------------------------
+// Headers
+//-----------------------------------------------------------------------------
+
+#include "../components/updatemanager.h"
+
+#include <QtCore/QAbstractListModel>
+
+
+//-----------------------------------------------------------------------------
+// Forward declarations
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// PlantImageLicenseModel
+//-----------------------------------------------------------------------------
+
+class PlantImageLicenseModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit PlantImageLicenseModel(const QString &filesDir, QObject *parent = 0);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+
+    /** Display role returns the html of the license entry */
+    QVariant data(const QModelIndex &index, int role) const;
+
+    /** Append the specified image metadata entries to the model */
+    void appendImages(const QList<UpdateManager::PlantImageMetadata*> &images);
+
+    /** Remove all entries */
+    void clear();
+
+private:
+    QString entryHtml(const UpdateManager::PlantImageMetadata &p) const;
+
+    QString m_filesDir;
+    QList<UpdateManager::PlantImageMetadata> m_images;
+};
+
+#endif // PLANTIMAGELICENSEMODEL_H
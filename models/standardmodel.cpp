@@ -12,6 +12,8 @@
 #include "../utils/metadatapropertiesparser.h"
 
 #include <QtSql/QSqlRecord>
+#include <QtSql/QSqlQuery>
+#include <QtCore/QStringList>
 
 
 //-----------------------------------------------------------------------------
@@ -20,7 +22,10 @@
 
 StandardModel::StandardModel(MetadataEngine *meta, QObject *parent) :
     QSqlTableModel(parent, DatabaseManager::getInstance().getDatabase()),
-    m_metadataEngine(meta)
+    m_metadataEngine(meta),
+    m_sortColumn(-1),
+    m_sortOrder(Qt::AscendingOrder),
+    m_recordCount(-1)
 {
     //save data to db immediately after change
     setEditStrategy(QSqlTableModel::OnFieldChange);
@@ -48,6 +53,17 @@ QVariant StandardModel::headerData(int section, Qt::Orientation orientation,
 
 void StandardModel::sort(int column, Qt::SortOrder order)
 {
+    //let metadata engine index often sorted columns
+    m_metadataEngine->registerFieldUsage(column, MetadataEngine::SortUsage);
+
+    m_sortColumn = column;
+    m_sortOrder = order;
+
+    //text is sorted by its sort keys, see MetadataEngine::createSortKey()
+    m_sortKeyTable.clear();
+    if (m_metadataEngine->hasSortKey(column))
+        m_sortKeyTable = m_metadataEngine->getSortKeyTableName(column);
+
     QSqlTableModel::sort(column, order);
 
     emit modelSortedSignal(column);
@@ -164,8 +180,16 @@ void StandardModel::duplicateRecord(int row)
     }*/
 }
 
+bool StandardModel::insertRows(int row, int count, const QModelIndex &parent)
+{
+    //insertRecord() inserts through this method, unlike fetchMore()
+    m_recordCount = -1;
+    return QSqlTableModel::insertRows(row, count, parent);
+}
+
 bool StandardModel::removeRows(int row, int count, const QModelIndex &parent)
 {
+    m_recordCount = -1;
     bool r = QSqlTableModel::removeRows(row, count, parent);
 
     if (r)
@@ -182,8 +206,163 @@ int StandardModel::realRowCount()
     return rowCount();
 }
 
+QItemSelection StandardModel::allRecordsSelection()
+{
+    int rows = realRowCount();
+    if (!rows)
+        return QItemSelection();
+
+    //first column is _id
+    return QItemSelection(index(0, 1), index(rows - 1, columnCount() - 1));
+}
+
 bool StandardModel::setData(const QModelIndex &index,
                             const QVariant &value, int role)
 {
     return QSqlTableModel::setData(index, value, role);
 }
+
+int StandardModel::recordCount()
+{
+    if (m_recordCount == -1) {
+        QSqlQuery query(database());
+        QString sql = QString("SELECT COUNT(*) FROM '%1'").arg(tableName());
+        if (!filter().isEmpty())
+            sql.append(" WHERE " + filter());
+        query.exec(sql);
+
+        m_recordCount = query.next() ? query.value(0).toInt() : 0;
+    }
+
+    return m_recordCount;
+}
+
+void StandardModel::setFilter(const QString &filter)
+{
+    m_recordCount = -1;
+    QSqlTableModel::setFilter(filter);
+}
+
+int StandardModel::findRecordRow(int recordId) const
+{
+    int rows = rowCount();
+    for (int i = 0; i < rows; i++) {
+        if (index(i, 0).data().toInt() == recordId)
+            return i;
+    }
+
+    return -1;
+}
+
+bool StandardModel::updateDateTime(int startRow, int endRow,
+                                   const QList<int> &columns,
+                                   const QDateTime &dateTime)
+{
+    if (columns.isEmpty() || (startRow < 0) ||
+            (startRow > endRow) || (endRow >= rowCount()))
+        return false;
+
+    //record ids of the range
+    QStringList ids;
+    for (int r = startRow; r <= endRow; r++) {
+        bool ok;
+        int id = index(r, 0).data().toInt(&ok);
+        if (ok)
+            ids.append(QString::number(id));
+    }
+    if (ids.isEmpty())
+        return false;
+
+    QSqlDatabase db = database();
+    QSqlQuery query(db);
+    bool success = true;
+    int firstColumn = columns.first();
+    int lastColumn = columns.first();
+
+    //one update for all records of each column
+    db.transaction();
+    foreach (int column, columns) {
+        query.prepare(QString("UPDATE '%1' SET \"%2\"=:date WHERE \"_id\" IN (%3)")
+                      .arg(tableName())
+                      .arg(m_metadataEngine->getFieldKey(column))
+                      .arg(ids.join(",")));
+        query.bindValue(":date", dateTime);
+        if (!query.exec()) {
+            success = false;
+            break;
+        }
+        firstColumn = qMin(firstColumn, column);
+        lastColumn = qMax(lastColumn, column);
+    }
+    if (!success) {
+        db.rollback();
+        return false;
+    }
+    db.commit();
+
+    //reload the cached rows, views are notified once below
+    blockSignals(true);
+    for (int r = startRow; r <= endRow; r++)
+        selectRow(r);
+    blockSignals(false);
+
+    emit dataChanged(index(startRow, firstColumn),
+                     index(endRow, lastColumn));
+
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+// Public slots
+//-----------------------------------------------------------------------------
+
+bool StandardModel::select()
+{
+    m_recordCount = -1;
+
+    //records are joined with their sort keys, so each one needs a key
+    if (!m_sortKeyTable.isEmpty())
+        m_metadataEngine->updateSortKeys(m_sortColumn);
+
+    return QSqlTableModel::select();
+}
+
+
+//-----------------------------------------------------------------------------
+// Protected
+//-----------------------------------------------------------------------------
+
+QString StandardModel::selectStatement() const
+{
+    if (m_sortKeyTable.isEmpty())
+        return QSqlTableModel::selectStatement();
+
+    //only the data columns, qualified because of the join
+    QString table = tableName();
+    QSqlRecord rec = database().record(table);
+    QStringList columns;
+    for (int i = 0; i < rec.count(); i++)
+        columns.append(QString("\"%1\".\"%2\"").arg(table).arg(rec.fieldName(i)));
+
+    QString statement = QString("SELECT %1 FROM \"%2\" JOIN \"%3\""
+                                " ON \"%3\".\"record_id\" = \"%2\".\"_id\"")
+            .arg(columns.join(","))
+            .arg(table)
+            .arg(m_sortKeyTable);
+    if (!filter().isEmpty())
+        statement.append(" WHERE ").append(filter());
+    statement.append(" ").append(orderByClause());
+
+    return statement;
+}
+
+QString StandardModel::orderByClause() const
+{
+    if (m_sortKeyTable.isEmpty())
+        return QSqlTableModel::orderByClause();
+
+    return QString("ORDER BY \"%1\".\"key\" %2")
+            .arg(m_sortKeyTable)
+            .arg((m_sortOrder == Qt::AscendingOrder) ? "ASC" : "DESC");
+}
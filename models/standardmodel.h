@@ -16,6 +16,8 @@
 //-----------------------------------------------------------------------------
 
 #include <QtSql/QSqlTableModel>
+#include <QtCore/QDateTime>
+#include <QtCore/QItemSelection>
 
 
 //-----------------------------------------------------------------------------
@@ -56,7 +58,13 @@ public:
     /** Duplicate the specified row */
     void duplicateRecord(int row);
 
-    /** Reimplemented to notify views that rows have been deleted (after deketion) */
+    /** Reimplemented to invalidate the cached record count */
+    bool insertRows(int row, int count, const QModelIndex &parent = QModelIndex());
+
+    /**
+     * Reimplemented to notify views that rows have been deleted (after deketion)
+     * and to invalidate the cached record count
+     */
     bool removeRows(int row, int count, const QModelIndex &parent);
 
     /**
@@ -67,9 +75,48 @@ public:
      */
     int realRowCount();
 
+    /**
+     * Return a selection of all records matching the current filter.
+     * All rows are fetched first, so records that were not loaded
+     * yet are selected too
+     */
+    QItemSelection allRecordsSelection();
+
     /** Reimplement to avoid edits on read only session */
     bool setData(const QModelIndex &index, const QVariant &value, int role);
 
+    /**
+     * Return the number of records matching the current filter.
+     * Unlike realRowCount() this doesn't fetch any rows, the count
+     * is queried from the database and cached until the next select()
+     */
+    int recordCount();
+
+    /** Reimplemented to invalidate the cached record count */
+    void setFilter(const QString &filter);
+
+    /**
+     * Return the row of the record with the specified _id.
+     * Only fetched rows are searched, so -1 is returned if
+     * the record is not loaded or not matching the filter
+     */
+    int findRecordRow(int recordId) const;
+
+    /**
+     * Set the date of the specified columns for all records in a row range,
+     * like modification dates after edits. Each column is written by a
+     * single UPDATE for all records, within one transaction, and
+     * dataChanged() is emitted once for the whole range
+     * @return false if the range is invalid or the update failed
+     */
+    bool updateDateTime(int startRow, int endRow,
+                        const QList<int> &columns,
+                        const QDateTime &dateTime);
+
+public slots:
+    /** Reimplemented to invalidate the cached record count */
+    bool select();
+
 signals:
     /** Emitted after a model sort operation */
     void modelSortedSignal(int column);
@@ -83,8 +130,25 @@ signals:
      */
     void rowsDeleted(int startRow, int count);
 
+protected:
+    /**
+     * Reimplemented to join the records with the sort keys of
+     * the sort column, if it is a text field
+     */
+    QString selectStatement() const;
+
+    /**
+     * Reimplemented to sort text fields by their sort keys,
+     * see MetadataEngine::createSortKey()
+     */
+    QString orderByClause() const;
+
 private:
     MetadataEngine *m_metadataEngine;
+    int m_sortColumn; /**< Current sort column, -1 if not sorted */
+    Qt::SortOrder m_sortOrder; /**< Current sort order */
+    QString m_sortKeyTable; /**< Sort key table of the sort column, if any */
+    int m_recordCount; /**< Cached record count, -1 if invalid */
 };
 
 #endif // STANDARDMODEL_H
@@ -0,0 +1,214 @@
+#-------------------------------------------------
+#
+# Application sources, shared by Passiflora.pro
+# and tests that need most of the application
+#
+#-------------------------------------------------
+
+# SQL profiling inside SQLite needs the SQLite C API,
+# so Qt must be built with -system-sqlite
+system_sqlite {
+    DEFINES += PASSIFLORA_SQL_TRACE
+    LIBS += -lsqlite3
+}
+
+
+SOURCES += \
+    $$PWD/widgets/mainwindow.cpp \
+    $$PWD/utils/definitionholder.cpp \
+    $$PWD/views/formview/formview.cpp \
+    $$PWD/components/formlayoutmatrix.cpp \
+    $$PWD/widgets/form_widgets/abstractformwidget.cpp \
+    $$PWD/widgets/form_widgets/testformwidget.cpp \
+    $$PWD/views/formview/droprectwidget.cpp \
+    $$PWD/views/formview/selectrectwidget.cpp \
+    $$PWD/views/formview/resizedotwidget.cpp \
+    $$PWD/widgets/viewtoolbarwidget.cpp \
+    $$PWD/widgets/searchlineedit.cpp \
+    $$PWD/widgets/dockwidget.cpp \
+    $$PWD/views/tableview/tableview.cpp \
+    $$PWD/components/metadataengine.cpp \
+    $$PWD/models/standardmodel.cpp \
+    $$PWD/models/testmodel.cpp \
+    $$PWD/models/collectionlistmodel.cpp \
+    $$PWD/components/databasemanager.cpp \
+    $$PWD/views/tableview/tableviewdelegate.cpp \
+    $$PWD/components/settingsmanager.cpp \
+    $$PWD/views/collectionlistview/collectionlistview.cpp \
+    $$PWD/widgets/form_widgets/textformwidget.cpp \
+    $$PWD/utils/platformcolorservice.cpp \
+    $$PWD/widgets/form_widgets/numberformwidget.cpp \
+    $$PWD/widgets/textarea.cpp \
+    $$PWD/utils/metadatapropertiesparser.cpp \
+    $$PWD/utils/formwidgetvalidator.cpp \
+    $$PWD/views/formview/emptyformwidget.cpp \
+    $$PWD/widgets/field_widgets/addfielddialog.cpp \
+    $$PWD/widgets/field_widgets/abstractfieldwizard.cpp \
+    $$PWD/widgets/field_widgets/textfieldwizard.cpp \
+    $$PWD/widgets/field_widgets/numberfieldwizard.cpp \
+    $$PWD/components/undocommands.cpp \
+    $$PWD/views/collectionlistview/collectionviewdelegate.cpp \
+    $$PWD/utils/formviewlayoutstate.cpp \
+    $$PWD/components/backupmanager.cpp \
+    $$PWD/components/filemanager.cpp \
+    $$PWD/utils/qtsingleapplication/qtsinglecoreapplication.cpp \
+    $$PWD/utils/qtsingleapplication/qtsingleapplication.cpp \
+    $$PWD/utils/qtsingleapplication/qtlockedfile.cpp \
+    $$PWD/utils/qtsingleapplication/qtlockedfile_win.cpp \
+    $$PWD/utils/qtsingleapplication/qtlockedfile_unix.cpp \
+    $$PWD/utils/qtsingleapplication/qtlocalpeer.cpp \
+    $$PWD/widgets/preferencesdialog.cpp \
+    $$PWD/widgets/backupdialog.cpp \
+    $$PWD/widgets/form_widgets/checkboxformwidget.cpp \
+    $$PWD/widgets/field_widgets/checkboxfieldwizard.cpp \
+    $$PWD/widgets/form_widgets/imageformwidget.cpp \
+    $$PWD/widgets/field_widgets/imagefieldwizard.cpp \
+    $$PWD/views/tableview/editors/imagetypeeditor.cpp \
+    $$PWD/components/updatemanager.cpp \
+    $$PWD/widgets/form_widgets/comboboxformwidget.cpp \
+    $$PWD/widgets/field_widgets/comboboxfieldwizard.cpp \
+    $$PWD/widgets/form_widgets/progressformwidget.cpp \
+    $$PWD/widgets/field_widgets/progressfieldwizard.cpp \
+    $$PWD/widgets/form_widgets/filesformwidget.cpp \
+    $$PWD/widgets/field_widgets/filesfieldwizard.cpp \
+    $$PWD/views/tableview/editors/filestypeeditor.cpp \
+    $$PWD/widgets/field_widgets/datefieldwizard.cpp \
+    $$PWD/widgets/form_widgets/dateformwidget.cpp \
+    $$PWD/widgets/field_widgets/creationdatefieldwizard.cpp \
+    $$PWD/widgets/form_widgets/creationdateformwidget.cpp \
+    $$PWD/widgets/field_widgets/moddatefieldwizard.cpp \
+    $$PWD/widgets/form_widgets/moddateformwidget.cpp \
+    $$PWD/utils/collectionfieldcleaner.cpp \
+    $$PWD/widgets/printdialog.cpp \
+    $$PWD/widgets/aboutdialog.cpp \
+    $$PWD/widgets/form_widgets/urlformwidget.cpp \
+    $$PWD/widgets/field_widgets/urlfieldwizard.cpp \
+    $$PWD/widgets/field_widgets/emailfieldwizard.cpp \
+    $$PWD/widgets/form_widgets/emailformwidget.cpp \
+    $$PWD/components/activationmanager.cpp \
+    $$PWD/widgets/activationdialog.cpp \
+    $$PWD/widgets/databasesyncdialog.cpp \
+    $$PWD/models/plantimagelicensemodel.cpp \
+    $$PWD/views/licenselistview/licenseviewdelegate.cpp \
+    $$PWD/components/filechangetracker.cpp \
+    $$PWD/components/printengine.cpp \
+    $$PWD/utils/searchcontext.cpp \
+    $$PWD/components/queryprofiler.cpp \
+    $$PWD/components/stallmonitor.cpp \
+    $$PWD/components/importmanager.cpp \
+    $$PWD/utils/csvparser.cpp \
+    $$PWD/widgets/importdialog.cpp \
+    $$PWD/components/exportmanager.cpp \
+    $$PWD/utils/fieldformatter.cpp
+
+HEADERS += \
+    $$PWD/widgets/mainwindow.h \
+    $$PWD/utils/definitionholder.h \
+    $$PWD/views/formview/formview.h \
+    $$PWD/components/formlayoutmatrix.h \
+    $$PWD/widgets/form_widgets/abstractformwidget.h \
+    $$PWD/widgets/form_widgets/testformwidget.h \
+    $$PWD/views/formview/droprectwidget.h \
+    $$PWD/views/formview/selectrectwidget.h \
+    $$PWD/views/formview/resizedotwidget.h \
+    $$PWD/widgets/viewtoolbarwidget.h \
+    $$PWD/widgets/searchlineedit.h \
+    $$PWD/widgets/dockwidget.h \
+    $$PWD/views/tableview/tableview.h \
+    $$PWD/components/metadataengine.h \
+    $$PWD/models/standardmodel.h \
+    $$PWD/models/testmodel.h \
+    $$PWD/models/collectionlistmodel.h \
+    $$PWD/components/databasemanager.h \
+    $$PWD/views/tableview/tableviewdelegate.h \
+    $$PWD/components/settingsmanager.h \
+    $$PWD/views/collectionlistview/collectionlistview.h \
+    $$PWD/widgets/form_widgets/textformwidget.h \
+    $$PWD/utils/platformcolorservice.h \
+    $$PWD/widgets/form_widgets/numberformwidget.h \
+    $$PWD/widgets/textarea.h \
+    $$PWD/utils/metadatapropertiesparser.h \
+    $$PWD/utils/formwidgetvalidator.h \
+    $$PWD/views/formview/emptyformwidget.h \
+    $$PWD/widgets/field_widgets/addfielddialog.h \
+    $$PWD/widgets/field_widgets/abstractfieldwizard.h \
+    $$PWD/widgets/field_widgets/textfieldwizard.h \
+    $$PWD/widgets/field_widgets/numberfieldwizard.h \
+    $$PWD/components/undocommands.h \
+    $$PWD/views/collectionlistview/collectionviewdelegate.h \
+    $$PWD/utils/formviewlayoutstate.h \
+    $$PWD/components/backupmanager.h \
+    $$PWD/components/filemanager.h \
+    $$PWD/utils/qtsingleapplication/qtsinglecoreapplication.h \
+    $$PWD/utils/qtsingleapplication/qtsingleapplication.h \
+    $$PWD/utils/qtsingleapplication/qtlockedfile.h \
+    $$PWD/utils/qtsingleapplication/qtlocalpeer.h \
+    $$PWD/widgets/preferencesdialog.h \
+    $$PWD/widgets/backupdialog.h \
+    $$PWD/widgets/form_widgets/checkboxformwidget.h \
+    $$PWD/widgets/field_widgets/checkboxfieldwizard.h \
+    $$PWD/widgets/form_widgets/imageformwidget.h \
+    $$PWD/widgets/field_widgets/imagefieldwizard.h \
+    $$PWD/views/tableview/editors/imagetypeeditor.h \
+    $$PWD/components/updatemanager.h \
+    $$PWD/widgets/form_widgets/comboboxformwidget.h \
+    $$PWD/widgets/field_widgets/comboboxfieldwizard.h \
+    $$PWD/widgets/form_widgets/progressformwidget.h \
+    $$PWD/widgets/field_widgets/progressfieldwizard.h \
+    $$PWD/widgets/form_widgets/filesformwidget.h \
+    $$PWD/widgets/field_widgets/filesfieldwizard.h \
+    $$PWD/views/tableview/editors/filestypeeditor.h \
+    $$PWD/widgets/field_widgets/datefieldwizard.h \
+    $$PWD/widgets/form_widgets/dateformwidget.h \
+    $$PWD/widgets/field_widgets/creationdatefieldwizard.h \
+    $$PWD/widgets/form_widgets/creationdateformwidget.h \
+    $$PWD/widgets/field_widgets/moddatefieldwizard.h \
+    $$PWD/widgets/form_widgets/moddateformwidget.h \
+    $$PWD/utils/collectionfieldcleaner.h \
+    $$PWD/widgets/printdialog.h \
+    $$PWD/widgets/aboutdialog.h \
+    $$PWD/widgets/form_widgets/urlformwidget.h \
+    $$PWD/widgets/field_widgets/urlfieldwizard.h \
+    $$PWD/widgets/field_widgets/emailfieldwizard.h \
+    $$PWD/widgets/form_widgets/emailformwidget.h \
+    $$PWD/components/activationmanager.h \
+    $$PWD/widgets/activationdialog.h \
+    $$PWD/widgets/databasesyncdialog.h \
+    $$PWD/models/plantimagelicensemodel.h \
+    $$PWD/views/licenselistview/licenseviewdelegate.h \
+    $$PWD/components/filechangetracker.h \
+    $$PWD/components/printengine.h \
+    $$PWD/utils/searchcontext.h \
+    $$PWD/components/queryprofiler.h \
+    $$PWD/components/stallmonitor.h \
+    $$PWD/components/importmanager.h \
+    $$PWD/utils/csvparser.h \
+    $$PWD/widgets/importdialog.h \
+    $$PWD/components/exportmanager.h \
+    $$PWD/utils/fieldformatter.h
+
+RESOURCES += \
+    $$PWD/resources/resources.qrc
+
+FORMS += \
+    $$PWD/ui/emptyformwidget.ui \
+    $$PWD/ui/textfieldwizard.ui \
+    $$PWD/ui/addfielddialog.ui \
+    $$PWD/ui/numberfieldwizard.ui \
+    $$PWD/ui/preferencesdialog.ui \
+    $$PWD/ui/backupdialog.ui \
+    $$PWD/ui/checkboxfieldwizard.ui \
+    $$PWD/ui/imagefieldwizard.ui \
+    $$PWD/ui/comboboxfieldwizard.ui \
+    $$PWD/ui/progressfieldwizard.ui \
+    $$PWD/ui/filesfieldwizard.ui \
+    $$PWD/ui/datefieldwizard.ui \
+    $$PWD/ui/creationdatefieldwizard.ui \
+    $$PWD/ui/moddatefieldwizard.ui \
+    $$PWD/ui/printdialog.ui \
+    $$PWD/ui/importdialog.ui \
+    $$PWD/ui/aboutdialog.ui \
+    $$PWD/ui/urlfieldwizard.ui \
+    $$PWD/ui/emailfieldwizard.ui \
+    $$PWD/ui/activationdialog.ui \
+    $$PWD/ui/databasesyncdialog.ui
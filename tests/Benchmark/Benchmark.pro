@@ -0,0 +1,45 @@
+#-------------------------------------------------
+#
+# Benchmarks for metadata, model and layout hot paths
+#
+#-------------------------------------------------
+
+QT       += core gui sql widgets testlib
+
+TARGET = tst_benchmarktest
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+
+SOURCES += tst_benchmarktest.cpp \
+    ../../components/databasemanager.cpp \
+    ../../components/queryprofiler.cpp \
+    ../../components/metadataengine.cpp \
+    ../../components/filemanager.cpp \
+    ../../components/filechangetracker.cpp \
+    ../../components/settingsmanager.cpp \
+    ../../components/formlayoutmatrix.cpp \
+    ../../utils/definitionholder.cpp \
+    ../../utils/metadatapropertiesparser.cpp \
+    ../../utils/searchcontext.cpp \
+    ../../models/standardmodel.cpp \
+    ../../widgets/form_widgets/abstractformwidget.cpp \
+    ../../widgets/form_widgets/testformwidget.cpp
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
+
+HEADERS += \
+    ../../components/databasemanager.h \
+    ../../components/queryprofiler.h \
+    ../../components/metadataengine.h \
+    ../../components/filemanager.h \
+    ../../components/filechangetracker.h \
+    ../../components/settingsmanager.h \
+    ../../components/formlayoutmatrix.h \
+    ../../utils/definitionholder.h \
+    ../../utils/metadatapropertiesparser.h \
+    ../../utils/searchcontext.h \
+    ../../models/standardmodel.h \
+    ../../widgets/form_widgets/abstractformwidget.h \
+    ../../widgets/form_widgets/testformwidget.h
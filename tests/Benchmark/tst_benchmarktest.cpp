@@ -0,0 +1,504 @@
+#include <QString>
+#include <QtTest>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QApplication>
+#include <QStandardPaths>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "../../components/metadataengine.h"
+#include "../../components/databasemanager.h"
+#include "../../components/formlayoutmatrix.h"
+#include "../../models/standardmodel.h"
+#include "../../utils/searchcontext.h"
+#include "../../widgets/form_widgets/testformwidget.h"
+
+/**
+ * Benchmarks run on a synthetic collection, its size can be set with:
+ *   PASSIFLORA_BENCH_ROWS   - record count (default 10000)
+ *   PASSIFLORA_BENCH_FIELDS - field count without _id (default 20)
+ *   PASSIFLORA_BENCH_TYPES  - comma separated MetadataEngine::FieldType
+ *                             values, assigned to fields in turn
+ *                             (default 1,2,3,6,11, text numeric date
+ *                             checkbox url)
+ * Results are printed by QtTest, use -csv or -o file,csv to store them.
+ * With -json file the results are also written as JSON, together with
+ * the collection size, so runs of different builds can be compared.
+ */
+class BenchmarkTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    BenchmarkTest();
+
+    /** Convert the QtTest CSV benchmark log to JSON, with collection size */
+    bool writeJsonResults(const QString &csvFile, const QString &jsonFile) const;
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void benchmarkFieldType();
+    void benchmarkFieldProperties();
+    void benchmarkModelSelect();
+    void benchmarkModelFetchAll();
+    void benchmarkModelSort_data();
+    void benchmarkModelSort();
+    void benchmarkSearchFilter_data();
+    void benchmarkSearchFilter();
+    void benchmarkFormLayoutAdd_data();
+    void benchmarkFormLayoutAdd();
+    void benchmarkDeleteField();
+    void benchmarkUpdateDateTime();
+
+private:
+    /** Create the synthetic collection and fill it with records */
+    void createCollection();
+
+    /** Get a synthetic value for the specified record and field type */
+    QVariant syntheticValue(int record, MetadataEngine::FieldType type) const;
+
+    /** Get the first column with the specified field type or -1 */
+    int findColumn(MetadataEngine::FieldType type) const;
+
+    /** Build the filter for the search key, as MainWindow::searchSlot() */
+    QString searchFilter(const QString &key) const;
+
+    static int envValue(const char *name, int defaultValue);
+
+    MetadataEngine *m_metadataEngine;
+    int m_rows;
+    int m_fields;
+    QList<MetadataEngine::FieldType> m_types;
+    int m_collectionId;
+    int m_originalCollectionId;
+};
+
+BenchmarkTest::BenchmarkTest() :
+    m_metadataEngine(0),
+    m_collectionId(0),
+    m_originalCollectionId(0)
+{
+    m_rows = envValue("PASSIFLORA_BENCH_ROWS", 10000);
+    m_fields = envValue("PASSIFLORA_BENCH_FIELDS", 20);
+
+    QString types = qgetenv("PASSIFLORA_BENCH_TYPES");
+    if (types.isEmpty())
+        types = "1,2,3,6,11";
+    foreach (const QString &s, types.split(',', QString::SkipEmptyParts)) {
+        int type = s.trimmed().toInt();
+        if ((type >= MetadataEngine::TextType) &&
+                (type <= MetadataEngine::EmailTextType))
+            m_types.append((MetadataEngine::FieldType) type);
+    }
+    if (m_types.isEmpty())
+        m_types.append(MetadataEngine::TextType);
+}
+
+void BenchmarkTest::initTestCase()
+{
+    DatabaseManager::getInstance();
+    m_metadataEngine = &MetadataEngine::getInstance();
+    m_originalCollectionId = m_metadataEngine->getCurrentCollectionId();
+
+    createCollection();
+    QVERIFY(m_collectionId != 0);
+    QVERIFY(m_metadataEngine->getFieldCount() == (m_fields + 1));
+}
+
+void BenchmarkTest::cleanupTestCase()
+{
+    if (!m_collectionId)
+        return;
+
+    m_metadataEngine->setCurrentCollectionId(m_originalCollectionId);
+    m_metadataEngine->deleteCollection(m_collectionId);
+
+    QSqlQuery query(DatabaseManager::getInstance().getDatabase());
+    query.prepare("DELETE FROM collections WHERE _id=:id");
+    query.bindValue(":id", m_collectionId);
+    query.exec();
+}
+
+void BenchmarkTest::benchmarkFieldType()
+{
+    int fieldCount = m_metadataEngine->getFieldCount();
+
+    QBENCHMARK {
+        for (int i = 1; i < fieldCount; i++)
+            m_metadataEngine->getFieldType(i);
+    }
+}
+
+void BenchmarkTest::benchmarkFieldProperties()
+{
+    int fieldCount = m_metadataEngine->getFieldCount();
+
+    QBENCHMARK {
+        for (int i = 1; i < fieldCount; i++) {
+            m_metadataEngine->getFieldProperties(MetadataEngine::DisplayProperty, i);
+            m_metadataEngine->getFieldProperties(MetadataEngine::EditProperty, i);
+        }
+    }
+}
+
+void BenchmarkTest::benchmarkModelSelect()
+{
+    StandardModel model(m_metadataEngine);
+    model.setTable(m_metadataEngine->getTableName(m_collectionId));
+
+    QBENCHMARK {
+        model.select();
+    }
+}
+
+void BenchmarkTest::benchmarkModelFetchAll()
+{
+    StandardModel model(m_metadataEngine);
+    model.setTable(m_metadataEngine->getTableName(m_collectionId));
+
+    QBENCHMARK {
+        model.select();
+        QVERIFY(model.realRowCount() == m_rows);
+    }
+}
+
+void BenchmarkTest::benchmarkModelSort_data()
+{
+    QTest::addColumn<int>("type");
+
+    QTest::newRow("text") << (int) MetadataEngine::TextType;
+    QTest::newRow("numeric") << (int) MetadataEngine::NumericType;
+    QTest::newRow("date") << (int) MetadataEngine::DateType;
+}
+
+void BenchmarkTest::benchmarkModelSort()
+{
+    QFETCH(int, type);
+
+    int column = findColumn((MetadataEngine::FieldType) type);
+    if (column == -1)
+        QSKIP("Field type not in PASSIFLORA_BENCH_TYPES");
+
+    StandardModel model(m_metadataEngine);
+    model.setTable(m_metadataEngine->getTableName(m_collectionId));
+    model.select();
+
+    //the first sorts create the field index, measure with it
+    model.sort(column, Qt::AscendingOrder);
+    model.sort(column, Qt::DescendingOrder);
+
+    Qt::SortOrder order = Qt::AscendingOrder;
+    QBENCHMARK {
+        model.sort(column, order);
+        order = (order == Qt::AscendingOrder) ? Qt::DescendingOrder
+                                              : Qt::AscendingOrder;
+    }
+}
+
+void BenchmarkTest::benchmarkSearchFilter_data()
+{
+    QTest::addColumn<QString>("key");
+
+    QTest::newRow("no match") << QString("zzzz");
+    QTest::newRow("one term") << QString("word42");
+    QTest::newRow("two terms") << QString("word42 lorem");
+}
+
+void BenchmarkTest::benchmarkSearchFilter()
+{
+    QFETCH(QString, key);
+
+    StandardModel model(m_metadataEngine);
+    model.setTable(m_metadataEngine->getTableName(m_collectionId));
+    QString filter = searchFilter(key);
+
+    //filter change, count for the status bar and first rows for the views
+    QBENCHMARK {
+        model.setFilter(filter);
+        model.select();
+        model.recordCount();
+    }
+}
+
+void BenchmarkTest::benchmarkFormLayoutAdd_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("100 widgets") << 100;
+    QTest::newRow("1000 widgets") << 1000;
+}
+
+void BenchmarkTest::benchmarkFormLayoutAdd()
+{
+    QFETCH(int, count);
+
+    //mixed sizes, so free space has to be searched
+    QList<TestFormWidget*> widgets;
+    for (int i = 0; i < count; i++) {
+        TestFormWidget *w = new TestFormWidget(0);
+        w->setWidthUnits((i % 3) + 1);
+        w->setHeightUnits((i % 2) + 1);
+        widgets.append(w);
+    }
+
+    QBENCHMARK {
+        FormLayoutMatrix matrix;
+        foreach (TestFormWidget *w, widgets)
+            matrix.addFormWidget(w);
+    }
+
+    qDeleteAll(widgets);
+}
+
+void BenchmarkTest::benchmarkDeleteField()
+{
+    //add a filled and indexed field
+    int column = m_metadataEngine->createField("Delete Me",
+                                               MetadataEngine::TextType,
+                                               "", "", "");
+    int fieldId = m_metadataEngine->getFieldKey(column);
+
+    QSqlDatabase db = DatabaseManager::getInstance().getDatabase();
+    QSqlQuery query(db);
+    query.exec(QString("UPDATE '%1' SET \"%2\"='value ' || _id")
+               .arg(m_metadataEngine->getTableName(m_collectionId))
+               .arg(fieldId));
+    m_metadataEngine->createFieldIndex(column);
+
+    int fieldCount = m_metadataEngine->getFieldCount();
+
+    QBENCHMARK_ONCE {
+        m_metadataEngine->deleteField(column);
+    }
+
+    QVERIFY(m_metadataEngine->getFieldCount() == (fieldCount - 1));
+    QVERIFY(m_metadataEngine->getFieldColumn(fieldId) == -1);
+}
+
+void BenchmarkTest::benchmarkUpdateDateTime()
+{
+    int column = findColumn(MetadataEngine::DateType);
+    if (column == -1)
+        QSKIP("Field type not in PASSIFLORA_BENCH_TYPES");
+
+    StandardModel model(m_metadataEngine);
+    model.setTable(m_metadataEngine->getTableName(m_collectionId));
+    model.select();
+
+    //modification dates after an edit of 100 rows
+    QList<int> columns;
+    columns << column;
+    QDateTime dateTime(QDate(2026, 10, 19), QTime(12, 0));
+
+    QBENCHMARK {
+        QVERIFY(model.updateDateTime(0, 99, columns, dateTime));
+    }
+
+    QVERIFY(model.index(0, column).data().toDateTime() == dateTime);
+    QVERIFY(model.index(99, column).data().toDateTime() == dateTime);
+}
+
+void BenchmarkTest::createCollection()
+{
+    QSqlDatabase db = DatabaseManager::getInstance().getDatabase();
+    QSqlQuery query(db);
+
+    //simulate new entry in collection list
+    query.exec("INSERT INTO \"collections\" (\"name\") VALUES (\"Benchmark\")");
+    m_collectionId = m_metadataEngine->createNewCollection();
+    m_metadataEngine->setCurrentCollectionId(m_collectionId);
+
+    QList<MetadataEngine::FieldType> fieldTypes;
+    for (int i = 0; i < m_fields; i++) {
+        MetadataEngine::FieldType type = m_types.at(i % m_types.size());
+        m_metadataEngine->createField(QString("Field %1").arg(i + 1), type,
+                                      "", "", "");
+        fieldTypes.append(type);
+    }
+
+    //insert records column by column with a single batch
+    QStringList columns;
+    QStringList placeholders;
+    for (int i = 1; i <= m_fields; i++) {
+        columns.append(QString("\"%1\"").arg(m_metadataEngine->getFieldKey(i)));
+        placeholders.append("?");
+    }
+
+    db.transaction();
+    query.prepare(QString("INSERT INTO '%1' (%2) VALUES (%3)")
+                  .arg(m_metadataEngine->getTableName(m_collectionId))
+                  .arg(columns.join(","))
+                  .arg(placeholders.join(",")));
+    foreach (MetadataEngine::FieldType type, fieldTypes) {
+        QVariantList values;
+        for (int r = 0; r < m_rows; r++)
+            values.append(syntheticValue(r, type));
+        query.addBindValue(values);
+    }
+    query.execBatch();
+    db.commit();
+}
+
+QVariant BenchmarkTest::syntheticValue(int record,
+                                       MetadataEngine::FieldType type) const
+{
+    switch (type) {
+    case MetadataEngine::TextType:
+        return QString("word%1 lorem ipsum %2").arg(record % 997).arg(record);
+    case MetadataEngine::URLTextType:
+        return QString("http://example.com/%1").arg(record);
+    case MetadataEngine::EmailTextType:
+        return QString("user%1@example.com").arg(record);
+    case MetadataEngine::NumericType:
+        return (record * 7919) % 100003;
+    case MetadataEngine::CheckboxType:
+        return record % 2;
+    case MetadataEngine::ComboboxType:
+        return record % 5;
+    case MetadataEngine::ProgressType:
+        return record % 101;
+    case MetadataEngine::DateType:
+    case MetadataEngine::CreationDateType:
+    case MetadataEngine::ModDateType:
+        return QDateTime(QDate(2000, 1, 1)).addSecs(record * 3607LL);
+    case MetadataEngine::ImageType:
+    case MetadataEngine::FilesType:
+    default:
+        return QVariant(); //no content files
+    }
+}
+
+int BenchmarkTest::findColumn(MetadataEngine::FieldType type) const
+{
+    int fieldCount = m_metadataEngine->getFieldCount();
+    for (int i = 1; i < fieldCount; i++) {
+        if (m_metadataEngine->getFieldType(i) == type)
+            return i;
+    }
+
+    return -1;
+}
+
+QString BenchmarkTest::searchFilter(const QString &key) const
+{
+    QList<int> searchFields;
+    int fieldCount = m_metadataEngine->getFieldCount();
+    for (int i = 1; i < fieldCount; i++) {
+        switch (m_metadataEngine->getFieldType(i)) {
+        case MetadataEngine::TextType:
+        case MetadataEngine::NumericType:
+        case MetadataEngine::URLTextType:
+        case MetadataEngine::EmailTextType:
+            searchFields.append(i);
+            break;
+        default:
+            break;
+        }
+    }
+
+    QStringList termFilters;
+    foreach (const QString &term, SearchContext(key).getTerms()) {
+        QStringList fieldFilters;
+        foreach (int field, searchFields) {
+            fieldFilters.append(QString("\"%1\" LIKE '%%2%'")
+                                .arg(m_metadataEngine->getFieldKey(field))
+                                .arg(term));
+        }
+        if (!fieldFilters.isEmpty())
+            termFilters.append("(" + fieldFilters.join(" OR ") + ")");
+    }
+
+    return termFilters.join(" AND ");
+}
+
+int BenchmarkTest::envValue(const char *name, int defaultValue)
+{
+    bool ok;
+    int value = qgetenv(name).toInt(&ok);
+
+    return (ok && (value > 0)) ? value : defaultValue;
+}
+
+bool BenchmarkTest::writeJsonResults(const QString &csvFile,
+                                     const QString &jsonFile) const
+{
+    QFile in(csvFile);
+    if (!in.open(QIODevice::ReadOnly | QIODevice::Text))
+        return false;
+
+    //"function","tag","metric",value,total,iterations
+    QRegExp line("^\"([^\"]*)\",\"([^\"]*)\",\"([^\"]*)\",([^,]+),([^,]+),(\\d+)$");
+    QJsonArray results;
+    while (!in.atEnd()) {
+        if (line.indexIn(QString::fromUtf8(in.readLine()).trimmed()) == -1)
+            continue;
+        QJsonObject result;
+        result.insert("function", line.cap(1));
+        result.insert("tag", line.cap(2));
+        result.insert("metric", line.cap(3));
+        result.insert("value", line.cap(4).toDouble());
+        result.insert("total", line.cap(5).toDouble());
+        result.insert("iterations", line.cap(6).toInt());
+        results.append(result);
+    }
+    in.close();
+    in.remove();
+
+    QJsonArray types;
+    foreach (MetadataEngine::FieldType type, m_types)
+        types.append((int) type);
+
+    QJsonObject root;
+    root.insert("rows", m_rows);
+    root.insert("fields", m_fields);
+    root.insert("types", types);
+    root.insert("results", results);
+
+    QFile out(jsonFile);
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    out.write(QJsonDocument(root).toJson());
+
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    //use a separate database, not the one of the user
+    QStandardPaths::setTestModeEnabled(true);
+
+    QApplication app(argc, argv);
+    app.setApplicationName("PassifloraBenchmark");
+
+    //-json file is handled here, the rest is passed to QtTest
+    QStringList args = app.arguments();
+    QString jsonFile;
+    QString csvFile;
+    int jsonArg = args.indexOf("-json");
+    if ((jsonArg != -1) && ((jsonArg + 1) < args.size())) {
+        jsonFile = args.at(jsonArg + 1);
+        args.removeAt(jsonArg);
+        args.removeAt(jsonArg);
+
+        //keep the plain text output if no other logger was requested
+        if (!args.contains("-o"))
+            args << "-o" << "-,txt";
+        csvFile = QDir::temp().filePath("passiflora_benchmark.csv");
+        args << "-o" << (csvFile + ",csv");
+    }
+
+    BenchmarkTest test;
+    int result = QTest::qExec(&test, args);
+
+    if (!jsonFile.isEmpty() && !test.writeJsonResults(csvFile, jsonFile)) {
+        qWarning("Failed to write %s", qPrintable(jsonFile));
+        result = 1;
+    }
+
+    return result;
+}
+
+#include "tst_benchmarktest.moc"
@@ -0,0 +1,23 @@
+#-------------------------------------------------
+#
+# Project created by QtCreator 2026-10-19T16:20:05
+#
+#-------------------------------------------------
+
+QT       += testlib
+
+QT       -= gui
+
+TARGET = tst_csvparsertest
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+
+SOURCES += tst_csvparsertest.cpp \
+    ../../utils/csvparser.cpp
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
+
+HEADERS += \
+    ../../utils/csvparser.h
@@ -0,0 +1,114 @@
+#include <QtCore/QString>
+#include <QtCore/QBuffer>
+#include <QtTest/QtTest>
+
+#include "../../utils/csvparser.h"
+
+class CsvParserTest : public QObject
+{
+    Q_OBJECT
+    
+public:
+    CsvParserTest();
+    
+private Q_SLOTS:
+    void testParseRow();
+    void testQuotedFields();
+    void testReadRows();
+    void testMultiLineField();
+    void testFormatRow();
+};
+
+CsvParserTest::CsvParserTest()
+{
+}
+
+void CsvParserTest::testParseRow()
+{
+    QStringList fields = CsvParser::parseRow("a,b,,d", ',');
+    QVERIFY(fields.size() == 4);
+    QVERIFY(fields.at(0) == "a");
+    QVERIFY(fields.at(2).isEmpty());
+    QVERIFY(fields.at(3) == "d");
+
+    fields = CsvParser::parseRow("1;2,5;x", ';');
+    QVERIFY(fields.size() == 3);
+    QVERIFY(fields.at(1) == "2,5");
+
+    fields = CsvParser::parseRow("a\tb c\t", '\t');
+    QVERIFY(fields.size() == 3);
+    QVERIFY(fields.at(1) == "b c");
+    QVERIFY(fields.at(2).isEmpty());
+}
+
+void CsvParserTest::testQuotedFields()
+{
+    QStringList fields = CsvParser::parseRow(
+                "\"Passiflora, incarnata\",\"say \"\"hi\"\"\",\"\"", ',');
+    QVERIFY(fields.size() == 3);
+    QVERIFY(fields.at(0) == "Passiflora, incarnata");
+    QVERIFY(fields.at(1) == "say \"hi\"");
+    QVERIFY(fields.at(2).isEmpty());
+}
+
+void CsvParserTest::testReadRows()
+{
+    QByteArray data("name,value\r\nrose,1\r\n\r\nlily,2\r\n");
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::ReadOnly);
+
+    CsvParser parser(&buffer, ',');
+    QStringList fields;
+
+    QVERIFY(parser.readRow(fields));
+    QVERIFY(fields == QStringList() << "name" << "value");
+    QVERIFY(parser.readRow(fields));
+    QVERIFY(fields == QStringList() << "rose" << "1");
+    QVERIFY(parser.readRow(fields)); //empty line skipped
+    QVERIFY(fields == QStringList() << "lily" << "2");
+    QVERIFY(!parser.readRow(fields));
+    QVERIFY(parser.rowCount() == 3);
+}
+
+void CsvParserTest::testMultiLineField()
+{
+    QByteArray data("1,\"first line\nsecond, line\",3\n4,5,6");
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::ReadOnly);
+
+    CsvParser parser(&buffer, ',', "UTF-8");
+    QStringList fields;
+
+    QVERIFY(parser.readRow(fields));
+    QVERIFY(fields.size() == 3);
+    QVERIFY(fields.at(1) == "first line\nsecond, line");
+    QVERIFY(fields.at(2) == "3");
+    QVERIFY(parser.readRow(fields));
+    QVERIFY(fields.at(0) == "4");
+    QVERIFY(!parser.readRow(fields));
+}
+
+void CsvParserTest::testFormatRow()
+{
+    QVERIFY(CsvParser::formatRow(QStringList() << "a" << "" << "b", ',')
+            == "a,,b");
+    QVERIFY(CsvParser::formatRow(QStringList() << "a,b" << "say \"hi\"", ',')
+            == "\"a,b\",\"say \"\"hi\"\"\"");
+    QVERIFY(CsvParser::formatRow(QStringList() << "a,b", ';') == "a,b");
+
+    //formatted rows read back to the same fields
+    QStringList row;
+    row << "Passiflora" << "first line\nsecond, line" << "\"quoted\"" << "";
+    QByteArray data = CsvParser::formatRow(row, ',').toUtf8() + "\n";
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::ReadOnly);
+
+    CsvParser parser(&buffer, ',');
+    QStringList fields;
+    QVERIFY(parser.readRow(fields));
+    QVERIFY(fields == row);
+}
+
+QTEST_APPLESS_MAIN(CsvParserTest)
+
+#include "tst_csvparsertest.moc"
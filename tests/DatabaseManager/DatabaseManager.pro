@@ -17,9 +17,11 @@ TEMPLATE = app
 
 SOURCES += tst_databasemanagertest.cpp \
     ../../components/databasemanager.cpp \
+    ../../components/queryprofiler.cpp \
     ../../utils/definitionholder.cpp
 DEFINES += SRCDIR=\\\"$$PWD/\\\"
 
 HEADERS += \
     ../../components/databasemanager.h \
+    ../../components/queryprofiler.h \
     ../../utils/definitionholder.h
@@ -4,6 +4,7 @@
 #include <QtSql/QSqlQuery>
 
 #include "../../components/databasemanager.h"
+#include "../../components/queryprofiler.h"
 
 class DatabaseManagerTest : public QObject
 {
@@ -18,6 +19,7 @@ private Q_SLOTS:
     void testOptimizeDatabaseSize();
     void testTruncateTable();
     void testGetDatabaseFileSize();
+    void testNormalizeSql();
 
 private:
     DatabaseManager *m_database;
@@ -78,6 +80,15 @@ void DatabaseManagerTest::testGetDatabaseFileSize()
     QVERIFY(size > 0);
 }
 
+void DatabaseManagerTest::testNormalizeSql()
+{
+    QCOMPARE(QueryProfiler::normalizeSql(
+                 "SELECT \"3\" FROM '5' WHERE _id=42 AND col2='it''s'"),
+             QString("SELECT \"3\" FROM ? WHERE _id=? AND col2=?"));
+    QCOMPARE(QueryProfiler::normalizeSql("UPDATE t SET v=1.5\n  WHERE x=7"),
+             QString("UPDATE t SET v=? WHERE x=?"));
+}
+
 QTEST_APPLESS_MAIN(DatabaseManagerTest)
 
 #include "tst_databasemanagertest.moc"
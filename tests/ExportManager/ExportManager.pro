@@ -0,0 +1,43 @@
+#-------------------------------------------------
+#
+# Project created by QtCreator 2026-10-19T20:14:52
+#
+#-------------------------------------------------
+
+QT       += core gui sql widgets testlib
+
+TARGET = tst_exportmanagertest
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+
+SOURCES += tst_exportmanagertest.cpp \
+    ../../components/exportmanager.cpp \
+    ../../components/databasemanager.cpp \
+    ../../components/queryprofiler.cpp \
+    ../../components/metadataengine.cpp \
+    ../../components/filemanager.cpp \
+    ../../components/filechangetracker.cpp \
+    ../../components/settingsmanager.cpp \
+    ../../utils/definitionholder.cpp \
+    ../../utils/metadatapropertiesparser.cpp \
+    ../../utils/csvparser.cpp \
+    ../../utils/fieldformatter.cpp \
+    ../../models/standardmodel.cpp
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
+
+HEADERS += \
+    ../../components/exportmanager.h \
+    ../../components/databasemanager.h \
+    ../../components/queryprofiler.h \
+    ../../components/metadataengine.h \
+    ../../components/filemanager.h \
+    ../../components/filechangetracker.h \
+    ../../components/settingsmanager.h \
+    ../../utils/definitionholder.h \
+    ../../utils/metadatapropertiesparser.h \
+    ../../utils/csvparser.h \
+    ../../utils/fieldformatter.h \
+    ../../models/standardmodel.h
@@ -0,0 +1,183 @@
+#include <QString>
+#include <QtTest>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "../../components/exportmanager.h"
+#include "../../components/metadataengine.h"
+#include "../../components/databasemanager.h"
+#include "../../utils/csvparser.h"
+
+class ExportManagerTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    ExportManagerTest();
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void testExportCsv();
+    void testExportJsonLines();
+    void testCancelExport();
+    void testCancelExportMidRun();
+
+private:
+    MetadataEngine *m_metadataEngine;
+    QTemporaryDir m_dir;
+    int m_collectionId;
+    int m_rows;
+};
+
+ExportManagerTest::ExportManagerTest() :
+    m_metadataEngine(0),
+    m_collectionId(0),
+    m_rows(100000) //enough rows for many progress steps
+{
+}
+
+void ExportManagerTest::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+
+    QSqlDatabase db = DatabaseManager::getInstance().getDatabase();
+    QSqlQuery query(db);
+    m_metadataEngine = &MetadataEngine::getInstance();
+
+    //simulate new entry in collection list
+    query.exec("INSERT INTO \"collections\" (\"name\") VALUES (\"Export\")");
+    m_collectionId = m_metadataEngine->createNewCollection();
+    QVERIFY(m_collectionId != 0);
+    m_metadataEngine->createField("Name", MetadataEngine::TextType,
+                                  "", "", "", m_collectionId);
+    m_metadataEngine->createField("Done", MetadataEngine::CheckboxType,
+                                  "", "", "", m_collectionId);
+
+    QVariantList names;
+    QVariantList done;
+    for (int r = 0; r < m_rows; r++) {
+        names.append(QString("plant %1, \"quoted\"").arg(r));
+        done.append(r % 2);
+    }
+
+    db.transaction();
+    query.prepare(QString("INSERT INTO '%1' (\"%2\",\"%3\") VALUES (?,?)")
+                  .arg(m_metadataEngine->getTableName(m_collectionId))
+                  .arg(m_metadataEngine->getFieldKey(1, m_collectionId))
+                  .arg(m_metadataEngine->getFieldKey(2, m_collectionId)));
+    query.addBindValue(names);
+    query.addBindValue(done);
+    QVERIFY(query.execBatch());
+    db.commit();
+}
+
+void ExportManagerTest::cleanupTestCase()
+{
+    if (!m_collectionId)
+        return;
+
+    m_metadataEngine->deleteCollection(m_collectionId);
+
+    QSqlQuery query(DatabaseManager::getInstance().getDatabase());
+    query.prepare("DELETE FROM collections WHERE _id=:id");
+    query.bindValue(":id", m_collectionId);
+    query.exec();
+}
+
+void ExportManagerTest::testExportCsv()
+{
+    QString fileName = m_dir.filePath("records.csv");
+    ExportManager manager;
+    QSignalSpy spy(&manager, SIGNAL(exportFinished()));
+
+    //restricted to the first 10 records
+    manager.startExport(fileName, m_collectionId, ExportTask::CsvFormat,
+                        QString("\"_id\" <= 10"));
+    QVERIFY(spy.wait(10000));
+    QVERIFY(manager.errorMessage().isEmpty());
+    QVERIFY(!manager.wasCanceled());
+    QVERIFY(manager.exportedRecordCount() == 10);
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    CsvParser parser(&file, ',');
+    QStringList fields;
+    QVERIFY(parser.readRow(fields));
+    QVERIFY(fields == QStringList() << "Name" << "Done");
+    QVERIFY(parser.readRow(fields));
+    QVERIFY(fields == QStringList() << "plant 0, \"quoted\"" << "0");
+    while (parser.readRow(fields)) {}
+    QVERIFY(parser.rowCount() == 11);
+}
+
+void ExportManagerTest::testExportJsonLines()
+{
+    QString fileName = m_dir.filePath("records.jsonl");
+    ExportManager manager;
+    QSignalSpy spy(&manager, SIGNAL(exportFinished()));
+
+    QList<int> recordIds;
+    recordIds << 2 << 3;
+    manager.startExport(fileName, m_collectionId,
+                        ExportTask::JsonLinesFormat, QString(), recordIds);
+    QVERIFY(spy.wait(10000));
+    QVERIFY(manager.exportedRecordCount() == 2);
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QJsonObject object = QJsonDocument::fromJson(file.readLine()).object();
+    QVERIFY(object.value("Name").toString() == "plant 1, \"quoted\"");
+    QVERIFY(object.value("Done").toBool() == true);
+}
+
+void ExportManagerTest::testCancelExport()
+{
+    QString fileName = m_dir.filePath("canceled.csv");
+    ExportManager manager;
+    QSignalSpy spy(&manager, SIGNAL(exportFinished()));
+
+    //cancel must not block the calling thread
+    manager.startExport(fileName, m_collectionId, ExportTask::CsvFormat);
+    manager.stopExportTask();
+    QVERIFY(spy.wait(10000));
+
+    QVERIFY(manager.wasCanceled());
+    QVERIFY(manager.exportedRecordCount() == 0);
+    QVERIFY(!QFile::exists(fileName)); //partial file removed
+}
+
+void ExportManagerTest::testCancelExportMidRun()
+{
+    QString fileName = m_dir.filePath("canceled_mid_run.csv");
+    ExportManager manager;
+    QSignalSpy spy(&manager, SIGNAL(exportFinished()));
+    QSignalSpy progressSpy(&manager, SIGNAL(progressSignal(int)));
+
+    //cancel on the first progress step, as the progress dialog does
+    connect(&manager, SIGNAL(progressSignal(int)),
+            &manager, SLOT(stopExportTask()));
+
+    manager.startExport(fileName, m_collectionId, ExportTask::CsvFormat);
+    QVERIFY(spy.wait(30000));
+
+    QVERIFY(progressSpy.count() > 0);
+    QVERIFY(manager.wasCanceled());
+    QVERIFY(!QFile::exists(fileName));
+
+    //the manager can be reused after a cancel
+    disconnect(&manager, SIGNAL(progressSignal(int)),
+               &manager, SLOT(stopExportTask()));
+    manager.startExport(fileName, m_collectionId, ExportTask::CsvFormat,
+                        QString("\"_id\" <= 5"));
+    QVERIFY(spy.wait(10000));
+    QVERIFY(!manager.wasCanceled());
+    QVERIFY(manager.exportedRecordCount() == 5);
+}
+
+QTEST_MAIN(ExportManagerTest)
+
+#include "tst_exportmanagertest.moc"
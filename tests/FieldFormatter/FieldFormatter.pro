@@ -0,0 +1,25 @@
+#-------------------------------------------------
+#
+# Project created by QtCreator 2026-10-19T18:02:41
+#
+#-------------------------------------------------
+
+QT       += testlib
+
+QT       -= gui
+
+TARGET = tst_fieldformattertest
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+
+SOURCES += tst_fieldformattertest.cpp \
+    ../../utils/fieldformatter.cpp \
+    ../../utils/metadatapropertiesparser.cpp
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
+
+HEADERS += \
+    ../../utils/fieldformatter.h \
+    ../../utils/metadatapropertiesparser.h
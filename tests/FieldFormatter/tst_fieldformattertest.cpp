@@ -0,0 +1,109 @@
+#include <QtCore/QString>
+#include <QtCore/QDateTime>
+#include <QtCore/QLocale>
+#include <QtTest/QtTest>
+
+#include "../../utils/fieldformatter.h"
+
+class FieldFormatterTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    FieldFormatterTest();
+
+private Q_SLOTS:
+    void testNumeric();
+    void testDate();
+    void testCombobox();
+    void testCheckboxAndProgress();
+    void testFiles();
+    void testEmpty();
+    void testPropertyParsing();
+};
+
+FieldFormatterTest::FieldFormatterTest()
+{
+}
+
+void FieldFormatterTest::testNumeric()
+{
+    FieldFormatter autoMode("displayMode:auto;precision:2;",
+                            MetadataEngine::NumericType);
+    QVERIFY(autoMode.format(QVariant(3.5)) == "3.5");
+
+    FieldFormatter decimal("displayMode:decimal;precision:2;",
+                           MetadataEngine::NumericType);
+    QVERIFY(decimal.format(QVariant(3.14159)) == "3.14");
+    QVERIFY(decimal.format(QVariant("2")) == "2.00");
+}
+
+void FieldFormatterTest::testDate()
+{
+    QDateTime d(QDate(2026, 10, 19), QTime(8, 30));
+
+    FieldFormatter iso("dateFormat:5;", MetadataEngine::DateType);
+    QVERIFY(iso.format(QVariant(d)) == "2026-10-19 08:30");
+
+    FieldFormatter isoDate("dateFormat:6;", MetadataEngine::ModDateType);
+    QVERIFY(isoDate.format(QVariant(d.toString(Qt::ISODate))) == "2026-10-19");
+}
+
+void FieldFormatterTest::testCombobox()
+{
+    FieldFormatter f("items:red,blue\\comma green,yellow;default:2;",
+                     MetadataEngine::ComboboxType);
+    QVERIFY(f.format(QVariant(0)) == "red");
+    QVERIFY(f.format(QVariant(1)) == "blue, green");
+    QVERIFY(f.format(QVariant("")) == "yellow"); //default item
+    QVERIFY(f.format(QVariant(5)).isEmpty());
+}
+
+void FieldFormatterTest::testCheckboxAndProgress()
+{
+    FieldFormatter checkbox("", MetadataEngine::CheckboxType);
+    QVERIFY(checkbox.format(QVariant(1)) == "1");
+    QVERIFY(checkbox.format(QVariant(0)) == "0");
+
+    FieldFormatter progress("", MetadataEngine::ProgressType);
+    QVERIFY(progress.format(QVariant("42")) == "42");
+}
+
+void FieldFormatterTest::testFiles()
+{
+    QHash<int,QString> fileNames;
+    fileNames.insert(3, "leaf.jpg");
+    fileNames.insert(7, "notes.pdf");
+
+    FieldFormatter f("", MetadataEngine::FilesType, fileNames);
+    QVERIFY(f.format(QVariant("3,7")) == "leaf.jpg, notes.pdf");
+    QVERIFY(f.format(QVariant("9")) == "9"); //unknown id
+}
+
+void FieldFormatterTest::testEmpty()
+{
+    FieldFormatter text("", MetadataEngine::TextType);
+    QVERIFY(text.format(QVariant()).isEmpty());
+    QVERIFY(text.format(QVariant("Passiflora")) == "Passiflora");
+
+    FieldFormatter numeric("displayMode:decimal;precision:1;",
+                           MetadataEngine::NumericType);
+    QVERIFY(numeric.format(QVariant("")).isEmpty());
+}
+
+void FieldFormatterTest::testPropertyParsing()
+{
+    QVERIFY(FieldFormatter::dateFormat("4") == "ddd MMM d yyyy");
+    QVERIFY(FieldFormatter::dateFormat("") ==
+            QLocale().dateTimeFormat(QLocale::ShortFormat));
+
+    QStringList items = FieldFormatter::comboboxItems(
+                "a\\doublequoteb\\doublequote,c\\commad,");
+    QVERIFY(items.size() == 2);
+    QVERIFY(items.at(0) == "a\"b\"");
+    QVERIFY(items.at(1) == "c,d");
+}
+
+QTEST_APPLESS_MAIN(FieldFormatterTest)
+
+#include "tst_fieldformattertest.moc"
@@ -31,6 +31,7 @@ private Q_SLOTS:
     void testRemoveWidget1();
     void testRemoveWidget2();
     void testFindIndex();
+    void testFindIndexAfterSimplify();
     void testSimplifyMatrix1();
     void testSimplifyMatrix2();
     void testFormWidgetMovement1();
@@ -44,6 +45,8 @@ private Q_SLOTS:
     void testFormWidgetResize1();
     void testFormWidgetResize2();
     void testFormWidgetResize3();
+    void testSnapshotResize();
+    void testGrowMatrix();
     void testCopyConstructor();
     void testComparisonOperator();
 };
@@ -443,6 +446,39 @@ void FormLayoutMatrixTest::testFindIndex()
     QVERIFY(!f.findFormWidgetIndex(NULL, row, column));
 }
 
+void FormLayoutMatrixTest::testFindIndexAfterSimplify()
+{
+    //test that owner and index lookups follow the widgets
+    //when empty rows and columns are removed
+    FormLayoutMatrix f;
+
+    TestFormWidget a(0);
+    TestFormWidget b(0);
+
+    a.setWidthUnits(2);
+    a.setHeightUnits(2);
+
+    f.setFormWidget(&a, 2, 3);
+    f.setFormWidget(&b, 5, 6);
+    f.simplifyMatrix();
+
+    QVERIFY(f.rowCount() == 3);
+    QVERIFY(f.columnCount() == 3);
+
+    int row, column;
+    QVERIFY(f.findFormWidgetIndex(&a, row, column));
+    QVERIFY(row == 0);
+    QVERIFY(column == 0);
+    QVERIFY(f.findFormWidgetIndex(&b, row, column));
+    QVERIFY(row == 2);
+    QVERIFY(column == 2);
+    QVERIFY(f.getFormWidgetByExtended(1, 1) == &a);
+
+    f.removeFormWidget(0, 0);
+    QVERIFY(!f.findFormWidgetIndex(&a, row, column));
+    QVERIFY(f.getFormWidgetByExtended(1, 1) == NULL);
+}
+
 void FormLayoutMatrixTest::testSimplifyMatrix1()
 {
     //simple test with many empty rows columns before a FW
@@ -802,6 +838,80 @@ void FormLayoutMatrixTest::testFormWidgetResize3()
     QVERIFY(a.getHeightUnits() == 2);
 }
 
+void FormLayoutMatrixTest::testSnapshotResize()
+{
+    //test that a layout change solved on a copy
+    //leaves the form widgets and the original untouched
+    FormLayoutMatrix f;
+
+    TestFormWidget a(0);
+    TestFormWidget b(0);
+
+    f.setFormWidget(&a, 0, 0);
+    f.setFormWidget(&b, 0, 1);
+
+    FormLayoutMatrix snapshot(f);
+    snapshot.formWidgetResize(&a, 2, 1, false);
+
+    QVERIFY(a.getWidthUnits() == 1);
+    QVERIFY(f.getWidthUnits(&a) == 1);
+    QVERIFY(f[0][1] == &b);
+
+    QVERIFY(snapshot.getWidthUnits(&a) == 2);
+    QVERIFY(snapshot.getHeightUnits(&a) == 1);
+    QVERIFY(snapshot[0][0] == &a);
+    QVERIFY(snapshot[0][1] == (FormWidget*)FormLayoutMatrix::EXTENDED_FORM_WIDGET);
+    QVERIFY(snapshot[1][0] == &b);
+}
+
+void FormLayoutMatrixTest::testGrowMatrix()
+{
+    //rows are appended in place, columns remap the grid
+    FormLayoutMatrix f;
+    int row, column;
+
+    TestFormWidget a(0);
+    a.setWidthUnits(2);
+    a.setHeightUnits(2);
+    f.setFormWidget(&a, 0, 0);
+
+    TestFormWidget b(0);
+    f.setFormWidget(&b, 5, 1);
+    QVERIFY(f.rowCount() == 6);
+    QVERIFY(f.columnCount() == 2);
+    QVERIFY(f.getFormWidgetByExtended(1, 1) == &a);
+
+    TestFormWidget c(0);
+    c.setWidthUnits(1);
+    c.setHeightUnits(2);
+    f.setFormWidget(&c, 2, 4);
+    QVERIFY(f.rowCount() == 6);
+    QVERIFY(f.columnCount() == 5);
+    QVERIFY(f.getFormWidgetByExtended(1, 1) == &a);
+    QVERIFY(f.getFormWidgetByExtended(3, 4) == &c);
+    QVERIFY(f.getFormWidget(5, 1) == &b);
+    QVERIFY(f.findFormWidgetIndex(&b, row, column));
+    QVERIFY((row == 5) && (column == 1));
+
+    //full width widgets, the first fits in the empty row 4,
+    //each other one needs a new row
+    QList<TestFormWidget*> widgets;
+    for (int i = 0; i < 50; i++) {
+        TestFormWidget *w = new TestFormWidget(0);
+        w->setWidthUnits(5);
+        widgets.append(w);
+        f.addFormWidget(w);
+    }
+    QVERIFY(f.rowCount() == 55);
+    QVERIFY(f.findFormWidgetIndex(widgets.first(), row, column));
+    QVERIFY((row == 4) && (column == 0));
+    QVERIFY(f.findFormWidgetIndex(widgets.last(), row, column));
+    QVERIFY((row == 54) && (column == 0));
+    QVERIFY(f.getFormWidgetByExtended(54, 4) == widgets.last());
+    QVERIFY(f.getFormWidgetByExtended(1, 1) == &a);
+    qDeleteAll(widgets);
+}
+
 void FormLayoutMatrixTest::testCopyConstructor()
 {
     TestFormWidget a(0);
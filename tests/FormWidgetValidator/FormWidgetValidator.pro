@@ -18,6 +18,7 @@ TEMPLATE = app
 SOURCES += tst_formwidgetvalidatortest.cpp \
     ../../components/metadataengine.cpp \
     ../../components/databasemanager.cpp \
+    ../../components/queryprofiler.cpp \
     ../../models/standardmodel.cpp \
     ../../utils/formwidgetvalidator.cpp \
     ../../utils/metadatapropertiesparser.cpp \
@@ -27,6 +28,7 @@ DEFINES += SRCDIR=\\\"$$PWD/\\\"
 HEADERS += \
     ../../components/metadataengine.h \
     ../../components/databasemanager.h \
+    ../../components/queryprofiler.h \
     ../../models/standardmodel.h \
     ../../utils/formwidgetvalidator.h \
     ../../utils/metadatapropertiesparser.h \
@@ -15,10 +15,12 @@ TEMPLATE = app
 
 SOURCES += tst_metadataenginetest.cpp \
     ../../components/databasemanager.cpp \
+    ../../components/queryprofiler.cpp \
     ../../components/metadataengine.cpp \
     ../../utils/definitionholder.cpp \
     ../../models/standardmodel.cpp \
     ../../components/filemanager.cpp \
+    ../../components/filechangetracker.cpp \
     ../../utils/metadatapropertiesparser.cpp \
     ../../components/alarmmanager.cpp \
     ../../components/settingsmanager.cpp \
@@ -27,10 +29,12 @@ DEFINES += SRCDIR=\\\"$$PWD/\\\"
 
 HEADERS += \
     ../../components/databasemanager.h \
+    ../../components/queryprofiler.h \
     ../../components/metadataengine.h \
     ../../utils/definitionholder.h \
     ../../models/standardmodel.h \
     ../../components/filemanager.h \
+    ../../components/filechangetracker.h \
     ../../utils/metadatapropertiesparser.h \
     ../../components/alarmmanager.h \
     ../../components/settingsmanager.h \
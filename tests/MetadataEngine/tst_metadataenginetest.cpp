@@ -16,6 +16,7 @@ public:
 private Q_SLOTS:
     void testCollectionId();
     void testCollectionName();
+    void testCollectionCache();
     void testFieldName();
     void testFieldCount();
     void testFieldType();
@@ -26,11 +27,17 @@ private Q_SLOTS:
     void testCreateCollection();
     void testDeleteCollection();
     void testCreateField();
+    void testFieldIndex();
     void testDeleteField();
     void testModifyField();
     void testFileMetadata();
+    void testDatabaseSwap();
 
 private:
+    /** Rename the tables of a collection in the closed database file */
+    void renameCollectionTables(int collectionId, const QString &from,
+                                const QString &to);
+
     MetadataEngine *m_metadataEngine;
     DatabaseManager *m_databaseManager;
 };
@@ -79,6 +86,36 @@ void MetadataEngineTest::testCollectionName()
     QVERIFY(defaultCollectionName == getCollectionName);
 }
 
+void MetadataEngineTest::testCollectionCache()
+{
+    int id = m_metadataEngine->getCurrentCollectionId();
+    QString name = m_metadataEngine->getCollectionName(id);
+    QString tableName = m_metadataEngine->getTableName(id);
+    QVERIFY(!tableName.isEmpty());
+    QVERIFY(m_metadataEngine->getCollectionType(id) ==
+            MetadataEngine::StandardCollection);
+
+    //rename outside of metadata engine, like CollectionListModel
+    QSqlQuery query(m_databaseManager->getDatabase());
+    query.prepare("UPDATE collections SET name=:name WHERE _id=:id");
+    query.bindValue(":name", "Renamed");
+    query.bindValue(":id", id);
+    query.exec();
+    m_metadataEngine->setDirtyCollectionCache(id);
+    QVERIFY(m_metadataEngine->getCollectionName(id) == "Renamed");
+    QVERIFY(m_metadataEngine->getTableName(id) == tableName);
+
+    //restore original name
+    query.bindValue(":name", name);
+    query.bindValue(":id", id);
+    query.exec();
+    m_metadataEngine->setDirtyCollectionCache();
+    QVERIFY(m_metadataEngine->getCollectionName(id) == name);
+
+    QVERIFY("_invalid_table_name_" == m_metadataEngine->getTableName(9999));
+    QVERIFY("_collection_invalid_" == m_metadataEngine->getCollectionName(9999));
+}
+
 void MetadataEngineTest::testFieldName()
 {
     QString originalName, newName, exampleName;
@@ -323,6 +360,41 @@ void MetadataEngineTest::testCreateField()
                                                  fieldId));
 }
 
+void MetadataEngineTest::testFieldIndex()
+{
+    QSqlQuery query(m_databaseManager->getDatabase());
+    QString tableName = m_metadataEngine->getTableName(
+                m_metadataEngine->getCurrentCollectionId());
+    int fieldId = 4; //Test Field
+    QString indexSql = QString("SELECT name FROM sqlite_master WHERE type='index'"
+                               " AND tbl_name='%1'").arg(tableName);
+
+    QVERIFY(!m_metadataEngine->hasFieldIndex(fieldId));
+
+    m_metadataEngine->createFieldIndex(fieldId);
+    QVERIFY(m_metadataEngine->hasFieldIndex(fieldId));
+    query.exec(indexSql);
+    QVERIFY(query.next());
+
+    m_metadataEngine->dropFieldIndex(fieldId);
+    QVERIFY(!m_metadataEngine->hasFieldIndex(fieldId));
+    query.exec(indexSql);
+    QVERIFY(!query.next());
+
+    //often sorted fields get an index, once fields are idle
+    m_metadataEngine->registerFieldUsage(1, MetadataEngine::SortUsage);
+    m_metadataEngine->registerFieldUsage(1, MetadataEngine::SortUsage);
+    QVERIFY(!m_metadataEngine->hasFieldIndex(1));
+    m_metadataEngine->createPendingFieldIndexes();
+    QVERIFY(m_metadataEngine->hasFieldIndex(1));
+
+    //_id is never indexed
+    m_metadataEngine->registerFieldUsage(0, MetadataEngine::SortUsage);
+    m_metadataEngine->registerFieldUsage(0, MetadataEngine::SortUsage);
+    m_metadataEngine->createPendingFieldIndexes();
+    QVERIFY(!m_metadataEngine->hasFieldIndex(0));
+}
+
 void MetadataEngineTest::testDeleteField()
 {
     QString fieldName2 = "Test2";
@@ -336,11 +408,18 @@ void MetadataEngineTest::testDeleteField()
     QString fieldName("Test Field");
     int fieldId = 4; //hard coded I know :P
     int fieldCount = m_metadataEngine->getFieldCount();
+    int deletedId = m_metadataEngine->getFieldKey(fieldId);
+    int test2Id = m_metadataEngine->getFieldKey(fieldId2);
 
     //delete Test Field
     m_metadataEngine->deleteField(fieldId);
 
     QVERIFY(m_metadataEngine->getFieldCount() == (fieldCount - 1));
+
+    //following fields move one column back but keep their id
+    QVERIFY(m_metadataEngine->getFieldColumn(deletedId) == -1);
+    QVERIFY(m_metadataEngine->getFieldColumn(test2Id) == (fieldId2 - 1));
+    QVERIFY(m_metadataEngine->getFieldKey(fieldId2 - 1) == test2Id);
     QVERIFY(fieldName2 == m_metadataEngine->getFieldName(fieldId));
     QVERIFY(m_metadataEngine->getFieldProperties(MetadataEngine::DisplayProperty,
                                                  fieldId).isEmpty());
@@ -349,6 +428,15 @@ void MetadataEngineTest::testDeleteField()
     QVERIFY(m_metadataEngine->getFieldProperties(MetadataEngine::TriggerProperty,
                                                  fieldId).isEmpty());
 
+    //indexes of other fields are kept, text fields are indexed
+    //in their sort key table
+    QVERIFY(m_metadataEngine->hasFieldIndex(1));
+    QSqlQuery query(m_databaseManager->getDatabase());
+    query.exec(QString("SELECT name FROM sqlite_master WHERE type='index'"
+                       " AND tbl_name GLOB '%1*'").arg(m_metadataEngine->getTableName(
+                                                           m_metadataEngine->getCurrentCollectionId())));
+    QVERIFY(query.next());
+
     //delete Test2
     m_metadataEngine->deleteField(fieldId);
 
@@ -360,6 +448,14 @@ void MetadataEngineTest::testDeleteField()
                                                  fieldId).isEmpty());
     QVERIFY(m_metadataEngine->getFieldProperties(MetadataEngine::TriggerProperty,
                                                  fieldId).isEmpty());
+
+    //keys of deleted fields are not reused
+    int newColumn = m_metadataEngine->createField(fieldName2, type2, "", "", "");
+    int newKey = m_metadataEngine->getFieldKey(newColumn);
+    QVERIFY(newKey > deletedId);
+    QVERIFY(newKey > test2Id);
+    m_metadataEngine->deleteField(newColumn);
+    QVERIFY(m_metadataEngine->getFieldCount() == (fieldCount - 2));
 }
 
 void MetadataEngineTest::testModifyField()
@@ -454,6 +550,54 @@ void MetadataEngineTest::testFileMetadata()
     QVERIFY(map.value(y) == b);
 }
 
+void MetadataEngineTest::testDatabaseSwap()
+{
+    int id = m_metadataEngine->getCurrentCollectionId();
+    QString tableName = m_metadataEngine->getTableName(id);
+    int fieldCount = m_metadataEngine->getFieldCount(id);
+    QString swappedName = tableName + "swap";
+
+    //replace the database while running, like a plant database update
+    renameCollectionTables(id, tableName, swappedName);
+    m_metadataEngine->setDirtyCurrentColleectionId();
+
+    QVERIFY(m_metadataEngine->getCurrentCollectionId() == id);
+    QVERIFY(m_metadataEngine->getTableName(id) == swappedName);
+    QVERIFY(m_metadataEngine->getFieldCount(id) == fieldCount);
+
+    //restore original database
+    renameCollectionTables(id, swappedName, tableName);
+    m_metadataEngine->setDirtyCurrentColleectionId();
+    QVERIFY(m_metadataEngine->getTableName(id) == tableName);
+}
+
+void MetadataEngineTest::renameCollectionTables(int collectionId,
+                                                const QString &from,
+                                                const QString &to)
+{
+    QString path = m_databaseManager->getDatabasePath();
+    DatabaseManager::destroy(); //close db connection
+
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "swap");
+        db.setDatabaseName(path);
+        QVERIFY(db.open());
+
+        QSqlQuery query(db);
+        query.exec(QString("ALTER TABLE '%1' RENAME TO '%2'").arg(from).arg(to));
+        query.exec(QString("ALTER TABLE '%1_metadata' RENAME TO '%2_metadata'")
+                   .arg(from).arg(to));
+        query.prepare("UPDATE collections SET table_name=:name WHERE _id=:id");
+        query.bindValue(":name", to);
+        query.bindValue(":id", collectionId);
+        query.exec();
+        db.close();
+    }
+    QSqlDatabase::removeDatabase("swap");
+
+    m_databaseManager = &DatabaseManager::getInstance(); //open db
+}
+
 QTEST_APPLESS_MAIN(MetadataEngineTest)
 
 #include "tst_metadataenginetest.moc"
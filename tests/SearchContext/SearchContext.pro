@@ -0,0 +1,23 @@
+#-------------------------------------------------
+#
+# Project created by QtCreator 2026-10-19T10:12:41
+#
+#-------------------------------------------------
+
+QT       += testlib
+
+QT       -= gui
+
+TARGET = tst_searchcontexttest
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+
+SOURCES += tst_searchcontexttest.cpp \
+    ../../utils/searchcontext.cpp
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
+
+HEADERS += \
+    ../../utils/searchcontext.h
@@ -0,0 +1,69 @@
+#include <QtCore/QString>
+#include <QtTest/QtTest>
+
+#include "../../utils/searchcontext.h"
+
+class SearchContextTest : public QObject
+{
+    Q_OBJECT
+    
+public:
+    SearchContextTest();
+    
+private Q_SLOTS:
+    void testTerms();
+    void testMatches();
+    void testFindMatches();
+};
+
+SearchContextTest::SearchContextTest()
+{
+}
+
+void SearchContextTest::testTerms()
+{
+    SearchContext empty;
+    QVERIFY(!empty.isActive());
+    QVERIFY(empty.getTerms().isEmpty());
+
+    SearchContext blank("   ");
+    QVERIFY(!blank.isActive());
+
+    SearchContext context("  Passiflora  incarnata passiflora");
+    QVERIFY(context.isActive());
+    QVERIFY(context.getTerms().size() == 3);
+    QVERIFY(context.getTerms().at(0) == "Passiflora");
+    QVERIFY(context.getTerms().at(1) == "incarnata");
+}
+
+void SearchContextTest::testMatches()
+{
+    SearchContext context("flora INCARN");
+    QVERIFY(context.matches("Passiflora"));
+    QVERIFY(context.matches("incarnata"));
+    QVERIFY(!context.matches("Melissa officinalis"));
+    QVERIFY(!SearchContext().matches("Passiflora"));
+}
+
+void SearchContextTest::testFindMatches()
+{
+    SearchContext context("ss flora");
+    QList<SearchContext::Match> matches =
+            context.findMatches("Passiflora, Melissa");
+    QVERIFY(matches.size() == 3);
+    QVERIFY((matches.at(0).position == 2) && (matches.at(0).length == 2));
+    QVERIFY((matches.at(1).position == 5) && (matches.at(1).length == 5));
+    QVERIFY((matches.at(2).position == 16) && (matches.at(2).length == 2));
+
+    //overlapping terms are merged
+    SearchContext overlap("passi ssiflo");
+    matches = overlap.findMatches("Passiflora");
+    QVERIFY(matches.size() == 1);
+    QVERIFY((matches.at(0).position == 0) && (matches.at(0).length == 8));
+
+    QVERIFY(context.findMatches("Hypericum").isEmpty());
+}
+
+QTEST_APPLESS_MAIN(SearchContextTest)
+
+#include "tst_searchcontexttest.moc"
@@ -0,0 +1,23 @@
+#-------------------------------------------------
+#
+# Project created by QtCreator 2026-10-19T15:02:17
+#
+#-------------------------------------------------
+
+QT       += testlib
+
+QT       -= gui
+
+TARGET = tst_stallmonitortest
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+
+SOURCES += tst_stallmonitortest.cpp \
+    ../../components/stallmonitor.cpp
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
+
+HEADERS += \
+    ../../components/stallmonitor.h
@@ -0,0 +1,83 @@
+#include <QtCore/QString>
+#include <QtCore/QFile>
+#include <QtCore/QThread>
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QtTest>
+
+#include "../../components/stallmonitor.h"
+
+class StallMonitorTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    StallMonitorTest();
+
+private Q_SLOTS:
+    void testInactive();
+    void testStallAttribution();
+    void testReport();
+    void cleanupTestCase();
+
+private:
+    QTemporaryDir m_dir;
+};
+
+StallMonitorTest::StallMonitorTest()
+{
+}
+
+void StallMonitorTest::testInactive()
+{
+    QVERIFY(!StallMonitor::isActive());
+
+    //must not create the monitor
+    StallMonitor::beginOperation("search");
+    StallMonitor::endOperation();
+    QVERIFY(!StallMonitor::isActive());
+}
+
+void StallMonitorTest::testStallAttribution()
+{
+    StallMonitor &monitor = StallMonitor::getInstance();
+    monitor.start(m_dir.path() + "/stalls.log", 100);
+    QVERIFY(StallMonitor::isActive());
+    QTest::qWait(120);
+
+    {
+        StallMonitor::Operation operation("search");
+        QThread::msleep(400); //block event loop
+    }
+
+    //the late tick comes after the operation ended
+    QTest::qWait(120);
+
+    QHash<QString, StallMonitor::Entry> summary = monitor.summary();
+    QVERIFY(summary.contains("search"));
+    QVERIFY(summary.value("search").count == 1);
+    QVERIFY(summary.value("search").maxMs >= 200);
+}
+
+void StallMonitorTest::testReport()
+{
+    StallMonitor &monitor = StallMonitor::getInstance();
+    monitor.stop();
+    QVERIFY(!StallMonitor::isActive());
+
+    QFile log(m_dir.path() + "/stalls.log");
+    QVERIFY(log.open(QIODevice::ReadOnly | QIODevice::Text));
+    QString content = QString::fromUtf8(log.readAll());
+
+    QVERIFY(content.contains("ms\tsearch\n"));
+    QVERIFY(content.contains("# summary"));
+    QVERIFY(monitor.report().startsWith("stalls\ttotal ms\tmax ms\toperation\n1\t"));
+}
+
+void StallMonitorTest::cleanupTestCase()
+{
+    StallMonitor::destroy();
+}
+
+QTEST_MAIN(StallMonitorTest)
+
+#include "tst_stallmonitortest.moc"
@@ -0,0 +1,37 @@
+#-------------------------------------------------
+#
+# Tests for the record selection and deletion of StandardModel
+#
+#-------------------------------------------------
+
+QT       += core gui sql testlib
+
+TARGET = tst_standardmodeltest
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+
+SOURCES += tst_standardmodeltest.cpp \
+    ../../components/databasemanager.cpp \
+    ../../components/queryprofiler.cpp \
+    ../../components/metadataengine.cpp \
+    ../../components/filemanager.cpp \
+    ../../components/filechangetracker.cpp \
+    ../../components/settingsmanager.cpp \
+    ../../utils/definitionholder.cpp \
+    ../../utils/metadatapropertiesparser.cpp \
+    ../../models/standardmodel.cpp
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
+
+HEADERS += \
+    ../../components/databasemanager.h \
+    ../../components/queryprofiler.h \
+    ../../components/metadataengine.h \
+    ../../components/filemanager.h \
+    ../../components/filechangetracker.h \
+    ../../components/settingsmanager.h \
+    ../../utils/definitionholder.h \
+    ../../utils/metadatapropertiesparser.h \
+    ../../models/standardmodel.h
@@ -0,0 +1,198 @@
+#include <QString>
+#include <QtTest>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QItemSelectionModel>
+
+#include "../../components/metadataengine.h"
+#include "../../components/databasemanager.h"
+#include "../../models/standardmodel.h"
+
+class StandardModelTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    StandardModelTest();
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void testLazyFetch();
+    void testSelectAllDelete();
+    void testTextSort();
+
+private:
+    /** Fill the test collection with the specified number of records */
+    void insertRecords(int count);
+
+    /** Get the record count of the test collection from the database */
+    int tableRecordCount();
+
+    MetadataEngine *m_metadataEngine;
+    int m_collectionId;
+    int m_originalCollectionId;
+    int m_rows;
+};
+
+StandardModelTest::StandardModelTest() :
+    m_metadataEngine(0),
+    m_collectionId(0),
+    m_originalCollectionId(0),
+    m_rows(1000) //more than one fetch batch of the SQLite driver (256)
+{
+}
+
+void StandardModelTest::initTestCase()
+{
+    DatabaseManager::getInstance();
+    m_metadataEngine = &MetadataEngine::getInstance();
+    m_originalCollectionId = m_metadataEngine->getCurrentCollectionId();
+
+    //simulate new entry in collection list
+    QSqlQuery query(DatabaseManager::getInstance().getDatabase());
+    query.exec("INSERT INTO \"collections\" (\"name\") VALUES (\"ModelTest\")");
+    m_collectionId = m_metadataEngine->createNewCollection();
+    QVERIFY(m_collectionId != 0);
+    m_metadataEngine->setCurrentCollectionId(m_collectionId);
+    m_metadataEngine->createField("Name", MetadataEngine::TextType, "", "", "");
+}
+
+void StandardModelTest::cleanupTestCase()
+{
+    if (!m_collectionId)
+        return;
+
+    m_metadataEngine->setCurrentCollectionId(m_originalCollectionId);
+    m_metadataEngine->deleteCollection(m_collectionId);
+
+    QSqlQuery query(DatabaseManager::getInstance().getDatabase());
+    query.prepare("DELETE FROM collections WHERE _id=:id");
+    query.bindValue(":id", m_collectionId);
+    query.exec();
+}
+
+void StandardModelTest::testLazyFetch()
+{
+    insertRecords(m_rows);
+
+    StandardModel model(m_metadataEngine);
+    model.setTable(m_metadataEngine->getTableName(m_collectionId));
+    model.select();
+
+    //only the first batch is loaded, the record count is not fetching
+    QVERIFY(model.rowCount() < m_rows);
+    QCOMPARE(model.recordCount(), m_rows);
+    QVERIFY(model.rowCount() < m_rows);
+
+    QCOMPARE(model.realRowCount(), m_rows);
+}
+
+void StandardModelTest::testSelectAllDelete()
+{
+    if (!tableRecordCount())
+        insertRecords(m_rows);
+    QCOMPARE(tableRecordCount(), m_rows);
+
+    StandardModel model(m_metadataEngine);
+    model.setTable(m_metadataEngine->getTableName(m_collectionId));
+    model.select();
+    QVERIFY(model.rowCount() < m_rows);
+
+    //select all, as MainWindow::selectAllActionTriggered()
+    QItemSelectionModel selectionModel(&model);
+    selectionModel.select(model.allRecordsSelection(),
+                          QItemSelectionModel::Select);
+
+    //delete selected records, as MainWindow::deleteRecordActionTriggered()
+    QSet<int> rows;
+    foreach (const QModelIndex &index, selectionModel.selectedIndexes())
+        rows.insert(index.row());
+    QCOMPARE(rows.size(), m_rows);
+
+    QStringList ids;
+    foreach (int row, rows)
+        ids.append(model.index(row, 0).data().toString());
+
+    QSqlQuery query(DatabaseManager::getInstance().getDatabase());
+    QVERIFY(query.exec(QString("DELETE FROM '%1' WHERE _id IN (%2)")
+                       .arg(model.tableName()).arg(ids.join(","))));
+    model.select();
+
+    QCOMPARE(tableRecordCount(), 0);
+    QCOMPARE(model.recordCount(), 0);
+    QVERIFY(model.allRecordsSelection().isEmpty());
+}
+
+void StandardModelTest::testTextSort()
+{
+    QSqlQuery query(DatabaseManager::getInstance().getDatabase());
+    QString tableName = m_metadataEngine->getTableName(m_collectionId);
+    query.exec(QString("DELETE FROM '%1'").arg(tableName));
+
+    QStringList names;
+    names << "Zinnia" << "ageratum" << "Achillea 10" << "Äster"
+          << "Achillea 9";
+    query.prepare(QString("INSERT INTO '%1' (\"%2\") VALUES (?)")
+                  .arg(tableName).arg(m_metadataEngine->getFieldKey(1)));
+    foreach (const QString &name, names) {
+        query.addBindValue(name);
+        query.exec();
+    }
+
+    StandardModel model(m_metadataEngine);
+    model.setTable(tableName);
+    model.select();
+    model.sort(1, Qt::AscendingOrder);
+
+    //case insensitive, umlauts like their base letter, numbers by value
+    QStringList expected;
+    expected << "Achillea 9" << "Achillea 10" << "ageratum" << "Äster"
+             << "Zinnia";
+    QCOMPARE(model.rowCount(), expected.size());
+    for (int i = 0; i < expected.size(); i++)
+        QCOMPARE(model.index(i, 1).data().toString(), expected.at(i));
+
+    //records added or changed after sorting get their key on select
+    query.exec(QString("INSERT INTO '%1' (\"%2\") VALUES ('Begonia')")
+               .arg(tableName).arg(m_metadataEngine->getFieldKey(1)));
+    query.exec(QString("UPDATE '%1' SET \"%2\"='Yarrow' WHERE \"%2\"='Zinnia'")
+               .arg(tableName).arg(m_metadataEngine->getFieldKey(1)));
+    model.select();
+    QCOMPARE(model.rowCount(), expected.size() + 1);
+    QCOMPARE(model.index(4, 1).data().toString(), QString("Begonia"));
+    QCOMPARE(model.index(5, 1).data().toString(), QString("Yarrow"));
+
+    model.sort(1, Qt::DescendingOrder);
+    QCOMPARE(model.index(0, 1).data().toString(), QString("Yarrow"));
+}
+
+void StandardModelTest::insertRecords(int count)
+{
+    QSqlDatabase db = DatabaseManager::getInstance().getDatabase();
+    QSqlQuery query(db);
+
+    QVariantList values;
+    for (int i = 0; i < count; i++)
+        values.append(QString("Record %1").arg(i + 1));
+
+    db.transaction();
+    query.prepare(QString("INSERT INTO '%1' (\"%2\") VALUES (?)")
+                  .arg(m_metadataEngine->getTableName(m_collectionId))
+                  .arg(m_metadataEngine->getFieldKey(1)));
+    query.addBindValue(values);
+    query.execBatch();
+    db.commit();
+}
+
+int StandardModelTest::tableRecordCount()
+{
+    QSqlQuery query(DatabaseManager::getInstance().getDatabase());
+    query.exec(QString("SELECT COUNT(*) FROM '%1'")
+               .arg(m_metadataEngine->getTableName(m_collectionId)));
+    return query.next() ? query.value(0).toInt() : -1;
+}
+
+QTEST_APPLESS_MAIN(StandardModelTest)
+
+#include "tst_standardmodeltest.moc"
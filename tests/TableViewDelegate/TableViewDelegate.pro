@@ -0,0 +1,25 @@
+#-------------------------------------------------
+#
+# Offscreen paint benchmark for TableViewDelegate,
+# the delegate needs most of the application
+#
+#-------------------------------------------------
+
+QT       += core gui sql network svg widgets printsupport testlib
+
+win32 {
+    QT += winextras
+}
+
+TARGET = tst_tableviewdelegatebenchmark
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+# application sources, SQL statements per cell are counted by
+# QueryProfiler, which needs CONFIG+=system_sqlite
+include(../../passiflora.pri)
+
+SOURCES += tst_tableviewdelegatebenchmark.cpp
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
@@ -0,0 +1,318 @@
+#include <QString>
+#include <QtTest>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QApplication>
+#include <QStandardPaths>
+#include <QTableView>
+#include <QPainter>
+#include <QImage>
+
+#include "../../components/metadataengine.h"
+#include "../../components/databasemanager.h"
+#include "../../components/queryprofiler.h"
+#include "../../components/filemanager.h"
+#include "../../models/standardmodel.h"
+#include "../../views/tableview/tableviewdelegate.h"
+
+/**
+ * Paints every cell of a synthetic collection, with one field of each
+ * MetadataEngine::FieldType, into a QImage through TableViewDelegate.
+ * Reports ns/cell and, if built with CONFIG+=system_sqlite, SQL
+ * statements/cell (QtTest "events") counted by DatabaseManager's
+ * QueryProfiler. The record count can be set with
+ * PASSIFLORA_BENCH_ROWS (default 1000). Runs without a display,
+ * the offscreen platform is used unless QT_QPA_PLATFORM is set.
+ */
+class TableViewDelegateBenchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    TableViewDelegateBenchmark();
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void benchmarkPaint_data();
+    void benchmarkPaint();
+    void benchmarkPaintQueries_data();
+    void benchmarkPaintQueries();
+
+private:
+    /** Create the collection, one field per type, and fill it */
+    void createCollection();
+
+    /** Create the image content files used by image fields */
+    void createImages();
+
+    /** Get a synthetic value for the specified record and field type */
+    QVariant syntheticValue(int record, MetadataEngine::FieldType type) const;
+
+    /** Add one data row for each field type */
+    void addFieldTypeRows();
+
+    /** Paint all rows of the specified column once */
+    void paintColumn(int column);
+
+    MetadataEngine *m_metadataEngine;
+    StandardModel *m_model;
+    QTableView *m_view;
+    TableViewDelegate *m_delegate;
+    QImage m_image;
+    int m_rows;
+    int m_collectionId;
+    int m_originalCollectionId;
+    QList<int> m_imageFileIds;
+    QueryProfiler *m_queryProfiler; /**< Counts statements, 0 if unavailable */
+};
+
+TableViewDelegateBenchmark::TableViewDelegateBenchmark() :
+    m_metadataEngine(0),
+    m_model(0),
+    m_view(0),
+    m_delegate(0),
+    m_image(200, 30, QImage::Format_ARGB32_Premultiplied),
+    m_collectionId(0),
+    m_originalCollectionId(0),
+    m_queryProfiler(0)
+{
+    bool ok;
+    m_rows = qgetenv("PASSIFLORA_BENCH_ROWS").toInt(&ok);
+    if (!ok || (m_rows < 1))
+        m_rows = 1000;
+}
+
+void TableViewDelegateBenchmark::initTestCase()
+{
+    QSqlDatabase db = DatabaseManager::getInstance().getDatabase();
+    m_metadataEngine = &MetadataEngine::getInstance();
+    m_originalCollectionId = m_metadataEngine->getCurrentCollectionId();
+
+    createImages();
+    createCollection();
+
+    m_model = new StandardModel(m_metadataEngine, this);
+    m_model->setTable(m_metadataEngine->getTableName(m_collectionId));
+    m_model->select();
+    QVERIFY(m_model->realRowCount() == m_rows);
+
+    //the delegate takes style and font from the view
+    m_view = new QTableView;
+    m_view->setModel(m_model);
+    m_delegate = new TableViewDelegate(m_view);
+    m_view->setItemDelegate(m_delegate);
+
+    //count statements with the profiler of the main connection
+    QueryProfiler *profiler = DatabaseManager::getInstance().getQueryProfiler();
+    if (profiler->isInstalled() || profiler->install(db))
+        m_queryProfiler = profiler;
+}
+
+void TableViewDelegateBenchmark::cleanupTestCase()
+{
+    delete m_view;
+    m_view = 0;
+    delete m_model;
+    m_model = 0;
+
+    FileManager fm;
+    foreach (int fileId, m_imageFileIds) {
+        QString fileName, hashName;
+        QDateTime dateAdded;
+        if (m_metadataEngine->getContentFile(fileId, fileName,
+                                             hashName, dateAdded))
+            QFile::remove(fm.getFilesDirectory() + hashName);
+        m_metadataEngine->removeContentFile(fileId);
+    }
+
+    if (!m_collectionId)
+        return;
+
+    m_metadataEngine->setCurrentCollectionId(m_originalCollectionId);
+    m_metadataEngine->deleteCollection(m_collectionId);
+
+    QSqlQuery query(DatabaseManager::getInstance().getDatabase());
+    query.prepare("DELETE FROM collections WHERE _id=:id");
+    query.bindValue(":id", m_collectionId);
+    query.exec();
+}
+
+void TableViewDelegateBenchmark::benchmarkPaint_data()
+{
+    addFieldTypeRows();
+}
+
+void TableViewDelegateBenchmark::benchmarkPaint()
+{
+    QFETCH(int, column);
+
+    paintColumn(column); //warm up style, fonts and caches
+
+    QElapsedTimer timer;
+    timer.start();
+    paintColumn(column);
+    qint64 elapsed = timer.nsecsElapsed();
+
+    QTest::setBenchmarkResult(qreal(elapsed) / m_rows,
+                              QTest::WalltimeNanoseconds);
+}
+
+void TableViewDelegateBenchmark::benchmarkPaintQueries_data()
+{
+    addFieldTypeRows();
+}
+
+void TableViewDelegateBenchmark::benchmarkPaintQueries()
+{
+    QFETCH(int, column);
+
+    if (!m_queryProfiler)
+        QSKIP("SQL statements are only counted with CONFIG+=system_sqlite");
+
+    paintColumn(column); //warm up style, fonts and caches
+
+    qint64 startCount = m_queryProfiler->statementCount();
+    paintColumn(column);
+    qint64 count = m_queryProfiler->statementCount() - startCount;
+
+    QTest::setBenchmarkResult(qreal(count) / m_rows, QTest::Events);
+}
+
+void TableViewDelegateBenchmark::createCollection()
+{
+    QSqlDatabase db = DatabaseManager::getInstance().getDatabase();
+    QSqlQuery query(db);
+
+    //simulate new entry in collection list
+    query.exec("INSERT INTO \"collections\" (\"name\") VALUES (\"Paint Benchmark\")");
+    m_collectionId = m_metadataEngine->createNewCollection();
+    m_metadataEngine->setCurrentCollectionId(m_collectionId);
+
+    QStringList columns;
+    QStringList placeholders;
+    for (int t = MetadataEngine::TextType; t <= MetadataEngine::EmailTextType; t++) {
+        int column = m_metadataEngine->createField(QString("Field %1").arg(t),
+                                                   (MetadataEngine::FieldType) t,
+                                                   "", "", "");
+        columns.append(QString("\"%1\"").arg(m_metadataEngine->getFieldKey(column)));
+        placeholders.append("?");
+    }
+
+    //insert records column by column with a single batch
+    db.transaction();
+    query.prepare(QString("INSERT INTO '%1' (%2) VALUES (%3)")
+                  .arg(m_metadataEngine->getTableName(m_collectionId))
+                  .arg(columns.join(","))
+                  .arg(placeholders.join(",")));
+    for (int t = MetadataEngine::TextType; t <= MetadataEngine::EmailTextType; t++) {
+        QVariantList values;
+        for (int r = 0; r < m_rows; r++)
+            values.append(syntheticValue(r, (MetadataEngine::FieldType) t));
+        query.addBindValue(values);
+    }
+    query.execBatch();
+    db.commit();
+}
+
+void TableViewDelegateBenchmark::createImages()
+{
+    FileManager fm;
+    QDir().mkpath(fm.getFilesDirectory());
+
+    for (int i = 0; i < 8; i++) {
+        QImage image(640, 480, QImage::Format_RGB32);
+        image.fill(QColor::fromHsv(i * 45, 200, 200));
+        QString hashName = QString("paintbenchmark%1.png").arg(i);
+        image.save(fm.getFilesDirectory() + hashName);
+        m_imageFileIds.append(m_metadataEngine->addContentFile(
+                                  QString("image%1.png").arg(i), hashName));
+    }
+}
+
+QVariant TableViewDelegateBenchmark::syntheticValue(
+        int record, MetadataEngine::FieldType type) const
+{
+    switch (type) {
+    case MetadataEngine::TextType:
+        return QString("word%1 lorem ipsum %2").arg(record % 997).arg(record);
+    case MetadataEngine::URLTextType:
+        return QString("http://example.com/%1").arg(record);
+    case MetadataEngine::EmailTextType:
+        return QString("user%1@example.com").arg(record);
+    case MetadataEngine::NumericType:
+        return (record * 7919) % 100003;
+    case MetadataEngine::CheckboxType:
+        return record % 2;
+    case MetadataEngine::ComboboxType:
+        return record % 5;
+    case MetadataEngine::ProgressType:
+        return record % 101;
+    case MetadataEngine::DateType:
+    case MetadataEngine::CreationDateType:
+    case MetadataEngine::ModDateType:
+        return QDateTime(QDate(2000, 1, 1)).addSecs(record * 3607LL);
+    case MetadataEngine::ImageType:
+        return m_imageFileIds.at(record % m_imageFileIds.size());
+    case MetadataEngine::FilesType:
+    {
+        //ids don't need to exist, only the count is painted
+        QStringList ids;
+        for (int i = 0; i <= (record % 3); i++)
+            ids.append(QString::number(record + i + 1));
+        return ids.join(",");
+    }
+    default:
+        return QVariant();
+    }
+}
+
+void TableViewDelegateBenchmark::addFieldTypeRows()
+{
+    QTest::addColumn<int>("column");
+
+    //fields were created in FieldType order
+    QTest::newRow("text") << 1;
+    QTest::newRow("numeric") << 2;
+    QTest::newRow("date") << 3;
+    QTest::newRow("creation date") << 4;
+    QTest::newRow("mod date") << 5;
+    QTest::newRow("checkbox") << 6;
+    QTest::newRow("combobox") << 7;
+    QTest::newRow("progress") << 8;
+    QTest::newRow("image") << 9;
+    QTest::newRow("files") << 10;
+    QTest::newRow("url") << 11;
+    QTest::newRow("email") << 12;
+}
+
+void TableViewDelegateBenchmark::paintColumn(int column)
+{
+    QStyleOptionViewItem option;
+    option.initFrom(m_view);
+    option.widget = m_view;
+    option.rect = m_image.rect();
+
+    QPainter painter(&m_image);
+    for (int r = 0; r < m_rows; r++) {
+        painter.fillRect(option.rect, Qt::white);
+        m_delegate->paint(&painter, option, m_model->index(r, column));
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    //use a separate database, not the one of the user
+    QStandardPaths::setTestModeEnabled(true);
+
+    if (qgetenv("QT_QPA_PLATFORM").isEmpty())
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    app.setApplicationName("PassifloraBenchmark");
+
+    TableViewDelegateBenchmark test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "tst_tableviewdelegatebenchmark.moc"
@@ -42,7 +42,8 @@ void CollectionFieldCleaner::cleanField(int collectionId, int fieldId)
         QStringList fileIdList;
         QString tableName = m_metadataEngine->getTableName(collectionId);
         QString sql = QString("SELECT \"%1\" FROM \"%2\"")
-                             .arg(QString::number(fieldId)).arg(tableName);
+                             .arg(m_metadataEngine->getFieldKey(fieldId, collectionId))
+                             .arg(tableName);
         query.exec(sql);
 
         while (query.next()) {
@@ -0,0 +1,131 @@
+/*
+ *  Copyright (c) 2017 Giorgio Wicklein <giowckln@gmail.com>
+ */
+
+//-----------------------------------------------------------------------------
+// Hearders
+//-----------------------------------------------------------------------------
+
+#include "csvparser.h"
+
+#include <QtCore/QIODevice>
+#include <QtCore/QTextCodec>
+
+
+//-----------------------------------------------------------------------------
+// Public
+//-----------------------------------------------------------------------------
+
+CsvParser::CsvParser(QIODevice *device, QChar separator,
+                     const QByteArray &codecName) :
+    m_stream(device),
+    m_separator(separator),
+    m_rowCount(0)
+{
+    QTextCodec *codec = 0;
+    if (!codecName.isEmpty())
+        codec = QTextCodec::codecForName(codecName);
+    if (!codec)
+        codec = QTextCodec::codecForName("UTF-8");
+    m_stream.setCodec(codec);
+}
+
+bool CsvParser::readRow(QStringList &fields)
+{
+    fields.clear();
+
+    //skip empty lines between rows
+    QString line;
+    do {
+        if (m_stream.atEnd())
+            return false;
+        line = m_stream.readLine();
+    } while (line.isEmpty());
+
+    bool inQuotes = false;
+    parseLine(line, m_separator, fields, inQuotes);
+
+    //quoted field with line breaks, continue on next lines
+    while (inQuotes && !m_stream.atEnd()) {
+        fields.last().append('\n');
+        parseLine(m_stream.readLine(), m_separator, fields, inQuotes);
+    }
+
+    m_rowCount++;
+    return true;
+}
+
+int CsvParser::rowCount() const
+{
+    return m_rowCount;
+}
+
+QStringList CsvParser::parseRow(const QString &row, QChar separator)
+{
+    QStringList fields;
+    bool inQuotes = false;
+    parseLine(row, separator, fields, inQuotes);
+    return fields;
+}
+
+QString CsvParser::formatRow(const QStringList &fields, QChar separator)
+{
+    QString row;
+
+    for (int i = 0; i < fields.size(); i++) {
+        if (i) row.append(separator);
+
+        QString field = fields.at(i);
+        if (field.contains(separator) || field.contains('"') ||
+                field.contains('\n') || field.contains('\r')) {
+            field.replace("\"", "\"\"");
+            row.append('"').append(field).append('"');
+        } else {
+            row.append(field);
+        }
+    }
+
+    return row;
+}
+
+
+//-----------------------------------------------------------------------------
+// Private
+//-----------------------------------------------------------------------------
+
+void CsvParser::parseLine(const QString &line, QChar separator,
+                          QStringList &fields, bool &inQuotes)
+{
+    QString field;
+    if (inQuotes) {
+        //continue the last field
+        field = fields.takeLast();
+    }
+
+    const int size = line.size();
+    for (int i = 0; i < size; i++) {
+        QChar c = line.at(i);
+
+        if (inQuotes) {
+            if (c == '"') {
+                if (((i + 1) < size) && (line.at(i + 1) == '"')) {
+                    field.append('"'); //escaped quote
+                    i++;
+                } else {
+                    inQuotes = false;
+                }
+            } else {
+                field.append(c);
+            }
+        } else if (c == separator) {
+            fields.append(field);
+            field.clear();
+        } else if ((c == '"') && field.isEmpty()) {
+            inQuotes = true;
+        } else if (c != '\r') {
+            field.append(c);
+        }
+    }
+
+    fields.append(field);
+}
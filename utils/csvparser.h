@@ -0,0 +1,82 @@
+/**
+  * \class CsvParser
+  * \brief This utility reads delimited text (CSV, TSV) row by row from a
+  *        device, so files of any size can be processed without loading
+  *        them in memory. Fields may be quoted with double quotes, quoted
+  *        fields can contain separators, line breaks and escaped
+  *        quotes (""), as described in RFC 4180. Rows for writing
+  *        are formatted by formatRow().
+  * \author Giorgio Wicklein - GIOWISYS Software
+  * \date 19/10/2026
+  */
+
+#ifndef CSVPARSER_H
+#define CSVPARSER_H
+
+
+//-----------------------------------------------------------------------------
+// Headers
+//-----------------------------------------------------------------------------
+
+#include <QtCore/QStringList>
+#include <QtCore/QTextStream>
+
+
+//-----------------------------------------------------------------------------
+// Forward declarations
+//-----------------------------------------------------------------------------
+
+class QIODevice;
+
+
+//-----------------------------------------------------------------------------
+// CsvParser
+//-----------------------------------------------------------------------------
+
+class CsvParser
+{
+public:
+    /**
+     * Construct a parser reading from the specified open device
+     * @param device - the device to read from
+     * @param separator - the field separator, like ',' ';' or '\t'
+     * @param codecName - the text encoding, UTF-8 if empty
+     */
+    CsvParser(QIODevice *device, QChar separator,
+              const QByteArray &codecName = QByteArray());
+
+    /**
+     * Read the next row
+     * @param fields - the fields of the row
+     * @return false if there are no more rows
+     */
+    bool readRow(QStringList &fields);
+
+    /** Return the count of rows read so far */
+    int rowCount() const;
+
+    /** Parse a single row, quoted fields must not span lines */
+    static QStringList parseRow(const QString &row, QChar separator);
+
+    /**
+     * Format the specified fields as row, without line break.
+     * Fields with separators, quotes or line breaks are quoted,
+     * so the row can be read back with readRow().
+     */
+    static QString formatRow(const QStringList &fields, QChar separator);
+
+private:
+    /**
+     * Parse the specified line, appending to fields
+     * @param inQuotes - whether the line starts inside a quoted field,
+     *                   set to whether it ends inside one
+     */
+    static void parseLine(const QString &line, QChar separator,
+                          QStringList &fields, bool &inQuotes);
+
+    QTextStream m_stream;
+    QChar m_separator;
+    int m_rowCount;
+};
+
+#endif // CSVPARSER_H
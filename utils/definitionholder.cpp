@@ -28,7 +28,7 @@ QString DefinitionHolder::PLANT_DB_IMG_URL = "http://passiflora.enmed.de/updates
 QString DefinitionHolder::PLANT_DB_IMG_META_URL = "http://passiflora.enmed.de/updates_raw/plantimagesmeta.json";
 QString DefinitionHolder::DOWNLOAD_URL = "http://passiflora.enmed.de/update/";
 int DefinitionHolder::SOFTWARE_BUILD = 10;
-int DefinitionHolder::DATABASE_VERSION = 2;
+int DefinitionHolder::DATABASE_VERSION = 3;
 bool DefinitionHolder::APP_STORE = false;
 QString DefinitionHolder::COPYRIGHT =
         QString("Copyright &copy; 2014-%1 Giorgio Wicklein"
@@ -0,0 +1,165 @@
+/*
+ *  Copyright (c) 2017 Giorgio Wicklein <giowckln@gmail.com>
+ */
+
+//-----------------------------------------------------------------------------
+// Hearders
+//-----------------------------------------------------------------------------
+
+#include "fieldformatter.h"
+#include "metadatapropertiesparser.h"
+
+#include <QtCore/QVariant>
+#include <QtCore/QLocale>
+#include <QtCore/QDateTime>
+
+
+//-----------------------------------------------------------------------------
+// Public
+//-----------------------------------------------------------------------------
+
+FieldFormatter::FieldFormatter(const QString &metadataDisplayProperties,
+                               MetadataEngine::FieldType type,
+                               const QHash<int,QString> &fileNames) :
+    m_fieldType(type),
+    m_precision(0),
+    m_defaultItem(-1),
+    m_fileNames(fileNames)
+{
+    MetadataPropertiesParser parser(metadataDisplayProperties);
+
+    switch (m_fieldType) {
+    case MetadataEngine::NumericType:
+        m_numberMode = parser.getValue("displayMode");
+        m_precision = parser.getValue("precision").toInt();
+        break;
+    case MetadataEngine::DateType:
+    case MetadataEngine::CreationDateType:
+    case MetadataEngine::ModDateType:
+        m_dateFormat = dateFormat(parser.getValue("dateFormat"));
+        break;
+    case MetadataEngine::ComboboxType:
+    {
+        m_items = comboboxItems(parser.getValue("items"));
+
+        bool ok;
+        m_defaultItem = parser.getValue("default").toInt(&ok);
+        if (!ok) m_defaultItem = -1;
+    }
+        break;
+    default:
+        break;
+    }
+}
+
+MetadataEngine::FieldType FieldFormatter::type() const
+{
+    return m_fieldType;
+}
+
+QString FieldFormatter::format(const QVariant &data) const
+{
+    //empty combobox values show the default item
+    if (data.isNull() && (m_fieldType != MetadataEngine::ComboboxType))
+        return QString();
+
+    switch (m_fieldType) {
+    case MetadataEngine::NumericType:
+        return formatNumeric(data);
+    case MetadataEngine::DateType:
+    case MetadataEngine::CreationDateType:
+    case MetadataEngine::ModDateType:
+        return data.toDateTime().toString(m_dateFormat);
+    case MetadataEngine::CheckboxType:
+        return data.toInt() ? "1" : "0";
+    case MetadataEngine::ComboboxType:
+        return formatCombobox(data);
+    case MetadataEngine::ProgressType:
+        return QString::number(data.toInt());
+    case MetadataEngine::ImageType:
+    case MetadataEngine::FilesType:
+        return formatFiles(data);
+    default:
+        return data.toString();
+    }
+}
+
+QString FieldFormatter::dateFormat(const QString &dateFormatProperty)
+{
+    QLocale locale;
+    const QString &v = dateFormatProperty;
+
+    if (v == "2")
+        return locale.dateFormat(QLocale::ShortFormat);
+    else if (v == "3")
+        return "ddd MMM d hh:mm yyyy";
+    else if (v == "4")
+        return "ddd MMM d yyyy";
+    else if (v == "5")
+        return "yyyy-MM-dd hh:mm";
+    else if (v == "6")
+        return "yyyy-MM-dd";
+    else
+        return locale.dateTimeFormat(QLocale::ShortFormat);
+}
+
+QStringList FieldFormatter::comboboxItems(const QString &itemsProperty)
+{
+    QStringList items;
+
+    foreach (QString s, itemsProperty.split(',', QString::SkipEmptyParts)) {
+        //replace some escape codes
+        s.replace("\\comma", ",");
+        s.replace("\\colon", ":");
+        s.replace("\\semicolon", ";");
+        s.replace("\\doublequote", "\"");
+        s.replace("\\singlequote", "'");
+        items.append(s);
+    }
+
+    return items;
+}
+
+
+//-----------------------------------------------------------------------------
+// Private
+//-----------------------------------------------------------------------------
+
+QString FieldFormatter::formatNumeric(const QVariant &data) const
+{
+    QString s = data.toString();
+    if (s.isEmpty())
+        return s;
+
+    if (m_numberMode == "decimal")
+        return QString::number(data.toDouble(), 'f', m_precision);
+    else if (m_numberMode == "scientific")
+        return QString::number(data.toDouble(), 'e', m_precision);
+    else
+        return s;
+}
+
+QString FieldFormatter::formatCombobox(const QVariant &data) const
+{
+    bool ok;
+    int itemId = data.toInt(&ok);
+    if (!ok || data.toString().isEmpty())
+        itemId = m_defaultItem;
+
+    if ((itemId >= 0) && (itemId < m_items.size()))
+        return m_items.at(itemId);
+    return QString();
+}
+
+QString FieldFormatter::formatFiles(const QVariant &data) const
+{
+    QStringList ids = data.toString().split(',', QString::SkipEmptyParts);
+    QStringList names;
+
+    foreach (const QString &id, ids) {
+        QString name = m_fileNames.value(id.toInt());
+        names.append(name.isEmpty() ? id : name);
+    }
+
+    return names.join(", ");
+}
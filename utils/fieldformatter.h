@@ -0,0 +1,84 @@
+/**
+  * \class FieldFormatter
+  * \brief This utility converts stored field data to text as defined by
+  *        the metadata display properties of the field, like number
+  *        precision, date format and combobox item names. It is used
+  *        where field values leave the views, for example by exports.
+  *        Numbers keep '.' as decimal point, so output stays machine
+  *        readable regardless of the system locale.
+  *        The parsing of date formats and combobox items is also
+  *        available as static methods, for views and imports.
+  * \author Giorgio Wicklein - GIOWISYS Software
+  * \date 19/10/2026
+  */
+
+#ifndef FIELDFORMATTER_H
+#define FIELDFORMATTER_H
+
+
+//-----------------------------------------------------------------------------
+// Headers
+//-----------------------------------------------------------------------------
+
+#include "../components/metadataengine.h"
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QHash>
+
+
+//-----------------------------------------------------------------------------
+// Forward declarations
+//-----------------------------------------------------------------------------
+
+class QVariant;
+
+
+//-----------------------------------------------------------------------------
+// FieldFormatter
+//-----------------------------------------------------------------------------
+
+class FieldFormatter
+{
+public:
+    /**
+     * Construct a formatter with the specified metadata display properties
+     * @param metadataDisplayProperties - the display properties of the field
+     * @param type - the data type of the field
+     * @param fileNames - names of content files by id, used for image
+     *                    and files fields, ids are used if not specified
+     */
+    FieldFormatter(const QString &metadataDisplayProperties,
+                   MetadataEngine::FieldType type,
+                   const QHash<int,QString> &fileNames = QHash<int,QString>());
+
+    /** Return the field type */
+    MetadataEngine::FieldType type() const;
+
+    /** Return the specified field data as text, empty if no data */
+    QString format(const QVariant &data) const;
+
+    /**
+     * Return the date format of the dateFormat display property value,
+     * the short date time format of the locale if not set
+     */
+    static QString dateFormat(const QString &dateFormatProperty);
+
+    /** Return the item names of the items display property value */
+    static QStringList comboboxItems(const QString &itemsProperty);
+
+private:
+    QString formatNumeric(const QVariant &data) const;
+    QString formatCombobox(const QVariant &data) const;
+    QString formatFiles(const QVariant &data) const;
+
+    MetadataEngine::FieldType m_fieldType;
+    QString m_numberMode; /**< auto, decimal or scientific */
+    int m_precision;
+    QString m_dateFormat;
+    QStringList m_items; /**< Combobox item names */
+    int m_defaultItem; /**< Combobox default item, -1 if none */
+    QHash<int,QString> m_fileNames;
+};
+
+#endif // FIELDFORMATTER_H
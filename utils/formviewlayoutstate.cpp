@@ -30,8 +30,8 @@ FormViewLayoutState::FormViewLayoutState(FormLayoutMatrix *matrix,
                 //init item
                 FormWidgetItem item;
                 item.id = formWidgetList.indexOf(fw);
-                item.width = fw->getWidthUnits();
-                item.height = fw->getHeightUnits();
+                item.width = matrix->getWidthUnits(fw);
+                item.height = matrix->getHeightUnits(fw);
                 item.row = i;
                 item.column = j;
 
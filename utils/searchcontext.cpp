@@ -0,0 +1,97 @@
+/*
+ *  Copyright (c) 2017 Giorgio Wicklein <giowckln@gmail.com>
+ */
+
+//-----------------------------------------------------------------------------
+// Hearders
+//-----------------------------------------------------------------------------
+
+#include "searchcontext.h"
+
+#include <QtCore/QString>
+#include <QtCore/QRegExp>
+
+
+//-----------------------------------------------------------------------------
+// Static
+//-----------------------------------------------------------------------------
+
+static bool matchLessThan(const SearchContext::Match &m1,
+                          const SearchContext::Match &m2)
+{
+    return m1.position < m2.position;
+}
+
+
+//-----------------------------------------------------------------------------
+// Public
+//-----------------------------------------------------------------------------
+
+SearchContext::SearchContext()
+{
+}
+
+SearchContext::SearchContext(const QString &searchString)
+{
+    QStringList terms = searchString.split(QRegExp("\\s+"),
+                                           QString::SkipEmptyParts);
+    terms.removeDuplicates();
+    m_terms = terms;
+}
+
+bool SearchContext::isActive() const
+{
+    return !m_terms.isEmpty();
+}
+
+QStringList SearchContext::getTerms() const
+{
+    return m_terms;
+}
+
+bool SearchContext::matches(const QString &text) const
+{
+    foreach (const QString &term, m_terms) {
+        if (text.contains(term, Qt::CaseInsensitive))
+            return true;
+    }
+
+    return false;
+}
+
+QList<SearchContext::Match> SearchContext::findMatches(const QString &text) const
+{
+    QList<Match> matches;
+
+    foreach (const QString &term, m_terms) {
+        int position = text.indexOf(term, 0, Qt::CaseInsensitive);
+        while (position != -1) {
+            Match m;
+            m.position = position;
+            m.length = term.length();
+            matches.append(m);
+            position = text.indexOf(term, position + term.length(),
+                                    Qt::CaseInsensitive);
+        }
+    }
+
+    if (matches.size() < 2)
+        return matches;
+
+    //merge overlapping ranges of different terms
+    qSort(matches.begin(), matches.end(), matchLessThan);
+    QList<Match> merged;
+    merged.append(matches.first());
+    for (int i = 1; i < matches.size(); i++) {
+        Match &last = merged.last();
+        const Match &m = matches.at(i);
+        if (m.position <= (last.position + last.length)) {
+            last.length = qMax(last.length,
+                               m.position + m.length - last.position);
+        } else {
+            merged.append(m);
+        }
+    }
+
+    return merged;
+}
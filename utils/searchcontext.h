@@ -0,0 +1,65 @@
+/**
+  * \class SearchContext
+  * \brief This utility holds the state of the active search. It is
+  *        published by the search pipeline (see MainWindow::searchSlot())
+  *        so views and form widgets can highlight results without
+  *        parsing the SQL filter. A search string is split into terms,
+  *        a record matches if each term is found in at least one field.
+  * \author Giorgio Wicklein - GIOWISYS Software
+  * \date 19/10/2026
+  */
+
+#ifndef SEARCHCONTEXT_H
+#define SEARCHCONTEXT_H
+
+
+//-----------------------------------------------------------------------------
+// Headers
+//-----------------------------------------------------------------------------
+
+#include <QtCore/QStringList>
+#include <QtCore/QList>
+
+
+//-----------------------------------------------------------------------------
+// SearchContext
+//-----------------------------------------------------------------------------
+
+class SearchContext
+{
+public:
+    /** A matched range of a text */
+    struct Match {
+        int position; /**< Start position of the match */
+        int length;   /**< Length of the match */
+    };
+
+    /** Construct an inactive search context (no search) */
+    SearchContext();
+
+    /** Construct a search context for the specified search string */
+    explicit SearchContext(const QString &searchString);
+
+    /** Whether a search is active */
+    bool isActive() const;
+
+    /** Return the search terms */
+    QStringList getTerms() const;
+
+    /** Whether any search term is contained in the specified text */
+    bool matches(const QString &text) const;
+
+    /**
+     * Find all occurrences of the search terms in the specified text.
+     * Matching is case insensitive, the matches are sorted by position
+     * and don't overlap, so they can be highlighted in a single pass.
+     * @param text - the text to search in
+     * @return list of matched ranges, empty if none
+     */
+    QList<Match> findMatches(const QString &text) const;
+
+private:
+    QStringList m_terms; /**< Search terms, without duplicates */
+};
+
+#endif // SEARCHCONTEXT_H
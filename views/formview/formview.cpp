@@ -32,7 +32,7 @@
 #include "../../components/undocommands.h"
 #include "../../utils/formviewlayoutstate.h"
 
-#include <QtCore/QPropertyAnimation>
+#include <QtCore/QVariantAnimation>
 #include <QtWidgets/QScrollBar>
 #include <QtGui/QMouseEvent>
 #include <QtWidgets/QApplication>
@@ -54,7 +54,8 @@ FormView::FormView(QWidget *parent) :
     m_isAnimating(false), m_isMovingFW(false), m_dropRectWidget(0),
     m_isSelectedFW(false), m_selectRectWidget(0), m_horizontalResizeGrip(0),
     m_verticalResizeGrip(0), m_isResizingFW(false), m_currentRow(-1),
-    m_currentColumn(-1), m_emptyFormWidget(0), m_modifiedTrigger(false)
+    m_currentColumn(-1), m_emptyFormWidget(0), m_modifiedTrigger(false),
+    m_populatedRow(-1), m_formCollectionId(0)
 {
     initFormView();
     createContextActions();
@@ -62,6 +63,7 @@ FormView::FormView(QWidget *parent) :
 
 FormView::~FormView()
 {
+    clearFormCache();
     delete m_formLayoutMatrix;
 }
 
@@ -192,6 +194,24 @@ void FormView::reloadAppearanceSettings()
     setupViewFonts();
 }
 
+void FormView::setSearchContext(const SearchContext &context)
+{
+    m_searchContext = context;
+    m_populatedRow = -1; //highlighting changed
+}
+
+void FormView::clearFormCache()
+{
+    foreach (int collectionId, m_formCacheOrder) {
+        deleteCachedForm(m_formCache.take(collectionId));
+    }
+    m_formCacheOrder.clear();
+
+    //the current form is not cached
+    //because it may be invalid too
+    m_formCollectionId = 0;
+}
+
 
 //-----------------------------------------------------------------------------
 // Protected slots
@@ -205,31 +225,16 @@ void FormView::navigateNextRecord()
     //is saved (focusOutEvent triggers editingFinished)
     setFocus();
 
-    bool hasNext;
     int next = m_currentRow + 1;
 
-    if (next >= model()->rowCount()) {
-        if (model()->canFetchMore(QModelIndex())) {
-            model()->fetchMore(QModelIndex());
-            hasNext = true;
-        } else {
-            hasNext = false;
-        }
-    } else {
-        hasNext = true;
-    }
-
-    if (hasNext) {
+    //fetch the next page of rows only when needed
+    if (fetchRow(next)) {
         m_currentRow = next;
         populateFields();
     }
 
     updateSelectionModel();
-
-    //show current record number on status bar
-    MainWindow::getStatusBar()->showMessage(
-                tr("Record %1 of %2").arg(m_currentRow + 1)
-                .arg(model()->rowCount()));
+    showRecordPosition();
 }
 
 void FormView::navigatePreviousRecord()
@@ -241,17 +246,13 @@ void FormView::navigatePreviousRecord()
     setFocus();
 
     int previous = m_currentRow - 1;
-    if ((previous >= 0) && (previous < model()->rowCount())) {
+    if (fetchRow(previous)) {
         m_currentRow = previous;
         populateFields();
     }
 
     updateSelectionModel();
-
-    //show current record number on status bar
-    MainWindow::getStatusBar()->showMessage(
-                tr("Record %1 of %2").arg(m_currentRow + 1)
-                .arg(model()->rowCount()));
+    showRecordPosition();
 }
 
 void FormView::navigateToRecord(int record)
@@ -260,37 +261,27 @@ void FormView::navigateToRecord(int record)
     //is saved (focusOutEvent triggers editingFinished)
     setFocus();
 
-    if ((record >= 0) && (record < model()->rowCount())) {
+    if (fetchRow(record)) {
         m_currentRow = record;
         populateFields();
     }
 
     updateSelectionModel();
-
-    //show current record number on status bar
-    MainWindow::getStatusBar()->showMessage(
-                tr("Record %1 of %2").arg(m_currentRow + 1)
-                .arg(model()->rowCount()));
+    showRecordPosition();
 }
 
 void FormView::updateLastModified(int startRow, int endRow)
 {
     if (!m_modifiedTrigger) return;
-    if (!model()) return;
 
-    QModelIndex index;
-    int fieldCount;
-    int column;
-
-    //update last modified date for all edited records
-    for (int r = startRow; r <= endRow; r++) {
-        fieldCount = m_modFieldList.size();
-        for (int i = 0; i < fieldCount; i++) {
-            column = m_modFieldList.at(i);
-            index = model()->index(r, column);
-            model()->setData(index, QDateTime::currentDateTime());
-        }
-    }
+    //assuming StandardModel only
+    StandardModel *s = qobject_cast<StandardModel*>(model());
+    if (!s) return;
+
+    //update last modified date for all edited records,
+    //one write per field instead of one per field and record
+    s->updateDateTime(startRow, endRow, m_modFieldList,
+                      QDateTime::currentDateTime());
 }
 
 
@@ -309,8 +300,9 @@ void FormView::dataChanged(const QModelIndex &topLeft,
     int end = bottomRight.row();
 
     //check if the current displayed item is in the range where edits happened
+    //and update only the fields of the changed columns
     if ((start <= m_currentRow) && (end >= m_currentRow)) {
-        populateFields();
+        populateFields(topLeft.column(), bottomRight.column());
     }
 }
 
@@ -319,16 +311,29 @@ void FormView::currentChanged(const QModelIndex &current,
 {
     QAbstractItemView::currentChanged(current, previous);
 
-    if (current.isValid()) {
+    //skip if the record is already shown,
+    //navigation methods populate before updating the selection
+    if (current.isValid() && ((current.row() != m_currentRow) ||
+                              (m_populatedRow != m_currentRow))) {
         m_currentRow = current.row();
         populateFields();
     }
 }
 
+void FormView::reset()
+{
+    QAbstractItemView::reset();
+
+    //rows may now refer to other records
+    m_populatedRow = -1;
+}
+
 void FormView::rowsInserted(const QModelIndex &parent, int start, int end)
 {
     QAbstractItemView::rowsInserted(parent, start, end);
 
+    m_populatedRow = -1;
+
     updateEmptyState();
 }
 
@@ -389,7 +394,7 @@ QModelIndex FormView::moveCursor(QAbstractItemView::CursorAction cursorAction,
         break;
     case MoveEnd:
     case MovePageDown:
-        navigateToRecord(model()->rowCount() - 1);
+        navigateToRecord(lastLoadedRow());
         break;
     case MoveNext:
     case MovePrevious:
@@ -415,11 +420,8 @@ int FormView::verticalOffset() const
 
 void FormView::scrollContentsBy(int dx, int dy)
 {
-    if (m_isAnimating) {
-        //update running animations because coordinates change on scroll
-        updateAnimations();
-    }
-
+    //running layout animations need no update, since
+    //their coordinates do not depend on scroll offsets
     scrollDirtyRegion(dx, dy);
     viewport()->scroll(dx, dy);
 }
@@ -790,7 +792,26 @@ void FormView::mouseDoubleClickEvent(QMouseEvent *event)
 void FormView::animationsFinished()
 {
     m_isAnimating = false;
-    m_animationList.clear();
+    m_layoutTransitions.clear();
+}
+
+void FormView::layoutAnimationStep(const QVariant &value)
+{
+    qreal progress = value.toReal();
+    int xOffset = horizontalOffset();
+    int yOffset = verticalOffset();
+
+    //move all widgets before the viewport is repainted once
+    viewport()->setUpdatesEnabled(false);
+    foreach (const LayoutTransition &t, m_layoutTransitions) {
+        QRect r;
+        r.setRect(t.startRect.x() + qRound((t.endRect.x() - t.startRect.x()) * progress),
+                  t.startRect.y() + qRound((t.endRect.y() - t.startRect.y()) * progress),
+                  t.startRect.width() + qRound((t.endRect.width() - t.startRect.width()) * progress),
+                  t.startRect.height() + qRound((t.endRect.height() - t.startRect.height()) * progress));
+        t.formWidget->setGeometry(r.translated(-xOffset, -yOffset));
+    }
+    viewport()->setUpdatesEnabled(true);
 }
 
 void FormView::formWidgetDataChanged()
@@ -889,24 +910,18 @@ void FormView::modelSorted(int column)
 
 void FormView::rowsDeleted(int startRow, int count)
 {
-    //Review on new collection types,
-    //assuming StandardModel only
-    StandardModel *s = qobject_cast<StandardModel*>(model());
-    int rowCount;
-    if (s)
-        rowCount = s->realRowCount();
-    else
-        rowCount = model()->rowCount();
+    m_populatedRow = -1;
 
-    //select previous row as current
-    if (rowCount) {
+    //select previous row as current,
+    //rows are fetched only up to the needed one
+    if (fetchRow(0)) {
         int previousRow = startRow - 1;
         int nextRow = startRow + count - 1;
 
-        if ((previousRow >= 0) && (previousRow < rowCount)) {
+        if (fetchRow(previousRow)) {
             m_currentRow = previousRow;
         } else { //select item after deleted rows
-            if (nextRow < rowCount) {
+            if (fetchRow(nextRow)) {
                 m_currentRow = nextRow;
             }
         }
@@ -917,6 +932,20 @@ void FormView::rowsDeleted(int startRow, int count)
     }
 }
 
+void FormView::currentCollectionStructureChanged()
+{
+    int collectionId = m_metadataEngine->getCurrentCollectionId();
+
+    if (m_formCache.contains(collectionId)) {
+        m_formCacheOrder.removeOne(collectionId);
+        deleteCachedForm(m_formCache.take(collectionId));
+    }
+
+    //don't cache the current form on next removeFields()
+    if (m_formCollectionId == collectionId)
+        m_formCollectionId = 0;
+}
+
 void FormView::updateEmptyState()
 {
     bool isEmpty;
@@ -960,6 +989,16 @@ void FormView::initFormView()
     m_emptyFormWidget = new EmptyFormWidget(this); //child of this instead of viewport()
     m_emptyFormWidget->setVisible(false);
 
+    //a single animation moves all widgets on layout changes
+    m_layoutAnimation = new QVariantAnimation(this);
+    m_layoutAnimation->setDuration(500);
+    m_layoutAnimation->setStartValue(0.0);
+    m_layoutAnimation->setEndValue(1.0);
+    connect(m_layoutAnimation, SIGNAL(valueChanged(QVariant)),
+            this, SLOT(layoutAnimationStep(QVariant)));
+    connect(m_layoutAnimation, SIGNAL(finished()),
+            this, SLOT(animationsFinished()));
+
     horizontalScrollBar()->setRange(0, 0);
     verticalScrollBar()->setRange(0, 0);
 
@@ -970,6 +1009,10 @@ void FormView::initFormView()
     connect(qApp, SIGNAL(focusChanged(QWidget*,QWidget*)),
             this, SLOT(handleFocusChange(QWidget*,QWidget*)));
 
+    //cached forms must be rebuilt if fields change
+    connect(m_metadataEngine, SIGNAL(currentCollectionChanged()),
+            this, SLOT(currentCollectionStructureChanged()));
+
     setupViewBackground();
     setupViewFonts();
 }
@@ -1043,22 +1086,24 @@ void FormView::renderFormLayoutMatrix(FormLayoutMatrix *matrix)
 void FormView::renderFormLayoutChange(FormLayoutMatrix *newMatrix)
 {
     clearFormWidgetSelection();
+    stopAnimations();
 
-    for (int i = 0; i < newMatrix->rowCount(); i++) {
-        for (int j = 0; j < newMatrix->columnCount(); j++) {
-            FormWidget *fw = newMatrix->getFormWidget(i, j);
-            if (m_formWidgetList.contains(fw)) { //filter out non widgets
-                QPropertyAnimation *a = new QPropertyAnimation(fw, "geometry", fw);
-                a->setDuration(500);
-                a->setStartValue(fw->geometry());
-                QRect coords = translateMatrixIndexToViewCoords(
-                            fw->getWidthUnits(), fw->getHeightUnits(),
-                            i, j);
-                a->setEndValue(coords);
-                //a->setEasingCurve(QEasingCurve::OutBounce); //not so good on slow PCs
-                m_animationList.append(a);
-            }
-        }
+    //queue a transition for each widget which changes position or size
+    int xOffset = horizontalOffset();
+    int yOffset = verticalOffset();
+    foreach (FormWidget *fw, m_formWidgetList) {
+        int row, column;
+        if (!newMatrix->findFormWidgetIndex(fw, row, column))
+            continue;
+
+        LayoutTransition t;
+        t.formWidget = fw;
+        t.startRect = fw->geometry().translated(xOffset, yOffset);
+        t.endRect = translateMatrixIndexToViewCoords(
+                    newMatrix->getWidthUnits(fw), newMatrix->getHeightUnits(fw),
+                    row, column).translated(xOffset, yOffset);
+        if (t.startRect != t.endRect)
+            m_layoutTransitions.append(t);
     }
 
     startQueuedAnimations();
@@ -1081,55 +1126,26 @@ void FormView::renderFormLayoutChange(FormLayoutMatrix *newMatrix)
 
 void FormView::startQueuedAnimations()
 {
-    stopAnimations();
-    m_isAnimating = true;
-
-    foreach(QPropertyAnimation *anim, m_animationList) {
-        anim->start(QAbstractAnimation::DeleteWhenStopped);
-    }
-
-    if (m_animationList.size() > 0) {
-        QPropertyAnimation *lastAnim = m_animationList.last();
-        connect(lastAnim, SIGNAL(finished()),
-                this, SLOT(animationsFinished()));
-    } else {
+    if (m_layoutTransitions.isEmpty()) {
         m_isAnimating = false;
+        return;
     }
+
+    m_isAnimating = true;
+    m_layoutAnimation->start();
 }
 
 void FormView::stopAnimations()
 {
     if (m_isAnimating) {
-        foreach(QPropertyAnimation *anim, m_animationList) {
-            QWidget *p = static_cast<QWidget*>(anim->parent());
-            QRect endGeometry = anim->endValue().toRect();
-            anim->stop();
-            p->setGeometry(endGeometry);
-
-        }
-        m_animationList.clear();
+        //move widgets to their end position
+        m_layoutAnimation->stop();
+        layoutAnimationStep(1.0);
+        m_layoutTransitions.clear();
         m_isAnimating = false;
     }
 }
 
-void FormView::updateAnimations()
-{
-    if (m_isAnimating) {
-        foreach(QPropertyAnimation *anim, m_animationList) {
-            FormWidget *fw = static_cast<FormWidget*>(anim->parent());
-            int row, column;
-            if (m_formLayoutMatrix->findFormWidgetIndex(fw, row, column)) {
-                QRect newCoords = translateMatrixIndexToViewCoords(
-                                  fw->getWidthUnits(), fw->getHeightUnits(),
-                                  row, column);
-                anim->setEndValue(newCoords);
-            } else {
-                anim->stop();
-            }
-        }
-    }
-}
-
 void FormView::updateScrollBars()
 {
     horizontalScrollBar()->setSingleStep(m_widthUnitPx);
@@ -1259,9 +1275,23 @@ void FormView::clearFormWidgetResize()
 
 void FormView::createFields()
 {
-    //delete all fields if any
+    //delete or cache all fields if any
     removeFields();
 
+    //reuse the prebuilt form if the collection was shown before
+    int collectionId = m_metadataEngine->getCurrentCollectionId();
+    if (restoreCachedForm(collectionId)) {
+        FormWidget* fw;
+        foreach(fw, m_formWidgetList) {
+            fw->show();
+        }
+
+        updateSize();
+        updateTabOrder();
+        return;
+    }
+    m_formCollectionId = collectionId;
+
     //create a form widget for every column
     //of current collection
     int fieldCount = m_metadataEngine->getFieldCount();
@@ -1321,14 +1351,22 @@ void FormView::removeFields()
     //will fail
     stopAnimations();
 
-    FormWidget* f;
-    foreach (f, m_formWidgetList) {
-        f->close();
-        delete f;
+    if (m_formCollectionId && !m_formWidgetList.isEmpty()) {
+        //keep the form for a later switch back to the collection
+        cacheCurrentForm();
+    } else {
+        FormWidget* f;
+        foreach (f, m_formWidgetList) {
+            f->close();
+            delete f;
+        }
+
+        //clear form layout matrix
+        delete m_formLayoutMatrix;
     }
+    m_formCollectionId = 0;
+    m_populatedRow = -1;
 
-    //clear form layout matrix
-    delete m_formLayoutMatrix;
     m_formLayoutMatrix = 0;
     m_formLayoutMatrix = new FormLayoutMatrix();
 
@@ -1341,48 +1379,116 @@ void FormView::removeFields()
     m_modFieldList.clear();
 }
 
-void FormView::populateFields()
+void FormView::cacheCurrentForm()
+{
+    FormCacheEntry entry;
+    entry.tableName = m_metadataEngine->getTableName(m_formCollectionId);
+    entry.formWidgetList = m_formWidgetList;
+    entry.formLayoutMatrix = m_formLayoutMatrix;
+    entry.modifiedTrigger = m_modifiedTrigger;
+    entry.modFieldList = m_modFieldList;
+
+    FormWidget* f;
+    foreach (f, m_formWidgetList) {
+        f->hide();
+    }
+
+    //replace older entry, if any
+    if (m_formCache.contains(m_formCollectionId)) {
+        m_formCacheOrder.removeOne(m_formCollectionId);
+        deleteCachedForm(m_formCache.take(m_formCollectionId));
+    }
+    m_formCache.insert(m_formCollectionId, entry);
+    m_formCacheOrder.append(m_formCollectionId);
+
+    //drop least recently used forms
+    while (m_formCacheOrder.size() > FORM_CACHE_SIZE) {
+        deleteCachedForm(m_formCache.take(m_formCacheOrder.takeFirst()));
+    }
+}
+
+bool FormView::restoreCachedForm(int collectionId)
+{
+    if (!m_formCache.contains(collectionId))
+        return false;
+
+    m_formCacheOrder.removeOne(collectionId);
+    FormCacheEntry entry = m_formCache.take(collectionId);
+
+    //collection ids may be reused after a collection was deleted
+    if (entry.tableName != m_metadataEngine->getTableName(collectionId)) {
+        deleteCachedForm(entry);
+        return false;
+    }
+
+    delete m_formLayoutMatrix;
+    m_formLayoutMatrix = entry.formLayoutMatrix;
+    m_formWidgetList = entry.formWidgetList;
+    m_modifiedTrigger = entry.modifiedTrigger;
+    m_modFieldList = entry.modFieldList;
+    m_formCollectionId = collectionId;
+
+    return true;
+}
+
+void FormView::deleteCachedForm(const FormCacheEntry &entry)
+{
+    FormWidget* f;
+    foreach (f, entry.formWidgetList) {
+        f->close();
+        delete f;
+    }
+    delete entry.formLayoutMatrix;
+}
+
+void FormView::populateFields(int firstColumn, int lastColumn)
 {
     //make sure  if row is valid
     if (m_currentRow == -1) {
+        m_populatedRow = -1;
         clearFields();
         return; //-1 means unset/invalid row
     }
 
-    //load all data from model
+    //load data from model up to the current row only
     QModelIndex index;
     QAbstractItemModel *m = model();
-    while (m->canFetchMore(index))
-        m->fetchMore(index);
-
-    //check if any filter aka search is active
-    QString activeSearchString = "";
-    QAbstractItemModel *imodel = this->model();
-    if (imodel) {
-        QSqlTableModel *sqlModel = static_cast<QSqlTableModel*> (imodel);
-        if (sqlModel) {
-            QString filter = sqlModel->filter();
-            if (!filter.isEmpty()) {
-                QString beforeOr = filter.split("OR").at(0);
-                QStringList wilds = beforeOr.split("%");
-                activeSearchString = wilds.at(1);
-            } else  {
-                activeSearchString = "__no_active_filter_symphytum"; //avoid empty searches
-            }
-        }
-    }
+    fetchRow(m_currentRow);
 
-    FormWidget *fw;
-    int column = 1; //0 is ID, so start with 1
-    foreach (fw, m_formWidgetList) {
+    //clamp column range to form widgets, 0 is ID
+    int fieldCount = m_formWidgetList.size();
+    if ((lastColumn == -1) || (lastColumn > fieldCount))
+        lastColumn = fieldCount;
+    if (firstColumn < 1)
+        firstColumn = 1;
+
+    const SearchContext &searchContext = activeSearchContext();
+
+    for (int column = firstColumn; column <= lastColumn; column++) {
+        FormWidget *fw = m_formWidgetList.at(column - 1);
         index = m->index(m_currentRow, column);
         if (index.isValid()) {
             fw->setData(index.data());
             //highlight fields with results, if found
-            fw->showHighlightSearchResults(activeSearchString);
+            fw->showHighlightSearchResults(searchContext);
         }
-        column++;
     }
+
+    if ((firstColumn == 1) && (lastColumn == fieldCount))
+        m_populatedRow = m_currentRow;
+}
+
+const SearchContext& FormView::activeSearchContext()
+{
+    static const SearchContext noSearch;
+
+    //the search context is only valid while the model is filtered,
+    //the filter is cleared on some actions (ex. new record)
+    QSqlTableModel *sqlModel = qobject_cast<QSqlTableModel*>(model());
+    if (!sqlModel || sqlModel->filter().isEmpty())
+        return noSearch;
+
+    return m_searchContext;
 }
 
 void FormView::clearFields()
@@ -1532,12 +1638,63 @@ AbstractFormWidget* FormView::createFormWidget(MetadataEngine::FieldType type,
 
 void FormView::updateSelectionModel()
 {
+    fetchRow(m_currentRow);
+
     //update selection model, so TableView is also updated
     selectionModel()->setCurrentIndex(model()->index(m_currentRow, 1),
                                       QItemSelectionModel::SelectCurrent |
                                       QItemSelectionModel::Clear);
 }
 
+bool FormView::fetchRow(int row)
+{
+    QAbstractItemModel *m = model();
+    if ((!m) || (row < 0))
+        return false;
+
+    while ((row >= m->rowCount()) && m->canFetchMore(QModelIndex()))
+        m->fetchMore(QModelIndex());
+
+    return row < m->rowCount();
+}
+
+int FormView::lastLoadedRow()
+{
+    QAbstractItemModel *m = model();
+    if (!m)
+        return -1;
+
+    int last = m->rowCount() - 1;
+
+    //like scrolling in table view, fetch the next rows
+    //only when the end of the loaded ones is reached
+    if ((m_currentRow >= last) && m->canFetchMore(QModelIndex())) {
+        m->fetchMore(QModelIndex());
+        last = m->rowCount() - 1;
+    }
+
+    return last;
+}
+
+int FormView::recordCount()
+{
+    //Review on new collection types,
+    //assuming StandardModel only
+    StandardModel *s = qobject_cast<StandardModel*>(model());
+    if (s)
+        return s->recordCount();
+    else
+        return model() ? model()->rowCount() : 0;
+}
+
+void FormView::showRecordPosition()
+{
+    //show current record number on status bar
+    MainWindow::getStatusBar()->showMessage(
+                tr("Record %1 of %2").arg(m_currentRow + 1)
+                .arg(recordCount()));
+}
+
 void FormView::ensureFormWidgetVisible(AbstractFormWidget *fw)
 {
     //this is a bit hacky because form widgets are childs of viewport()
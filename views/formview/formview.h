@@ -16,8 +16,10 @@
 
 #include <QtWidgets/QAbstractItemView>
 #include <QtCore/QList>
+#include <QtCore/QHash>
 
 #include "../../components/metadataengine.h"
+#include "../../utils/searchcontext.h"
 
 
 //-----------------------------------------------------------------------------
@@ -26,7 +28,7 @@
 
 class FormLayoutMatrix;
 class AbstractFormWidget;
-class QPropertyAnimation;
+class QVariantAnimation;
 class DropRectWidget;
 class SelectRectWidget;
 class ResizeDotWidget;
@@ -54,6 +56,9 @@ public:
     /** Reimplemented to call custom view init methods after setting model */
     void setModel(QAbstractItemModel *model);
 
+    /** Reimplemented to invalidate the populated record on model resets */
+    void reset();
+
     /** Get the current row (record) */
     int getCurrentRow();
 
@@ -69,6 +74,19 @@ public:
     /** This reloads all properties and settings related to form view's appearence */
     void reloadAppearanceSettings();
 
+    /**
+     * Set the context of the active search, published by the search
+     * pipeline. Fields matching the search are highlighted while the
+     * model is filtered.
+     */
+    void setSearchContext(const SearchContext &context);
+
+    /**
+     * Delete all cached forms. This must be called when the database
+     * is replaced, because cached forms may not match the new collections.
+     */
+    void clearFormCache();
+
 signals:
     /** Emitted when new field action was triggered from context menu */
     void newFieldSignal();
@@ -153,9 +171,16 @@ protected:
     void mouseDoubleClickEvent(QMouseEvent *event);
 
 private slots:
-    /** Called when the last animation from the animation list is done */
+    /** Called when the layout animation is done */
     void animationsFinished();
 
+    /**
+     * Called for every frame of the layout animation, moves all
+     * form widgets of the queued transitions at once
+     * @param value - the animation progress, from 0 to 1
+     */
+    void layoutAnimationStep(const QVariant &value);
+
     /** Called when data changed in a form widget */
     void formWidgetDataChanged();
 
@@ -197,7 +222,37 @@ private slots:
      */
     void handleFocusChange(QWidget *old, QWidget *now);
 
+    /** Drop the cached form of the current collection, since fields changed */
+    void currentCollectionStructureChanged();
+
 private:
+    /**
+     * A prebuilt form of a collection, kept when switching to
+     * another collection so it can be shown again without
+     * recreating all form widgets and the layout
+     */
+    struct FormCacheEntry {
+        QString tableName; /**< To detect reused collection ids */
+        QList<AbstractFormWidget*> formWidgetList;
+        FormLayoutMatrix *formLayoutMatrix;
+        bool modifiedTrigger;
+        QList<int> modFieldList;
+    };
+
+    /**
+     * Geometry change of a form widget during a layout animation.
+     * Rects are in content coordinates (without scroll offsets),
+     * so they stay valid while the view is scrolled.
+     */
+    struct LayoutTransition {
+        AbstractFormWidget *formWidget;
+        QRect startRect;
+        QRect endRect;
+    };
+
+    /** Max number of cached forms, excluding the current one */
+    static const int FORM_CACHE_SIZE = 4;
+
     /** Initialization steps */
     void initFormView();
 
@@ -249,18 +304,12 @@ private:
       */
     void renderFormLayoutChange(FormLayoutMatrix* newMatrix);
 
-    /** This executes all animation queued in the m_animationList */
+    /** This executes all transitions queued in m_layoutTransitions as one animation */
     void startQueuedAnimations();
 
     /** This stops all active animations */
     void stopAnimations();
 
-    /** Update the animations with new end position values. When scrolling,
-      * SelectRectWidget the animations need to be updates because the end position coordinates
-      * are not valid anymore.
-      */
-    void updateAnimations();
-
     /** This updates the range of the horizontal and vertical scrollbar */
     void updateScrollBars();
 
@@ -282,11 +331,36 @@ private:
     /** Create form widgets (fields) for the currently active collection */
     void createFields();
 
-    /** Removes all form widgets (fields) from FormView */
+    /**
+     * Removes all form widgets (fields) from FormView. The form is
+     * moved to the form cache if it is valid, otherwise it is deleted.
+     */
     void removeFields();
 
-    /** Populate form widgets (fields) for the current row (item) from model */
-    void populateFields();
+    /** Hide the current form and add it to the form cache */
+    void cacheCurrentForm();
+
+    /**
+     * Take the cached form of the specified collection, if any,
+     * and make it the current form
+     * @return whether a cached form has been restored
+     */
+    bool restoreCachedForm(int collectionId);
+
+    /** Delete form widgets and layout of a cached form */
+    void deleteCachedForm(const FormCacheEntry &entry);
+
+    /**
+     * Populate form widgets (fields) for the current row (item) from model.
+     * If a column range is specified, only the fields in that range are
+     * updated, this is used when only some columns changed.
+     * @param firstColumn - the first column to update
+     * @param lastColumn - the last column to update, -1 for all
+     */
+    void populateFields(int firstColumn = 1, int lastColumn = -1);
+
+    /** Get the search context if a search is active, else an inactive one */
+    const SearchContext& activeSearchContext();
 
     /** Clear all form widgets (fields) */
     void clearFields();
@@ -332,6 +406,26 @@ private:
      */
     void updateSelectionModel();
 
+    /**
+     * Fetch rows from the model until the specified row is loaded,
+     * so only the rows up to the shown record are held in memory
+     * @return whether the row exists
+     */
+    bool fetchRow(int row);
+
+    /**
+     * Get the last loaded row. The next rows are fetched only if
+     * the current record is already the last loaded one, so moving to
+     * the end loads one batch at a time instead of the whole table
+     */
+    int lastLoadedRow();
+
+    /** Get the record count without fetching rows */
+    int recordCount();
+
+    /** Show the current record number on the status bar */
+    void showRecordPosition();
+
     /** Scroll to the specified FormWidget */
     void ensureFormWidgetVisible(AbstractFormWidget *fw);
 
@@ -349,7 +443,8 @@ private:
 
     FormLayoutMatrix *m_formLayoutMatrix;         /**< Layout holder for form widgets */
     QList<AbstractFormWidget*> m_formWidgetList;  /**< A list of all form widgets     */
-    QList<QPropertyAnimation*> m_animationList;   /**< A list with queued animation   */
+    QVariantAnimation *m_layoutAnimation;         /**< Drives all layout transitions  */
+    QList<LayoutTransition> m_layoutTransitions;  /**< Queued layout transitions      */
     int m_widthUnitPx;                    /**< Define how many pixels one width layout unit
                                                in the virtual FormView grid is */
     int m_heightUnitPx;                   /**< Define how many pixels one heigth layout unit
@@ -383,6 +478,13 @@ private:
                                  of ModDateType are updated after
                                  changes to records */
     QList<int> m_modFieldList; /**< List of fields with ModDateType as type */
+    int m_populatedRow; /**< The row all fields show, -1 if none or stale */
+    SearchContext m_searchContext; /**< The active search, used for highlighting */
+    int m_formCollectionId; /**< Collection id of the current form,
+                                 0 if the form must not be cached */
+    QHash<int, FormCacheEntry> m_formCache; /**< Cached forms by collection id */
+    QList<int> m_formCacheOrder; /**< Cached collection ids, least
+                                      recently used first */
 
     //context menu actions
     QAction *m_newFieldContextAction;
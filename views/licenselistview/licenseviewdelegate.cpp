@@ -0,0 +1,136 @@
+/*
+ *  Copyright (c) 2017 Giorgio Wicklein <giowckln@gmail.com>
+ */
+
+//-----------------------------------------------------------------------------
+// Hearders
+//-----------------------------------------------------------------------------
+
+#include "licenseviewdelegate.h"
+
+#include <QtWidgets/QAbstractItemView>
+#include <QtWidgets/QApplication>
+#include <QtWidgets/QStyle>
+#include <QtGui/QTextDocument>
+#include <QtGui/QAbstractTextDocumentLayout>
+#include <QtGui/QPainter>
+#include <QtGui/QMouseEvent>
+#include <QtGui/QDesktopServices>
+#include <QtCore/QUrl>
+#include <QtCore/QVariant>
+
+
+//-----------------------------------------------------------------------------
+// Public
+//-----------------------------------------------------------------------------
+
+LicenseViewDelegate::LicenseViewDelegate(QAbstractItemView *view) :
+    QStyledItemDelegate(view), m_view(view),
+    m_documentCache(DOCUMENT_CACHE_SIZE)
+{
+    //the view must have its model set already
+    if (m_view->model())
+        connect(m_view->model(), SIGNAL(modelReset()),
+                this, SLOT(clearDocumentCache()));
+}
+
+LicenseViewDelegate::~LicenseViewDelegate()
+{
+}
+
+void LicenseViewDelegate::paint(QPainter *painter,
+                                const QStyleOptionViewItem &option,
+                                const QModelIndex &index) const
+{
+    QStyleOptionViewItem opt = option;
+    initStyleOption(&opt, index);
+    opt.text = QString(); //text is drawn as html below
+
+    //draw item background (selection, hover)
+    QStyle *style = opt.widget ? opt.widget->style() : QApplication::style();
+    style->drawControl(QStyle::CE_ItemViewItem, &opt, painter, opt.widget);
+
+    QTextDocument *doc = document(index, option.rect.width());
+
+    painter->save();
+    painter->translate(option.rect.topLeft());
+    painter->setClipRect(option.rect.translated(-option.rect.topLeft()));
+    doc->drawContents(painter);
+    painter->restore();
+}
+
+QSize LicenseViewDelegate::sizeHint(const QStyleOptionViewItem &option,
+                                    const QModelIndex &index) const
+{
+    Q_UNUSED(option);
+
+    QTextDocument *doc = document(index, m_view->viewport()->width());
+
+    return QSize(doc->idealWidth(), doc->size().height());
+}
+
+
+//-----------------------------------------------------------------------------
+// Protected
+//-----------------------------------------------------------------------------
+
+bool LicenseViewDelegate::editorEvent(QEvent *event, QAbstractItemModel *model,
+                                      const QStyleOptionViewItem &option,
+                                      const QModelIndex &index)
+{
+    if (event->type() == QEvent::MouseButtonRelease) {
+        QMouseEvent *mouseEvent = static_cast<QMouseEvent*>(event);
+
+        QTextDocument *doc = document(index, option.rect.width());
+
+        QPointF pos = mouseEvent->pos() - option.rect.topLeft();
+        QString anchor = doc->documentLayout()->anchorAt(pos);
+        if (!anchor.isEmpty()) {
+            QDesktopServices::openUrl(QUrl(anchor));
+            return true;
+        }
+    }
+
+    return QStyledItemDelegate::editorEvent(event, model, option, index);
+}
+
+
+//-----------------------------------------------------------------------------
+// Private slots
+//-----------------------------------------------------------------------------
+
+void LicenseViewDelegate::clearDocumentCache()
+{
+    m_documentCache.clear();
+}
+
+
+//-----------------------------------------------------------------------------
+// Private
+//-----------------------------------------------------------------------------
+
+QTextDocument* LicenseViewDelegate::document(const QModelIndex &index,
+                                             int width) const
+{
+    //the cache owns the document, the pointer is valid
+    //until the next insertion
+    QTextDocument *doc = m_documentCache.object(index.row());
+    if (!doc) {
+        doc = new QTextDocument;
+        m_documentCache.insert(index.row(), doc);
+    }
+
+    //the html of a row can change without a reset, so compare it
+    QString html = index.data(Qt::DisplayRole).toString();
+    if ((doc->property("html").toString() != html) ||
+            (doc->defaultFont() != m_view->font())) {
+        doc->setDefaultFont(m_view->font());
+        doc->setHtml(html);
+        doc->setProperty("html", html);
+        doc->setTextWidth(width);
+    } else if (doc->textWidth() != width) {
+        doc->setTextWidth(width);
+    }
+
+    return doc;
+}
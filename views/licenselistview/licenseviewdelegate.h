@@ -0,0 +1,76 @@
+/**
+  * \class LicenseViewDelegate
+  * \brief This delegate renders the html entries of PlantImageLicenseModel
+  *        and opens links when they are clicked. The laid out documents
+  *        of the most recently drawn rows are cached until their html
+  *        or width changes, or the model is reset.
+  * \author Giorgio Wicklein - GIOWISYS Software
+  * \date 19/10/2026
+  */
+
+#ifndef LICENSEVIEWDELEGATE_H
+#define LICENSEVIEWDELEGATE_H
+
+
+//-----------------------------------------------------------------------------
+// Headers
+//-----------------------------------------------------------------------------
+
+#include <QtWidgets/QStyledItemDelegate>
+#include <QtCore/QCache>
+
+
+//-----------------------------------------------------------------------------
+// Forward declarations
+//-----------------------------------------------------------------------------
+
+class QAbstractItemView;
+class QTextDocument;
+
+
+//-----------------------------------------------------------------------------
+// LicenseViewDelegate
+//-----------------------------------------------------------------------------
+
+class LicenseViewDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    explicit LicenseViewDelegate(QAbstractItemView *view);
+    ~LicenseViewDelegate();
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option,
+               const QModelIndex &index) const;
+    QSize sizeHint(const QStyleOptionViewItem &option,
+                   const QModelIndex &index) const;
+
+protected:
+    /** Reimplemented to open clicked links */
+    bool editorEvent(QEvent *event, QAbstractItemModel *model,
+                     const QStyleOptionViewItem &option,
+                     const QModelIndex &index);
+
+private slots:
+    /** Drop all cached documents, rows no longer match */
+    void clearDocumentCache();
+
+private:
+    /**
+     * Return the document of the row of index laid out at width.
+     * The document is created or updated only if the html or
+     * the width changed since the last call for the row
+     */
+    QTextDocument* document(const QModelIndex &index, int width) const;
+
+    static const int DOCUMENT_CACHE_SIZE = 200; /**< Max cached rows,
+                                                  *  a few screens */
+
+    QAbstractItemView *m_view;
+    mutable QCache<int, QTextDocument> m_documentCache; /**< Laid out documents
+                                                          *  by row, least
+                                                          *  recently used are
+                                                          *  dropped first */
+};
+
+#endif // LICENSEVIEWDELEGATE_H
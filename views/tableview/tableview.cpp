@@ -216,21 +216,19 @@ void TableView::saveSectionOrder()
     //save section order
     SettingsManager s;
     QHeaderView *header = horizontalHeader();
-    int id = MetadataEngine::getInstance().getCurrentCollectionId();
+    MetadataEngine *meta = &MetadataEngine::getInstance();
+    int id = meta->getCurrentCollectionId();
     QString collection = QString("collection_") + QString::number(id);
-    QList<int> sectionOrder;
     int columnCount = model()->columnCount();
 
-    for (int i = 1; i < columnCount; i++) { //+1 because of _id column 0
-        sectionOrder.append(header->visualIndex(i));
-    }
-
+    //save field keys in visual order, unlike columns they
+    //stay valid when a field before them is deleted
     QList<QVariant> list;
-    foreach(int i, sectionOrder){
-      list << i;
+    for (int i = 1; i < columnCount; i++) { //+1 because of _id column 0
+        list << meta->getFieldKey(header->logicalIndex(i));
     }
 
-    s.saveProperty("tableview_section_order", collection, list);
+    s.saveProperty("tableview_field_order", collection, list);
 }
 
 void TableView::saveSectionSizes()
@@ -292,19 +290,22 @@ void TableView::restoreSectionOrder()
 
     //restore section order
     SettingsManager s;
-    int id = MetadataEngine::getInstance().getCurrentCollectionId();
+    MetadataEngine *meta = &MetadataEngine::getInstance();
+    int id = meta->getCurrentCollectionId();
     QString collection = QString("collection_") + QString::number(id);
-    QList<int> sectionOrder;
 
     QList<QVariant> list;
-    list = s.restoreProperty("tableview_section_order", collection).toList();
-    foreach(QVariant v, list){
-      sectionOrder << v.toInt();
-    }
+    list = s.restoreProperty("tableview_field_order", collection).toList();
 
-    for (int i = 0; i < sectionOrder.size(); i++) {
-        int visualIndex = header->visualIndex(i+1); //+1 because of _id column 0
-        header->moveSection(visualIndex, sectionOrder.at(i));
+    //place saved fields one after the other, deleted fields are skipped
+    //and fields created after saving stay at the end
+    int visualIndex = 1; //+1 because of _id column 0
+    foreach(QVariant v, list){
+        int column = meta->getFieldColumn(v.toInt());
+        if (column < 1)
+            continue;
+        header->moveSection(header->visualIndex(column), visualIndex);
+        visualIndex++;
     }
 }
 
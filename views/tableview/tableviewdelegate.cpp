@@ -13,6 +13,7 @@
 #include "../../utils/formwidgetvalidator.h"
 #include "../../components/metadataengine.h"
 #include "../../utils/metadatapropertiesparser.h"
+#include "../../utils/fieldformatter.h"
 #include "../../widgets/mainwindow.h"
 #include "../../components/undocommands.h"
 #include "../../components/filemanager.h"
@@ -139,19 +140,9 @@ QWidget* TableViewDelegate::createEditor(QWidget *parent, const QStyleOptionView
                                                              index.column(),
                                                              meta->getCurrentCollectionId());
         MetadataPropertiesParser displayParser(displayProperties);
-        if (displayProperties.size()) {
-            QStringList items = displayParser.getValue("items")
-                    .split(',', QString::SkipEmptyParts);
-            foreach (QString s, items) {
-                //replace some escape codes
-                s.replace("\\comma", ",");
-                s.replace("\\colon", ":");
-                s.replace("\\semicolon", ";");
-                s.replace("\\doublequote", "\"");
-                s.replace("\\singlequote", "'");
-                c->addItem(s);
-            }
-        }
+        if (displayProperties.size())
+            c->addItems(FieldFormatter::comboboxItems(
+                            displayParser.getValue("items")));
 
         e = c;
     }
@@ -200,29 +191,12 @@ QWidget* TableViewDelegate::createEditor(QWidget *parent, const QStyleOptionView
         t->setMinimumDate(QDate(100, 1, 1));
 
         //load date format from display properties
-        QLocale locale;
-        QString dateFormat = locale.dateTimeFormat(QLocale::ShortFormat);
         MetadataEngine *meta = m_metadataEngine;
         QString displayProperties = meta->getFieldProperties(meta->DisplayProperty,
                                                              index.column(),
                                                              meta->getCurrentCollectionId());
         MetadataPropertiesParser parser(displayProperties);
-        if (displayProperties.size()) {
-            QString v;
-            v = parser.getValue("dateFormat");
-            if (v == "1")
-                dateFormat = locale.dateTimeFormat(QLocale::ShortFormat);
-            else if (v == "2")
-                dateFormat = locale.dateFormat(QLocale::ShortFormat);
-            else if (v == "3")
-                dateFormat = "ddd MMM d hh:mm yyyy";
-            else if (v == "4")
-                dateFormat = "ddd MMM d yyyy";
-            else if (v == "5")
-                dateFormat = "yyyy-MM-dd hh:mm";
-            else if (v == "6")
-                dateFormat = "yyyy-MM-dd";
-        }
+        QString dateFormat = FieldFormatter::dateFormat(parser.getValue("dateFormat"));
 
         //setup date time edit
         t->setCalendarPopup(true);
@@ -618,31 +592,13 @@ void TableViewDelegate::paintCreateDateType(QPainter *painter,
                                             const QModelIndex &index) const
 {
     QStyleOptionViewItem opt(option);
-    QLocale locale;
-    QString dateFormat = locale.dateTimeFormat(QLocale::ShortFormat);
 
     //adapt to display properties
     QString metadata =
             m_metadataEngine->getFieldProperties(MetadataEngine::DisplayProperty,
                                                  index.column());
     MetadataPropertiesParser parser(metadata);
-    if (metadata.size() > 0) {
-        QString v;
-
-        v = parser.getValue("dateFormat");
-        if (v == "1")
-            dateFormat = locale.dateTimeFormat(QLocale::ShortFormat);
-        else if (v == "2")
-            dateFormat = locale.dateFormat(QLocale::ShortFormat);
-        else if (v == "3")
-            dateFormat = "ddd MMM d hh:mm yyyy";
-        else if (v == "4")
-            dateFormat = "ddd MMM d yyyy";
-        else if (v == "5")
-            dateFormat = "yyyy-MM-dd hh:mm";
-        else if (v == "6")
-            dateFormat = "yyyy-MM-dd";
-    }
+    QString dateFormat = FieldFormatter::dateFormat(parser.getValue("dateFormat"));
 
     //date as string
     opt.text = index.data().toDateTime().toString(dateFormat);
@@ -707,8 +663,7 @@ void TableViewDelegate::paintComboboxType(QPainter *painter,
         }
 
         //load items from display properties
-        QStringList items = parser.getValue("items")
-                .split(',', QString::SkipEmptyParts);
+        QStringList items = FieldFormatter::comboboxItems(parser.getValue("items"));
 
         //handle default
         v = parser.getValue("default");
@@ -720,13 +675,6 @@ void TableViewDelegate::paintComboboxType(QPainter *painter,
 
         if ((itemId != -1) && (itemId < items.size()))
             itemString = items.at(itemId);
-
-        //replace some escape codes
-        itemString.replace("\\comma", ",");
-        itemString.replace("\\colon", ":");
-        itemString.replace("\\semicolon", ";");
-        itemString.replace("\\doublequote", "\"");
-        itemString.replace("\\singlequote", "'");
     }
 
     opt.text = itemString;
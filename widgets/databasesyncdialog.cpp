@@ -7,18 +7,20 @@
 #include "../components/settingsmanager.h"
 #include "../components/filemanager.h"
 #include "../utils/definitionholder.h"
+#include "../models/plantimagelicensemodel.h"
+#include "../views/licenselistview/licenseviewdelegate.h"
 
 #include <QtWidgets/QStackedWidget>
 #include <QtWidgets/QPushButton>
 #include <QtWidgets/QLabel>
 #include <QtWidgets/QMessageBox>
 #include <QtWidgets/QProgressBar>
+#include <QtWidgets/QListView>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonObject>
 #include <QtCore/QJsonValue>
 #include <QtCore/QFile>
-#include <QtWidgets/QApplication>
 
 #ifdef Q_OS_WIN
 #include <QtWinExtras/QWinTaskbarButton>
@@ -32,6 +34,8 @@ DatabaseSyncDialog::DatabaseSyncDialog(QWidget *parent) :
     m_taskbarProgress(nullptr),
 #endif
     m_updateManager(nullptr),
+    m_fileManager(nullptr),
+    m_licenseModel(nullptr),
     m_latestPlantDbRevision(Q_UINT64_C(0))
 {
     ui->setupUi(this);
@@ -40,6 +44,17 @@ DatabaseSyncDialog::DatabaseSyncDialog(QWidget *parent) :
     ui->licenseAcceptButton->setFocus();
 
     m_updateManager = &UpdateManager::getInstance();
+    m_fileManager = new FileManager(this);
+
+    //image licenses are rendered lazily, laid out in batches
+    m_licenseModel = new PlantImageLicenseModel(m_fileManager->getFilesDirectory(),
+                                                this);
+    ui->imageLicenseListView->setModel(m_licenseModel);
+    ui->imageLicenseListView->setItemDelegate(
+                new LicenseViewDelegate(ui->imageLicenseListView));
+    ui->imageLicenseListView->setLayoutMode(QListView::Batched);
+    ui->imageLicenseListView->setBatchSize(50);
+    ui->imageLicenseListView->setResizeMode(QListView::Adjust);
 
     createConnections();
 }
@@ -69,7 +84,6 @@ void DatabaseSyncDialog::syncCancelButtonClicked()
 void DatabaseSyncDialog::syncNextButtonClicked()
 {
     ui->stackedWidget->setCurrentIndex(2);
-    qApp->processEvents();
 
     //load image licensing info to view
     createImageLicensingAndDisplayResults();
@@ -133,8 +147,7 @@ void DatabaseSyncDialog::plantImgMetadataFileReadySlot()
     ui->syncProgressBar->setRange(0, 0);
 
     //parse json file
-    FileManager fm(this);
-    QFile jsonFile(fm.getPlantImageMetaJsonFilePath());
+    QFile jsonFile(m_fileManager->getPlantImageMetaJsonFilePath());
     bool error = false;
     QString errorMessage = "";
 
@@ -249,6 +262,24 @@ void DatabaseSyncDialog::plantDbEventsRequestCompletedSlot(const QString &html)
     this->setDatabaseDownloadComplete();
 }
 
+void DatabaseSyncDialog::removeUnneededFilesProgressSlot(int done, int total)
+{
+    ui->syncProgressBar->setRange(0, total);
+    ui->syncProgressBar->setValue(done);
+}
+
+void DatabaseSyncDialog::removeUnneededFilesCompletedSlot()
+{
+    ui->downloadingTitleLabel->setText(tr("Download complete!"));
+    ui->syncStatusLabel->setText(tr("Completed!"));
+    ui->syncTotalProgressBar->setRange(0, 100);
+    ui->syncProgressBar->setRange(0, 100);
+    ui->syncTotalProgressBar->setValue(100);
+    ui->syncProgressBar->setValue(100);
+    ui->syncNextButton->setEnabled(true);
+    ui->syncNextButton->setFocus();
+}
+
 void DatabaseSyncDialog::createConnections()
 {
     connect(ui->licenseCancelButton, &QPushButton::clicked,
@@ -295,6 +326,12 @@ void DatabaseSyncDialog::createConnections()
             this, SLOT(plantDbChangelogRequestCompletedSlot(QString)));
     connect(m_updateManager, SIGNAL(plantDbEventsRequestCompleted(QString)),
             this, SLOT(plantDbEventsRequestCompletedSlot(QString)));
+
+    //file manager
+    connect(m_fileManager, SIGNAL(removeUnneededFilesProgress(int,int)),
+            this, SLOT(removeUnneededFilesProgressSlot(int,int)));
+    connect(m_fileManager, SIGNAL(removeUnneededFilesCompleted()),
+            this, SLOT(removeUnneededFilesCompletedSlot()));
 }
 
 void DatabaseSyncDialog::startDatabaseSync()
@@ -321,6 +358,8 @@ void DatabaseSyncDialog::parseImageMetadataJson(const QJsonDocument &jsonDoc)
         m->plantName = obj["name"].toString();
         m->licenseString = obj["license html"].toString();
         m->filename = obj["database file name"].toString();
+        m->fileSize = (qint64) obj.value("file size").toDouble(-1);
+        m->md5Hash = obj["md5 hash"].toString().toLower();
         m_plantImagesList.append(m);
     }
 }
@@ -335,14 +374,24 @@ void DatabaseSyncDialog::clearPlantImagesList()
 
 void DatabaseSyncDialog::downloadPlantImages()
 {
-    //check missing files
+    //check missing or corrupted files
     QStringList filesToDownload;
+    QStringList imageFiles;
+    foreach (UpdateManager::PlantImageMetadata *m, m_plantImagesList) {
+        imageFiles.append(m->filename);
+    }
 
-    FileManager fm(this);
-    QStringList localFileList = fm.getAllLocalFiles();
+    QHash<QString,FileManager::ManifestEntry> localManifest =
+            m_fileManager->localFileManifest(imageFiles);
 
     foreach (UpdateManager::PlantImageMetadata *m, m_plantImagesList) {
-        if (!localFileList.contains(m->filename)) {
+        QHash<QString,FileManager::ManifestEntry>::const_iterator i =
+                localManifest.constFind(m->filename);
+        if (i == localManifest.constEnd()) {
+            filesToDownload.append(m->filename);
+        } else if ((m->fileSize >= 0) && (i->size != m->fileSize)) {
+            filesToDownload.append(m->filename);
+        } else if ((!m->md5Hash.isEmpty()) && (i->md5Hash != m->md5Hash)) {
             filesToDownload.append(m->filename);
         }
     }
@@ -355,50 +404,18 @@ void DatabaseSyncDialog::setDatabaseDownloadComplete()
     SettingsManager sm;
     sm.saveLastPlantDatabaseSyncAborted(false);
 
-    //remove obsolete files
+    //remove obsolete files in background,
+    //see removeUnneededFilesCompletedSlot()
     ui->syncStatusLabel->setText(tr("Removing old files..."));
-    qApp->processEvents();
-    FileManager fm(this);
-    QString filesDir = fm.getFilesDirectory();
-    QStringList obsoleteFileList = fm.unneededLocalFileList();
-    foreach (QString s, obsoleteFileList) {
-        QFile::remove(filesDir + s);
-    }
-
-    ui->downloadingTitleLabel->setText(tr("Download complete!"));
-    ui->syncStatusLabel->setText(tr("Completed!"));
-    ui->syncTotalProgressBar->setRange(0, 100);
-    ui->syncProgressBar->setRange(0, 100);
-    ui->syncTotalProgressBar->setValue(100);
-    ui->syncProgressBar->setValue(100);
-    ui->syncNextButton->setEnabled(true);
-    ui->syncNextButton->setFocus();
+    m_fileManager->startRemoveUnneededFiles();
 }
 
 void DatabaseSyncDialog::createImageLicensingAndDisplayResults()
 {
-    //create html string
-    FileManager fm(this);
-    QString filesDir = fm.getFilesDirectory();
-    QString htmlString;
-    htmlString.append("<table>");
-    foreach (UpdateManager::PlantImageMetadata *p, m_plantImagesList) {
-        htmlString.append("<tr><td>");
-#ifdef Q_OS_WIN
-        htmlString.append("<a href=\"file:///" + filesDir + p->filename);
-#else
-        htmlString.append("<a href=\"file://" + filesDir + p->filename);
-#endif
-        htmlString.append(tr("\">Click<br />to view</a></td>"));
-        htmlString.append("<td><b>" + p->plantName + "</b><br />");
-        htmlString.append(p->licenseString);
-        htmlString.append("<br />" + p->filename + "<br />");
-        htmlString.append("</td></tr>");
-        qApp->processEvents();
-    }
-    htmlString.append("</table>");
-
-    ui->imageLicenseLabel->setText(htmlString);
+    //entry html is created on demand by the model
+    //and the view lays out rows in batches
+    m_licenseModel->clear();
+    m_licenseModel->appendImages(m_plantImagesList);
 
     ui->imageLicenseNextButton->setEnabled(true);
     ui->imageLicenseNextButton->setFocus();
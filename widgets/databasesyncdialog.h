@@ -18,6 +18,8 @@ class DatabaseSyncDialog;
 #ifdef Q_OS_WIN
 class QWinTaskbarProgress;
 #endif
+class FileManager;
+class PlantImageLicenseModel;
 
 class DatabaseSyncDialog : public QDialog
 {
@@ -46,6 +48,8 @@ private slots:
     void allImageFilesDownloadedSlot();
     void plantDbChangelogRequestCompletedSlot(const QString &html);
     void plantDbEventsRequestCompletedSlot(const QString &html);
+    void removeUnneededFilesProgressSlot(int done, int total);
+    void removeUnneededFilesCompletedSlot();
 
 private:
     void createConnections();
@@ -61,6 +65,8 @@ private:
     QWinTaskbarProgress *m_taskbarProgress;
 #endif
     UpdateManager *m_updateManager;
+    FileManager *m_fileManager;
+    PlantImageLicenseModel *m_licenseModel;
     quint64 m_latestPlantDbRevision;
     QList<UpdateManager::PlantImageMetadata*> m_plantImagesList;
 };
@@ -190,7 +190,9 @@ void ComboboxFieldWizard::removeItemButtonClicked()
         QString tableName = meta->getTableName(collectionId);
         m_pendingSqlStatements.append(
                     QString("UPDATE \"%1\" SET \"%2\"=NULL WHERE \"%2\"=%3")
-                    .arg(tableName).arg(fieldId).arg(itemId));
+                    .arg(tableName)
+                    .arg(meta->getFieldKey(fieldId, collectionId))
+                    .arg(itemId));
 
         //hide item from list (but don't remove, otherwise item ids gets messed up)
         QListWidgetItem *item = ui->itemsListWidget->item(itemId);
@@ -235,7 +237,7 @@ void ComboboxFieldWizard::defaultItemChanged()
             //and new records with NULL (default) will use the new value
             m_pendingDefaultSqlStatement =
                     QString("UPDATE \"%1\" SET \"%2\"=%3 WHERE \"%2\" IS NULL")
-                    .arg(tableName).arg(fieldId).arg(m_default);
+                    .arg(tableName).arg(meta->getFieldKey(fieldId, collectionId)).arg(m_default);
         }
     }
 
@@ -257,7 +259,7 @@ void ComboboxFieldWizard::clearDefaultItemSlot()
             //and new records with NULL (default) will use the new value
             m_pendingDefaultSqlStatement =
                     QString("UPDATE \"%1\" SET \"%2\"=%3 WHERE \"%2\" IS NULL")
-                    .arg(tableName).arg(fieldId).arg(m_default);
+                    .arg(tableName).arg(meta->getFieldKey(fieldId, collectionId)).arg(m_default);
         }
     }
 
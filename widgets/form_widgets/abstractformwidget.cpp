@@ -69,8 +69,8 @@ bool AbstractFormWidget::operator != (const AbstractFormWidget& other) const
     return !(*this == other);
 }
 
-bool AbstractFormWidget::showHighlightSearchResults(const QString &searchString)
+bool AbstractFormWidget::showHighlightSearchResults(const SearchContext &context)
 {
-    Q_UNUSED(searchString);
+    Q_UNUSED(context);
     return false;
 }
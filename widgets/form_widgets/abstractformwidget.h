@@ -27,6 +27,7 @@
 
 class QString;
 class QVariant;
+class SearchContext;
 
 
 //-----------------------------------------------------------------------------
@@ -108,13 +109,14 @@ public:
       */
     bool operator!= (const AbstractFormWidget& other) const;
 
-    /** Highlight the form widget or its contents if the searched string is matched.
+    /** Highlight the form widget or its contents if the active search matches.
      * Default implementation returns false, implement if applicable.
-     * If no match is found, make sure to clear any highlighted state.
-     * @param searchString - the string to match against the data
+     * If no match is found or the search is not active,
+     * make sure to clear any highlighted state.
+     * @param context - the active search, with terms to match against the data
      * @return bool - if the data was found (matched) or not
      */
-    virtual bool showHighlightSearchResults(const QString& searchString);
+    virtual bool showHighlightSearchResults(const SearchContext &context);
 
 signals:
     /** Emitted when content data has been edited */
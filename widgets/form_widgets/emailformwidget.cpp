@@ -9,6 +9,7 @@
 #include "emailformwidget.h"
 #include "../../utils/platformcolorservice.h"
 #include "../../utils/metadatapropertiesparser.h"
+#include "../../utils/searchcontext.h"
 #include "../../utils/formwidgetvalidator.h"
 #include "../../components/metadataengine.h"
 
@@ -88,9 +89,9 @@ QVariant EmailFormWidget::getData() const
     return m_lineEdit->text();
 }
 
-bool EmailFormWidget::showHighlightSearchResults(const QString &searchString)
+bool EmailFormWidget::showHighlightSearchResults(const SearchContext &context)
 {
-    bool r = m_lineEdit->text().contains(searchString, Qt::CaseInsensitive);
+    bool r = context.matches(m_lineEdit->text());
     QString highLightCSS = "QLabel {"
                            "background: yellow; }"
                            "QLineEdit { color: red; }";
@@ -43,7 +43,7 @@ public:
     void clearData();
     void setData(const QVariant &data);
     QVariant getData() const;
-    bool showHighlightSearchResults(const QString &searchString);
+    bool showHighlightSearchResults(const SearchContext &context);
 
     /**
      * Supported display properties are:
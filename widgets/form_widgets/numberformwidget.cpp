@@ -9,6 +9,7 @@
 #include "numberformwidget.h"
 #include "../../utils/platformcolorservice.h"
 #include "../../utils/metadatapropertiesparser.h"
+#include "../../utils/searchcontext.h"
 #include "../../utils/formwidgetvalidator.h"
 #include "../../components/metadataengine.h"
 
@@ -124,9 +125,9 @@ QVariant NumberFormWidget::getData() const
         return ""; //empty value
 }
 
-bool NumberFormWidget::showHighlightSearchResults(const QString &searchString)
+bool NumberFormWidget::showHighlightSearchResults(const SearchContext &context)
 {
-    bool r = m_lineEdit->text().contains(searchString, Qt::CaseInsensitive);
+    bool r = context.matches(m_lineEdit->text());
     QString highLightCSS = "QLabel {"
                            "background: yellow; }"
                            "QLineEdit { color: red; }";
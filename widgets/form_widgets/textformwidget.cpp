@@ -10,6 +10,7 @@
 #include "../../widgets/textarea.h"
 #include "../../utils/platformcolorservice.h"
 #include "../../utils/metadatapropertiesparser.h"
+#include "../../utils/searchcontext.h"
 #include "../../utils/formwidgetvalidator.h"
 #include "../../components/metadataengine.h"
 
@@ -97,9 +98,10 @@ QVariant TextFormWidget::getData() const
         return m_lineEdit->text();
 }
 
-bool TextFormWidget::showHighlightSearchResults(const QString &searchString)
+bool TextFormWidget::showHighlightSearchResults(const SearchContext &context)
 {
-    bool r = getData().toString().contains(searchString, Qt::CaseInsensitive);
+    QList<SearchContext::Match> matches = context.findMatches(getData().toString());
+    bool r = !matches.isEmpty();
     QString highLightCSS = "QLabel {"
                            "background: yellow; }"
                            "QLineEdit { color: red; }";
@@ -115,25 +117,22 @@ bool TextFormWidget::showHighlightSearchResults(const QString &searchString)
         static QTextCharFormat defaultFormat = m_textArea->currentCharFormat();
         m_textArea->setCurrentCharFormat(defaultFormat);
 
-        //highlight text area
+        //highlight text area, the text area holds plain text
+        //so match positions are document positions
         QTextDocument *document = m_textArea->document();
         QTextCursor highlightCursor(document);
         QTextCursor cursor(document);
 
         cursor.beginEditBlock();
 
-        QTextCharFormat plainFormat(highlightCursor.charFormat());
-        QTextCharFormat colorFormat = plainFormat;
+        QTextCharFormat colorFormat(highlightCursor.charFormat());
         colorFormat.setForeground(Qt::red);
 
-        while (!highlightCursor.isNull() && !highlightCursor.atEnd()) {
-            highlightCursor = document->find(searchString, highlightCursor);
-
-            if (!highlightCursor.isNull()) {
-                highlightCursor.movePosition(QTextCursor::WordRight,
-                                             QTextCursor::KeepAnchor);
-                highlightCursor.mergeCharFormat(colorFormat);
-            }
+        foreach (const SearchContext::Match &m, matches) {
+            highlightCursor.setPosition(m.position);
+            highlightCursor.setPosition(m.position + m.length,
+                                        QTextCursor::KeepAnchor);
+            highlightCursor.mergeCharFormat(colorFormat);
         }
 
         cursor.endEditBlock();
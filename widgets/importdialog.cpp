@@ -0,0 +1,294 @@
+/*
+ *  Copyright (c) 2017 Giorgio Wicklein <giowckln@gmail.com>
+ */
+
+//-----------------------------------------------------------------------------
+// Hearders
+//-----------------------------------------------------------------------------
+
+#include "importdialog.h"
+#include "ui_importdialog.h"
+#include "../components/importmanager.h"
+#include "../components/metadataengine.h"
+#include "../components/databasemanager.h"
+#include "../utils/csvparser.h"
+
+#include <QtWidgets/QFileDialog>
+#include <QtWidgets/QMessageBox>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QFileInfo>
+#include <QtCore/QFile>
+#include <QtCore/QTextCodec>
+#include <QtSql/QSqlQuery>
+
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+#define TYPE_SAMPLE_ROWS 200
+
+
+//-----------------------------------------------------------------------------
+// Public
+//-----------------------------------------------------------------------------
+
+ImportDialog::ImportDialog(QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::ImportDialog),
+    m_collectionId(0),
+    m_recordCount(0),
+    m_importCanceled(false)
+{
+    ui->setupUi(this);
+
+    //components
+    m_importManager = new ImportManager(this);
+
+    //text encodings
+    QStringList codecs;
+    codecs << "UTF-8" << "UTF-16" << "ISO-8859-1" << "ISO-8859-15"
+           << "windows-1252";
+    QString localeCodec = QTextCodec::codecForLocale()->name();
+    if (!codecs.contains(localeCodec, Qt::CaseInsensitive))
+        codecs.append(localeCodec);
+    ui->encodingCombo->addItems(codecs);
+
+    //connections
+    connect(ui->cancelButton, SIGNAL(clicked()),
+            this, SLOT(reject()));
+    connect(ui->importCancelButton, SIGNAL(clicked()),
+            this, SLOT(reject()));
+    connect(ui->nextButton, SIGNAL(clicked()),
+            this, SLOT(nextButtonClicked()));
+    connect(ui->backCSVButton, SIGNAL(clicked()),
+            this, SLOT(backCSVButtonClicked()));
+    connect(ui->collectionNameLineEdit, SIGNAL(textChanged(QString)),
+            this, SLOT(updateImportButton()));
+    connect(ui->importCSVButton, SIGNAL(clicked()),
+            this, SLOT(importCSVButtonClicked()));
+
+    //import connections
+    connect(m_importManager, SIGNAL(progressSignal(int,int)),
+            this, SLOT(progressSlot(int,int)));
+    connect(m_importManager, SIGNAL(importTaskFailed(QString)),
+            this, SLOT(importTaskFailed(QString)));
+    connect(m_importManager, SIGNAL(importCompleted(int)),
+            this, SLOT(importCompletedSlot(int)));
+    connect(m_importManager, SIGNAL(importCanceled()),
+            this, SLOT(importCanceledSlot()));
+}
+
+ImportDialog::~ImportDialog()
+{
+    delete ui;
+}
+
+int ImportDialog::importedCollectionId() const
+{
+    return m_collectionId;
+}
+
+int ImportDialog::importedRecordCount() const
+{
+    return m_recordCount;
+}
+
+
+//-----------------------------------------------------------------------------
+// Public slots
+//-----------------------------------------------------------------------------
+
+void ImportDialog::reject()
+{
+    //stop task, the partial import is removed
+    //by importCanceledSlot() once the task stopped
+    if (m_importManager->isImportRunning()) {
+        m_importCanceled = true;
+        ui->importCancelButton->setEnabled(false);
+        m_importManager->stopImportTask();
+        return;
+    }
+
+    deleteCollection();
+    QDialog::reject();
+}
+
+
+//-----------------------------------------------------------------------------
+// Private slots
+//-----------------------------------------------------------------------------
+
+void ImportDialog::nextButtonClicked()
+{
+    QString file = QFileDialog::getOpenFileName(
+                this, tr("Import"),
+                QStandardPaths::standardLocations(
+                    QStandardPaths::DocumentsLocation).at(0),
+                tr("CSV files (*.csv *.tsv *.txt);;All files (*)"));
+    if (file.isEmpty()) return;
+    m_filePath = file;
+
+    QFileInfo info(m_filePath);
+    ui->collectionNameLineEdit->setText(info.completeBaseName());
+
+    //guess separator from the first line
+    int separatorIndex = 0;
+    QFile f(m_filePath);
+    if (f.open(QIODevice::ReadOnly)) {
+        QString line = QString::fromUtf8(f.readLine());
+        if (line.count('\t') > qMax(line.count(','), line.count(';')))
+            separatorIndex = 2;
+        else if (line.count(';') > line.count(','))
+            separatorIndex = 1;
+    }
+    ui->separatorCombo->setCurrentIndex(separatorIndex);
+
+    ui->stackedWidget->setCurrentIndex(1);
+}
+
+void ImportDialog::backCSVButtonClicked()
+{
+    ui->stackedWidget->setCurrentIndex(0);
+}
+
+void ImportDialog::updateImportButton()
+{
+    bool enabled = !ui->collectionNameLineEdit->text().trimmed().isEmpty();
+    ui->importCSVButton->setEnabled(enabled);
+}
+
+void ImportDialog::importCSVButtonClicked()
+{
+    QList<int> fieldColumns = createCollection();
+    if (fieldColumns.isEmpty()) {
+        importTaskFailed(tr("The file is empty or can't be read."));
+        return;
+    }
+
+    ui->stackedWidget->setCurrentIndex(2);
+    ui->progressBar->setRange(0, 0);
+
+    m_importManager->startImport(m_filePath, m_collectionId, fieldColumns,
+                                 currentSeparator(),
+                                 ui->encodingCombo->currentText().toLatin1());
+}
+
+void ImportDialog::progressSlot(int currentStep, int totalSteps)
+{
+    ui->progressBar->setRange(0, totalSteps);
+    ui->progressBar->setValue(currentStep);
+}
+
+void ImportDialog::importTaskFailed(const QString &error)
+{
+    deleteCollection();
+
+    QMessageBox box(QMessageBox::Critical, tr("Import Failed"),
+                    tr("Failed to import the file:<br>%1").arg(error),
+                    QMessageBox::NoButton,
+                    this);
+    box.setWindowModality(Qt::WindowModal);
+    box.exec();
+
+    QDialog::reject();
+}
+
+void ImportDialog::importCompletedSlot(int recordCount)
+{
+    //completed before the cancel request was seen
+    if (m_importCanceled) {
+        importCanceledSlot();
+        return;
+    }
+
+    m_recordCount = recordCount;
+    accept();
+}
+
+void ImportDialog::importCanceledSlot()
+{
+    deleteCollection();
+    QDialog::reject();
+}
+
+
+//-----------------------------------------------------------------------------
+// Private
+//-----------------------------------------------------------------------------
+
+QChar ImportDialog::currentSeparator() const
+{
+    switch (ui->separatorCombo->currentIndex()) {
+    case 1:
+        return ';';
+    case 2:
+        return '\t';
+    default:
+        return ',';
+    }
+}
+
+QList<int> ImportDialog::createCollection()
+{
+    QList<int> fieldColumns;
+
+    //read field names and a sample of rows
+    QFile file(m_filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return fieldColumns;
+
+    CsvParser parser(&file, currentSeparator(),
+                     ui->encodingCombo->currentText().toLatin1());
+    QStringList header;
+    if (!parser.readRow(header))
+        return fieldColumns;
+
+    QList<QStringList> samples;
+    QStringList fields;
+    for (int i = 0; i < header.size(); i++)
+        samples.append(QStringList());
+    while ((parser.rowCount() <= TYPE_SAMPLE_ROWS) && parser.readRow(fields)) {
+        for (int i = 0; (i < fields.size()) && (i < header.size()); i++)
+            samples[i].append(fields.at(i));
+    }
+    file.close();
+
+    MetadataEngine *meta = &MetadataEngine::getInstance();
+    QSqlDatabase db = DatabaseManager::getInstance().getDatabase();
+    QSqlQuery query(db);
+
+    //add entry to the collection list
+    query.prepare("INSERT INTO collections (name) VALUES (:name)");
+    query.bindValue(":name", ui->collectionNameLineEdit->text().trimmed());
+    if (!query.exec())
+        return fieldColumns;
+    m_collectionId = meta->createNewCollection();
+
+    //a field for each CSV column
+    for (int i = 0; i < header.size(); i++) {
+        QString name = header.at(i).trimmed();
+        if (name.isEmpty())
+            name = tr("Field %1").arg(i + 1);
+
+        MetadataEngine::FieldType type = ImportTask::detectFieldType(samples.at(i));
+        fieldColumns.append(meta->createField(name, type, "", "", "",
+                                              m_collectionId));
+    }
+
+    return fieldColumns;
+}
+
+void ImportDialog::deleteCollection()
+{
+    if (!m_collectionId) return;
+
+    MetadataEngine::getInstance().deleteCollection(m_collectionId);
+
+    QSqlQuery query(DatabaseManager::getInstance().getDatabase());
+    query.prepare("DELETE FROM collections WHERE _id=:id");
+    query.bindValue(":id", m_collectionId);
+    query.exec();
+
+    m_collectionId = 0;
+}
@@ -0,0 +1,85 @@
+/**
+  * \class ImportDialog
+  * \brief This dialog is used to import a CSV/TSV file into a new
+  *        collection. A field is created for each CSV column, named by
+  *        the first row, with a type guessed from a sample of rows.
+  *        Records are imported by ImportManager on a worker thread.
+  * \author Giorgio Wicklein - GIOWISYS Software
+  * \date 19/10/2026
+  */
+
+#ifndef IMPORTDIALOG_H
+#define IMPORTDIALOG_H
+
+
+//-----------------------------------------------------------------------------
+// Headers
+//-----------------------------------------------------------------------------
+
+#include <QtWidgets/QDialog>
+
+
+//-----------------------------------------------------------------------------
+// Forward declarations
+//-----------------------------------------------------------------------------
+
+namespace Ui {
+class ImportDialog;
+}
+
+class ImportManager;
+
+
+//-----------------------------------------------------------------------------
+// ImportDialog
+//-----------------------------------------------------------------------------
+
+class ImportDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit ImportDialog(QWidget *parent = 0);
+    ~ImportDialog();
+
+    /** Return the id of the imported collection, 0 if none */
+    int importedCollectionId() const;
+
+    /** Return the count of imported records */
+    int importedRecordCount() const;
+
+public slots:
+    void reject();
+
+private slots:
+    void nextButtonClicked();
+    void backCSVButtonClicked();
+    void updateImportButton();
+    void importCSVButtonClicked();
+    void progressSlot(int currentStep, int totalSteps);
+    void importTaskFailed(const QString &error);
+    void importCompletedSlot(int recordCount);
+    void importCanceledSlot();
+
+private:
+    /** Return the selected field separator */
+    QChar currentSeparator() const;
+
+    /**
+     * Create a new collection with a field for each CSV column
+     * @return the collection columns of the created fields
+     */
+    QList<int> createCollection();
+
+    /** Delete the collection created for a failed or canceled import */
+    void deleteCollection();
+
+    Ui::ImportDialog *ui;
+    ImportManager *m_importManager;
+    QString m_filePath;
+    int m_collectionId;
+    int m_recordCount;
+    bool m_importCanceled; /**< Cancel requested while importing */
+};
+
+#endif // IMPORTDIALOG_H
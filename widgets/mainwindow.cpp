@@ -12,16 +12,21 @@
 #include "viewtoolbarwidget.h"
 #include "dockwidget.h"
 #include "../utils/definitionholder.h"
+#include "../utils/searchcontext.h"
 #include "../components/settingsmanager.h"
 #include "../components/metadataengine.h"
 #include "../components/databasemanager.h"
 #include "../components/filemanager.h"
+#include "../components/filechangetracker.h"
+#include "../components/stallmonitor.h"
+#include "../components/exportmanager.h"
 #include "../components/undocommands.h"
 #include "../models/standardmodel.h"
 #include "../views/collectionlistview/collectionlistview.h"
 #include "field_widgets/addfielddialog.h"
 #include "preferencesdialog.h"
 #include "backupdialog.h"
+#include "importdialog.h"
 #include "printdialog.h"
 #include "aboutdialog.h"
 #include "databasesyncdialog.h"
@@ -42,9 +47,12 @@
 #include <QtCore/QTimer>
 #include <QtWidgets/QMessageBox>
 #include <QtWidgets/QProgressDialog>
+#include <QtWidgets/QFileDialog>
 #include <QtWidgets/QUndoStack>
 #include <QtGui/QDesktopServices>
 #include <QtCore/QUrl>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QEventLoop>
 
 
 //-----------------------------------------------------------------------------
@@ -95,6 +103,8 @@ MainWindow::~MainWindow()
     detachCollectionModelView();
     delete m_settingsManager;
 
+    FileChangeTracker::destroy();
+    StallMonitor::destroy();
     m_metadataEngine->destroy();
     DatabaseManager::destroy();
     m_updateManager->destroy();
@@ -199,6 +209,7 @@ void MainWindow::preferenceActionTriggered()
         qApp->processEvents();
 
         QString fullDbPath = DatabaseManager::getInstance().getDatabasePath();
+        QString syncStateDbPath = DatabaseManager::getInstance().getSyncStateDatabasePath();
 
         //detach views
         detachModelFromViews();
@@ -214,6 +225,7 @@ void MainWindow::preferenceActionTriggered()
         //delete db
         QFile::remove(fullDbPath);
         QFile::remove(fullDbPath + ".backup"); //passiflora, rm possible backup
+        QFile::remove(syncStateDbPath);
         pd->setValue(4);
         qApp->processEvents();
 
@@ -307,6 +319,9 @@ void MainWindow::currentCollectionIdChanged(int collectionId)
     if (m_formView && m_currentModel) {
         int recordId = m_collectionSessionIndexMap[collectionId];
         if (recordId != 0) {
+            while ((m_currentModel->rowCount() <= recordId) &&
+                   m_currentModel->canFetchMore(QModelIndex()))
+                m_currentModel->fetchMore(QModelIndex());
             QModelIndex index = m_formView->model()->index(recordId, 1);
             if (index.isValid())
                 m_tableView->setCurrentIndex(index);
@@ -379,7 +394,8 @@ void MainWindow::newRecordActionTriggered()
         sModel->addRecord(); //add e new empty record
 
         //create undo action
-        QUndoCommand *cmd = new NewRecordCommand;
+        NewRecordCommand *cmd = new NewRecordCommand;
+        reserveUndoBudget(cmd->byteSize());
         m_undoStack->push(cmd);
 
         statusBar()->showMessage(tr("New record created"));
@@ -424,11 +440,12 @@ void MainWindow::duplicateRecordActionTriggered()
         if (index.isValid()) {
             m_formView->setFocus(); //clear focus from form widgets to avoid edit events
 
+            sModel->duplicateRecord(row); //add duplicated record of row
+
             //create undo action
-            QUndoCommand *cmd = new DuplicateRecordCommand(row);
+            DuplicateRecordCommand *cmd = new DuplicateRecordCommand;
+            reserveUndoBudget(cmd->byteSize());
             m_undoStack->push(cmd);
-
-            sModel->duplicateRecord(row); //add duplicated record of row
             statusBar()->showMessage(tr("Record %1 duplicated").arg(row+1));
 
             //FIXME: temporary workaround for Qt5
@@ -450,7 +467,12 @@ void MainWindow::duplicateRecordActionTriggered()
         }
         int rowsSize = rows.size();
 
-        bool canUndo = rowsSize <= 100;
+        //duplicates are as large as their originals, so they
+        //can be undone if the originals fit in the undo budget
+        int collectionId = m_metadataEngine->getCurrentCollectionId();
+        QList<int> sourceIds = RecordSnapshot::recordIdsAtRows(rows.toList());
+        bool canUndo = RecordSnapshot::estimateByteSize(collectionId, sourceIds)
+                <= RecordSnapshot::UNDO_BYTE_BUDGET;
         if (!canUndo) {
             //ask for confirmation
             QMessageBox box(QMessageBox::Question, tr("Duplicate Record"),
@@ -464,9 +486,6 @@ void MainWindow::duplicateRecordActionTriggered()
             if (r == QMessageBox::No) return;
         }
 
-        //create main undo action
-        QUndoCommand *mainUndoCommand = new QUndoCommand(tr("record duplication"));
-
         //init progress dialog
         QProgressDialog progressDialog(tr("Duplicating record 0 of %1")
                                        .arg(rows.size()),
@@ -479,6 +498,9 @@ void MainWindow::duplicateRecordActionTriggered()
         progressDialog.show();
         int progress = 0;
 
+        //duplicates get ids after the current last one
+        int lastRecordId = RecordSnapshot::lastRecordId(collectionId);
+
         //duplicate selected rows
         m_currentModel->blockSignals(true); //speed up
         DatabaseManager::getInstance().beginTransaction(); //speed up writes
@@ -492,11 +514,6 @@ void MainWindow::duplicateRecordActionTriggered()
                                         .arg(progress)
                                         .arg(rowsSize));
 
-            if (canUndo) {
-                //create child undo command
-                new DuplicateRecordCommand(row, mainUndoCommand);
-            }
-
             //duplicate
             sModel->duplicateRecord(row);
         }
@@ -504,8 +521,12 @@ void MainWindow::duplicateRecordActionTriggered()
         m_currentModel->blockSignals(false);
 
         if (canUndo) {
-            //setup main undo command
-            m_undoStack->push(mainUndoCommand);
+            //one undo command saves all duplicates at once
+            QList<int> recordIds = RecordSnapshot::recordIdsAfter(collectionId,
+                                                                  lastRecordId);
+            DuplicateRecordCommand *cmd = new DuplicateRecordCommand(recordIds);
+            reserveUndoBudget(cmd->byteSize());
+            m_undoStack->push(cmd);
         } else {
             m_undoStack->clear();
         }
@@ -553,14 +574,19 @@ void MainWindow::deleteRecordActionTriggered()
         int currentRow = m_formView->getCurrentRow();
         QModelIndex index = m_currentModel->index(currentRow, 0);
         if (index.isValid()) {
+            StallMonitor::Operation operation("delete");
             m_formView->setFocus(); //clear focus from form widgets to avoid edit events
 
-            //create undo action
-            QUndoCommand *cmd = new DeleteRecordCommand(index.row());
-            m_undoStack->push(cmd);
-
-            //remove
-            m_currentModel->removeRow(index.row());
+            //create undo action and remove
+            DeleteRecordCommand *cmd = new DeleteRecordCommand(
+                        QList<int>() << index.row());
+            if (cmd->isUndoable()) {
+                pushDeleteRecordCommand(cmd);
+            } else {
+                cmd->redo();
+                delete cmd;
+                m_undoStack->clear();
+            }
 
             //FIXME: temporary workaround for Qt5
             //views should atomatically update but don't
@@ -583,7 +609,10 @@ void MainWindow::deleteRecordActionTriggered()
                                               QItemSelectionModel::ClearAndSelect |
                                               QItemSelectionModel::Rows);
 
-        bool canUndo = rows.size() <= 100;
+        //save deleted records for undo, if within the undo budget
+        DeleteRecordCommand *cmd = new DeleteRecordCommand(rows.toList());
+        bool canUndo = cmd->isUndoable();
+
         if (canUndo) {
             //ask for confirmation
             QMessageBox box(QMessageBox::Question, tr("Delete Record"),
@@ -593,7 +622,10 @@ void MainWindow::deleteRecordActionTriggered()
             box.setDefaultButton(QMessageBox::Yes);
             box.setWindowModality(Qt::WindowModal);
             int r = box.exec();
-            if (r == QMessageBox::No) return;
+            if (r == QMessageBox::No) {
+                delete cmd;
+                return;
+            }
         } else {
             //ask for confirmation
             QMessageBox box(QMessageBox::Question, tr("Delete Record"),
@@ -604,70 +636,28 @@ void MainWindow::deleteRecordActionTriggered()
             box.setDefaultButton(QMessageBox::Yes);
             box.setWindowModality(Qt::WindowModal);
             int r = box.exec();
-            if (r == QMessageBox::No) return;
-        }
-
-        //create main undo action
-        QUndoCommand *mainUndoCommand = new QUndoCommand(tr("record deletion"));
-
-        //init progress dialog
-        QProgressDialog progressDialog(tr("Deleting record 0 of %1")
-                                       .arg(rows.size()),
-                                       tr("Cancel"), 1,
-                                       rows.size(), this);
-        progressDialog.setWindowModality(Qt::WindowModal);
-        progressDialog.setWindowTitle(tr("Progress"));
-#ifdef Q_OS_WIN
-        //workaroung for windows bug where dialog remains hidden sometimes
-        progressDialog.setMinimumDuration(0);
-        progressDialog.show();
-#endif // Q_OS_WIN
-        int progress = 0;
-
-        //remove selected rows
-        m_currentModel->blockSignals(true); //speed up
-        DatabaseManager::getInstance().beginTransaction(); //speed up writes
-
-        //sort rows in a list so that removing from bottom to top works
-        QList<int> rowList = rows.toList();
-        qSort(rowList.begin(), rowList.end());
-        int rowListSize = rowList.size();
-        for (int i = rowListSize - 1; i >= 0; i--) {
-#ifdef Q_OS_WIN
-            //workaroung for windows bug where dialog remains hidden sometimes
-            qApp->processEvents();
-#endif // Q_OS_WIN
-            if (progressDialog.wasCanceled())
-                break;
-            progressDialog.setValue(++progress);
-            progressDialog.setLabelText(tr("Deleting record %1 of %2")
-                                        .arg(progress)
-                                        .arg(rowListSize));
-            int r = rowList.at(i);
-
-            if (canUndo) {
-                //create child undo command
-                new DeleteRecordCommand(r, mainUndoCommand);
-            } else {
-                m_undoStack->clear();
+            if (r == QMessageBox::No) {
+                delete cmd;
+                return;
             }
-
-            //remove
-            m_currentModel->removeRow(r);
         }
-        DatabaseManager::getInstance().endTransaction();
-        m_currentModel->blockSignals(false);
 
+        //remove selected records with a single statement
+        StallMonitor::Operation operation("delete");
+        int deletedCount = cmd->recordCount();
         if (canUndo) {
-            //setup main undo command
-            m_undoStack->push(mainUndoCommand);
+            pushDeleteRecordCommand(cmd);
+        } else {
+            cmd->redo();
+            delete cmd;
+            m_undoStack->clear();
         }
 
         //update views (hard way)
         attachModelToViews(m_metadataEngine->getCurrentCollectionId());
 
         //status message
-        statusBar()->showMessage(tr("%1 record(s) deleted").arg(progress));
+        statusBar()->showMessage(tr("%1 record(s) deleted").arg(deletedCount));
 
         //select record before deleted items
         int previousRecord = 0;
@@ -707,6 +697,7 @@ void MainWindow::deleteAllRecordsActionTriggered()
     int r = box.exec();
     if (r == QMessageBox::No) return;
 
+    StallMonitor::Operation operation("delete");
     int id = m_metadataEngine->getCurrentCollectionId();
     m_metadataEngine->deleteAllRecords(id);
 
@@ -884,6 +875,8 @@ void MainWindow::deleteFieldActionTriggered()
         if (r == QMessageBox::No) return;
     }
 
+    StallMonitor::Operation operation("delete");
+
     //check field deletion trigger actions
     CollectionFieldCleaner cleaner(this);
     cleaner.cleanField(m_metadataEngine->getCurrentCollectionId(),
@@ -927,6 +920,7 @@ void MainWindow::searchSlot(const QString &s)
 {
     if (!m_metadataEngine->getCurrentCollectionId()) return;
 
+    StallMonitor::Operation operation("search");
     QString key(s);
 
     //set to table view mode
@@ -951,10 +945,10 @@ void MainWindow::searchSlot(const QString &s)
     if (sModel) {
         int count = m_metadataEngine->getFieldCount();
 
-        //generate filter (where clause)
-        QString filter;
-        if (count > 0) {
-            filter.append(QString("\"1\" LIKE '%%2%'").arg(key));
+        //list searchable fields
+        QList<int> searchFields;
+        if (count > 1) {
+            searchFields.append(1);
         }
         for (int i = 2; i < count; i++) { //start with 2 cause 0 is _id and 1 done
             switch(m_metadataEngine->getFieldType(i)) {
@@ -969,12 +963,31 @@ void MainWindow::searchSlot(const QString &s)
                 //exclude field type from search results
                 break;
             default:
-                filter.append(QString(" OR \"%1\" LIKE '%%2%'")
-                              .arg(i).arg(key));
+                searchFields.append(i);
                 break;
             }
         }
-        if (!s.isEmpty())
+
+        //generate filter (where clause),
+        //each term must match at least one field
+        QStringList termFilters;
+        foreach (const QString &term, SearchContext(key).getTerms()) {
+            QStringList fieldFilters;
+            foreach (int field, searchFields) {
+                fieldFilters.append(QString("\"%1\" LIKE '%%2%'")
+                                    .arg(m_metadataEngine->getFieldKey(field))
+                                    .arg(term));
+            }
+            if (!fieldFilters.isEmpty())
+                termFilters.append("(" + fieldFilters.join(" OR ") + ")");
+        }
+        QString filter = termFilters.join(" AND ");
+
+        //publish search for highlighting,
+        //terms as typed because fields show localized numbers
+        m_formView->setSearchContext(SearchContext(QString(s).remove('\'')));
+
+        if (!filter.isEmpty())
             sModel->setFilter(filter);
         else
             sModel->setFilter(""); //clear filter
@@ -986,9 +999,6 @@ void MainWindow::searchSlot(const QString &s)
                 index,
                 QItemSelectionModel::SelectCurrent);
     m_formView->setEnabled(index.isValid());
-
-    //clear undo stack cause row ids are not longer valid
-    m_undoStack->clear();
 }
 
 void MainWindow::selectAllActionTriggered()
@@ -998,19 +1008,19 @@ void MainWindow::selectAllActionTriggered()
     //set form view
     tableViewModeTriggered();
 
-    //select all
-    QModelIndex p;
-    QModelIndex topLeft = m_currentModel->index(0, 1, p);
-    QModelIndex bottomRight = m_currentModel->index(
-                m_currentModel->rowCount(p)-1,
-                m_currentModel->columnCount(p)-1,
-                p);
-    QItemSelection selection(topLeft, bottomRight);
-    m_formView->selectionModel()->select(selection, QItemSelectionModel::Select);
+    //assuming StandardModel only
+    StandardModel *sModel = qobject_cast<StandardModel*>(m_currentModel);
+    if (!sModel) return;
+
+    //select all, including records not fetched yet
+    m_formView->selectionModel()->select(sModel->allRecordsSelection(),
+                                         QItemSelectionModel::Select);
 }
 
 void MainWindow::backupActionTriggered()
 {
+    StallMonitor::Operation operation("backup");
+
     //detach views
     detachModelFromViews();
     detachCollectionModelView();
@@ -1036,6 +1046,115 @@ void MainWindow::backupActionTriggered()
     }
 }
 
+void MainWindow::importActionTriggered()
+{
+    StallMonitor::Operation operation("import");
+
+    //detach views, records are added by a separate connection
+    detachModelFromViews();
+    detachCollectionModelView();
+    int id = m_metadataEngine->getCurrentCollectionId();
+
+    ImportDialog dialog(this);
+    dialog.exec();
+
+    //attach views, the model is reset once for all imported records
+    attachCollectionModelView();
+    if (dialog.importedCollectionId()) {
+        m_metadataEngine->setCurrentCollectionId(dialog.importedCollectionId());
+        statusBar()->showMessage(tr("%1 record(s) imported")
+                                 .arg(dialog.importedRecordCount()));
+    } else {
+        m_metadataEngine->setCurrentCollectionId(id);
+    }
+}
+
+void MainWindow::exportActionTriggered()
+{
+    StandardModel *sModel = qobject_cast<StandardModel*>(m_currentModel);
+    if (!sModel)
+        return;
+
+    QString selectedFilter;
+    QString fileName = QFileDialog::getSaveFileName(
+                this, tr("Export"),
+                QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation),
+                tr("CSV (*.csv);;JSON Lines (*.jsonl)"),
+                &selectedFilter);
+    if (fileName.isEmpty())
+        return;
+
+    ExportTask::ExportFormat format = ExportTask::CsvFormat;
+    QString suffix = ".csv";
+    if (selectedFilter.contains("jsonl")) {
+        format = ExportTask::JsonLinesFormat;
+        suffix = ".jsonl";
+    }
+    if (!fileName.endsWith(suffix, Qt::CaseInsensitive))
+        fileName.append(suffix);
+
+    //in table view, export only the selected records if more than one
+    QList<int> recordIdList;
+    if (m_currentViewMode == TableViewMode) {
+        QModelIndexList indexes = m_tableView->selectionModel()->selectedIndexes();
+        QSet<int> rows;
+        int indexesSize = indexes.size();
+        for (int i = 0; i < indexesSize; i++) {
+            rows.insert(indexes.at(i).row());
+        }
+
+        if (rows.size() > 1) {
+            foreach (int row, rows) {
+                bool ok;
+                int recordId = m_currentModel->index(row, 0).data().toInt(&ok);
+                if (ok)
+                    recordIdList.append(recordId);
+            }
+        }
+    }
+
+    StallMonitor::Operation operation("export");
+
+    //records are read by a separate connection, the current
+    //search filter restricts the export to the search results
+    ExportManager exportManager;
+    QProgressDialog progressDialog(tr("Exporting records..."),
+                                   tr("Cancel"), 0, 0, this);
+    progressDialog.setWindowModality(Qt::WindowModal);
+    progressDialog.setMinimumDuration(500);
+    QEventLoop loop;
+
+    connect(&exportManager, SIGNAL(progressRangeSignal(int,int)),
+            &progressDialog, SLOT(setRange(int,int)));
+    connect(&exportManager, SIGNAL(progressSignal(int)),
+            &progressDialog, SLOT(setValue(int)));
+    connect(&progressDialog, SIGNAL(canceled()),
+            &exportManager, SLOT(stopExportTask()));
+    connect(&exportManager, SIGNAL(exportFinished()),
+            &loop, SLOT(quit()));
+
+    exportManager.startExport(fileName,
+                              m_metadataEngine->getCurrentCollectionId(),
+                              format,
+                              sModel->filter(),
+                              recordIdList);
+    loop.exec();
+    progressDialog.reset();
+
+    if (!exportManager.errorMessage().isEmpty()) {
+        QMessageBox box(QMessageBox::Critical, tr("Export Failed"),
+                        tr("Export failed: %1")
+                        .arg(exportManager.errorMessage()),
+                        QMessageBox::NoButton,
+                        this);
+        box.setWindowModality(Qt::WindowModal);
+        box.exec();
+    } else if (!exportManager.wasCanceled()) {
+        statusBar()->showMessage(tr("%1 record(s) exported")
+                                 .arg(exportManager.exportedRecordCount()));
+    }
+}
+
 void MainWindow::printActionTriggered()
 {
     if ((!m_currentModel) || (!m_currentModel->rowCount())) {
@@ -1085,6 +1204,7 @@ void MainWindow::printActionTriggered()
     }
 
     //print dialog
+    StallMonitor::Operation operation("print");
     PrintDialog d(m_metadataEngine->getCurrentCollectionId(),
                   recordIdList,
                   this);
@@ -1135,6 +1255,8 @@ void MainWindow::plantDatabaseUpdateSlot()
 
 void MainWindow::syncDatabaseActionTriggered()
 {
+    StallMonitor::Operation operation("sync");
+
     //detach views
     detachModelFromViews();
     detachCollectionModelView();
@@ -1142,6 +1264,10 @@ void MainWindow::syncDatabaseActionTriggered()
     DatabaseSyncDialog d(this);
     d.exec();
 
+    //the database file may have been replaced,
+    //reload cached metadata
+    m_metadataEngine->setDirtyCurrentColleectionId();
+
     //attach views
     attachCollectionModelView();
     m_metadataEngine->setCurrentCollectionId(m_metadataEngine->getCurrentCollectionId());
@@ -1191,6 +1317,12 @@ void MainWindow::createActions()
     m_backupAction = new QAction(tr("Backup..."), this);
     m_backupAction->setStatusTip(tr("Backup or restore a database file"));
 
+    m_importAction = new QAction(tr("Import..."), this);
+    m_importAction->setStatusTip(tr("Import a CSV file as new collection"));
+
+    m_exportAction = new QAction(tr("Export..."), this);
+    m_exportAction->setStatusTip(tr("Export records to a CSV or JSON Lines file"));
+
     m_settingsAction = new QAction(tr("Preferences"), this);
     m_settingsAction->setMenuRole(QAction::PreferencesRole);
     m_settingsAction->setShortcut(QKeySequence::Preferences);
@@ -1332,6 +1464,8 @@ void MainWindow::createMenu()
     m_fileMenu->addMenu(m_newMenu);
     m_fileMenu->addSeparator();
     m_fileMenu->addAction(m_backupAction);
+    m_fileMenu->addAction(m_importAction);
+    m_fileMenu->addAction(m_exportAction);
     m_fileMenu->addSeparator();
     m_fileMenu->addAction(m_printAction);
     m_fileMenu->addSeparator();
@@ -1396,6 +1530,23 @@ void MainWindow::createComponents()
     m_settingsManager = new SettingsManager;
     m_metadataEngine = &MetadataEngine::getInstance();
     m_undoStack = new QUndoStack(this);
+
+    //track file changes for sync, unless disabled
+    QVariant trackChanges = m_settingsManager->restoreProperty("changeTracker",
+                                                               "fileManager");
+    if (!trackChanges.isValid() || trackChanges.toBool()) {
+        FileManager fm;
+        FileChangeTracker::getInstance().start(fm.getFilesDirectory());
+    }
+
+    //optional event loop stall monitor, the value is the threshold in ms
+    QByteArray stallThreshold = qgetenv("PASSIFLORA_STALL_MONITOR");
+    if (!stallThreshold.isEmpty()) {
+        QString dataDir = QStandardPaths::standardLocations(
+                    QStandardPaths::DataLocation).at(0);
+        StallMonitor::getInstance().start(dataDir + "/stalls.log",
+                                          stallThreshold.toInt());
+    }
 }
 
 void MainWindow::createCentralWidget()
@@ -1452,6 +1603,10 @@ void MainWindow::createConnections()
             this, SLOT(selectAllActionTriggered()));
     connect(m_backupAction, SIGNAL(triggered()),
             this, SLOT(backupActionTriggered()));
+    connect(m_importAction, SIGNAL(triggered()),
+            this, SLOT(importActionTriggered()));
+    connect(m_exportAction, SIGNAL(triggered()),
+            this, SLOT(exportActionTriggered()));
     connect(m_checkUpdatesAction, SIGNAL(triggered()),
             this, SLOT(checkForUpdatesSlot()));
     connect(m_printAction, SIGNAL(triggered()),
@@ -1612,18 +1767,15 @@ void MainWindow::attachModelToViews(const int collectionId)
         return;
     }
 
-    //if there are other collection type supported
-    //add the code here to find the correct collection type
-    //for now only standard type is supported
-    MetadataEngine::CollectionType type = MetadataEngine::StandardCollection;
+    MetadataEngine::CollectionType type =
+            m_metadataEngine->getCollectionType(collectionId);
 
     //create model
     m_currentModel = m_metadataEngine->createModel(type, collectionId);
     if (!m_currentModel) return;
 
-    //fetch all data from model (avoid lazy loading at startup)
-    while(m_currentModel->canFetchMore(QModelIndex()))
-        m_currentModel->fetchMore(QModelIndex());
+    //rows are fetched lazily by the views, only the first
+    //page is loaded here to keep large collections fast to open
 
     //set model on views
     m_formView->setModel(m_currentModel);
@@ -1642,6 +1794,30 @@ void MainWindow::attachModelToViews(const int collectionId)
     m_lastUsedCollectionId = collectionId;
 }
 
+void MainWindow::pushDeleteRecordCommand(DeleteRecordCommand *cmd)
+{
+    reserveUndoBudget(cmd->byteSize());
+
+    //pushing the command deletes the records
+    m_undoStack->push(cmd);
+}
+
+void MainWindow::reserveUndoBudget(qint64 bytes)
+{
+    //drop the undo history if record snapshots would exceed the budget
+    for (int i = 0; i < m_undoStack->count(); i++) {
+        const QUndoCommand *c = m_undoStack->command(i);
+        if (const DeleteRecordCommand *d = dynamic_cast<const DeleteRecordCommand*>(c))
+            bytes += d->byteSize();
+        else if (const DuplicateRecordCommand *u = dynamic_cast<const DuplicateRecordCommand*>(c))
+            bytes += u->byteSize();
+        else if (const NewRecordCommand *n = dynamic_cast<const NewRecordCommand*>(c))
+            bytes += n->byteSize();
+    }
+    if (bytes > RecordSnapshot::UNDO_BYTE_BUDGET)
+        m_undoStack->clear();
+}
+
 void MainWindow::detachModelFromViews()
 {
     //save form view if form widget has focus
@@ -1668,6 +1844,10 @@ void MainWindow::attachCollectionModelView()
 
 void MainWindow::detachCollectionModelView()
 {
+    //the database may be replaced,
+    //so cached forms may become invalid
+    m_formView->clearFormCache();
+
     //collection list view
     CollectionListView *cv = m_dockWidget->getCollectionListView();
     QAbstractItemModel *cm = cv->model();
@@ -37,6 +37,7 @@ class MetadataEngine;
 class AddFieldDialog;
 class QUndoStack;
 class UpdateManager;
+class DeleteRecordCommand;
 
 
 //-----------------------------------------------------------------------------
@@ -105,6 +106,8 @@ private slots:
     void searchSlot(const QString &s);
     void selectAllActionTriggered();
     void backupActionTriggered();
+    void importActionTriggered();
+    void exportActionTriggered();
     void printActionTriggered();
     void syncDatabaseActionTriggered();
     void checkDatabaseUpdateActionTriggered();
@@ -134,6 +137,20 @@ private:
      */
     void attachModelToViews(const int collectionId);
 
+    /**
+     * Push a record deletion to the undo stack, which executes it.
+     * If the record snapshots on the stack would exceed the undo
+     * byte budget, the stack is cleared first.
+     */
+    void pushDeleteRecordCommand(DeleteRecordCommand *cmd);
+
+    /**
+     * Clear the undo stack if its record snapshots together with
+     * the specified number of bytes exceed the undo byte budget.
+     * All record commands (new, duplicate, delete) are counted.
+     */
+    void reserveUndoBudget(qint64 bytes);
+
     /**
      * This methods detaches the model for the currently active
      * collection from the views. Then the model is deleted.
@@ -168,6 +185,8 @@ private:
     QAction *m_newRecordAction;
     QAction *m_newFieldAction;
     QAction *m_backupAction;
+    QAction *m_importAction;
+    QAction *m_exportAction;
     QAction *m_settingsAction;
     QAction *m_undoAction;
     QAction *m_redoAction;
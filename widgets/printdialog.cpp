@@ -10,24 +10,17 @@
 #include "ui_printdialog.h"
 
 #include "../components/metadataengine.h"
-#include "../components/databasemanager.h"
-#include "../components/filemanager.h"
 #include "../components/settingsmanager.h"
-#include "../utils/metadatapropertiesparser.h"
+#include "../components/printengine.h"
 #include "../utils/definitionholder.h"
 
-#include <QtSql/QSqlQuery>
 #include <QtWidgets/QFileDialog>
-#include <QtGui/QDesktopServices>
+#include <QtWidgets/QMessageBox>
 #include <QPrintDialog>
 #include <QPrinter>
-#include <QtGui/QTextDocument>
 #include <QtCore/QDateTime>
-#include <QtCore/QJsonDocument>
-#include <QtCore/QJsonArray>
-#include <QtCore/QJsonObject>
-#include <QtCore/QJsonValue>
-#include <QtCore/QFile>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QThread>
 
 
 //-----------------------------------------------------------------------------
@@ -41,7 +34,8 @@ PrintDialog::PrintDialog(const int collectionId,
     ui(new Ui::PrintDialog),
     m_recordList(selectionRecordIdList),
     m_collectionId(collectionId),
-    m_printCancelled(false)
+    m_printEngine(0),
+    m_printThread(0)
 {
     ui->setupUi(this);
 
@@ -74,6 +68,16 @@ PrintDialog::PrintDialog(const int collectionId,
 
 PrintDialog::~PrintDialog()
 {
+    //wait for a running pdf export, quit here because
+    //queued events can't reach this blocked thread
+    if (m_printThread) {
+        m_printEngine->cancel();
+        m_printThread->quit();
+        m_printThread->wait();
+        delete m_printThread;
+    }
+    delete m_printEngine;
+
     delete ui;
 }
 
@@ -101,8 +105,7 @@ void PrintDialog::pdfButtonClicked()
     if (!fileName.contains(".pdf", Qt::CaseInsensitive))
         fileName.append(".pdf");
 
-    initRecordListToPrint();
-    print(true, fileName);
+    printToPdf(fileName);
 }
 
 void PrintDialog::printButtonClicked()
@@ -110,73 +113,76 @@ void PrintDialog::printButtonClicked()
     ui->stackedWidget->setCurrentIndex(1);
     qApp->processEvents();
 
-    initRecordListToPrint();
     print();
 }
 
 void PrintDialog::cancelPrintButtonClicked()
 {
-    m_printCancelled = true;
+    if (m_printEngine)
+        m_printEngine->cancel();
 }
 
-
-//-----------------------------------------------------------------------------
-// Private
-//-----------------------------------------------------------------------------
-
-void PrintDialog::initRecordListToPrint()
+void PrintDialog::printProgressSlot(int done, int total)
 {
-    //if all records selected init list
-    if (ui->allRecordsRadio->isChecked()) {
-        m_recordList.clear();
-
-        QString tableName = m_metadataEngine->getTableName(m_collectionId);
-        QSqlDatabase db = DatabaseManager::getInstance().getDatabase();
-        QSqlQuery query(db);
-
-        //get all record ids for current collection
-        QString sql = QString("SELECT _id FROM %1").arg(tableName);
-        query.exec(sql);
-
-        while (query.next()) {
-            bool ok;
-            int id = query.value(0).toInt(&ok);
-            if (ok)
-                m_recordList.append(id);
-        }
-    }
+    ui->progressBar->setRange(0, total);
+    ui->progressBar->setValue(done);
 
-    ui->progressBar->setRange(1, m_recordList.size());
-    ui->progressBar->setValue(1);
-    m_printedPlantImages.clear();
+    //keep ui responsive if printing from the gui thread
+    if (!m_printThread)
+        qApp->processEvents();
 }
 
-void PrintDialog::print(bool pdf, QString pdfOutputPath)
+void PrintDialog::pdfFinishedSlot(bool success)
 {
-    QPrinter printer;
-    QTextDocument document(this);
-    QString htmlString;
-    QString tableName = m_metadataEngine->getTableName(m_collectionId);
-    QSqlDatabase db = DatabaseManager::getInstance().getDatabase();
-    QSqlQuery query(db);
+    bool cancelled = m_printEngine->isCancelled();
+
+    m_printThread->wait();
+    delete m_printThread;
+    m_printThread = 0;
+    delete m_printEngine;
+    m_printEngine = 0;
 
-    if (pdf) {
-        printer.setOutputFileName(pdfOutputPath);
-        printer.setOutputFormat(QPrinter::PdfFormat);
+    if (success) {
+        accept(); //close
     } else {
-        QPrintDialog printDialog(&printer, this);
-        if (printDialog.exec() != QDialog::Accepted) {
-            ui->stackedWidget->setCurrentIndex(0);
-            return;
+        if (!cancelled) {
+            QMessageBox::critical(this, tr("PDF Error"),
+                                  tr("Failed to write the PDF file."));
         }
+        reject();
     }
+}
+
+
+//-----------------------------------------------------------------------------
+// Private
+//-----------------------------------------------------------------------------
+
+PrintEngine* PrintDialog::createPrintEngine()
+{
+    PrintEngine *engine = new PrintEngine(m_collectionId,
+                                          m_recordList,
+                                          ui->allRecordsRadio->isChecked());
+    engine->setHeaderHtml(headerHtml());
+
+    ui->progressBar->setRange(0, 1);
+    ui->progressBar->setValue(0);
+
+    connect(engine, SIGNAL(progressSignal(int,int)),
+            this, SLOT(printProgressSlot(int,int)));
+
+    return engine;
+}
 
+QString PrintDialog::headerHtml()
+{
     //license info
     QString licenseUserName, le, lc;
     SettingsManager sm;
     sm.restoreLicenseKey(lc, licenseUserName, le);
 
     //init html
+    QString htmlString;
     htmlString.append(tr(
                           "<html>"
                           "<head>"
@@ -212,380 +218,47 @@ void PrintDialog::print(bool pdf, QString pdfOutputPath)
                       .arg(QDateTime::currentDateTime().toString("yyyy"))
                       .arg(tr("HP Hans Gerhard Wicklein")));
 
-    //get all record to print
-    QString recordListString;
-    foreach (int id, m_recordList) {
-        recordListString.append(QString::number(id) + ",");
-    }
-    //remove last ','
-    recordListString.remove(recordListString.size()-1, 1);
-    QString sql = QString("SELECT * FROM %1 WHERE _id IN (%2)")
-            .arg(tableName).arg(recordListString);
-    query.exec(sql);
-
-    //generate text
-    while (query.next()) {
-        htmlString.append("<table>");
-
-        int fieldCount = m_metadataEngine->getFieldCount(m_collectionId);
-        for (int i = 1; i < fieldCount; i++) { // 1 because of _id
-            htmlString.append("<tr>");
-            htmlString.append(QString("<td>%1:</td>")
-                              .arg(m_metadataEngine->getFieldName(i, m_collectionId)));
-            htmlString.append("<td>");
-
-            MetadataEngine::FieldType type = m_metadataEngine->getFieldType(i, m_collectionId);
-            switch (type) {
-            case MetadataEngine::TextType:
-            case MetadataEngine::URLTextType:
-            case MetadataEngine::EmailTextType:
-                htmlString.append(textTypeItemHtml(query.value(i), i));
-                break;
-            case MetadataEngine::NumericType:
-                htmlString.append(numericTypeItemHtml(query.value(i), i));
-                break;
-            case MetadataEngine::CreationDateType:
-            case MetadataEngine::ModDateType:
-            case MetadataEngine::DateType:
-                htmlString.append(dateTypeItemHtml(query.value(i), i));
-                break;
-            case MetadataEngine::CheckboxType:
-                htmlString.append(checkboxTypeItemHtml(query.value(i), i));
-                break;
-            case MetadataEngine::ComboboxType:
-                htmlString.append(comboboxTypeItemHtml(query.value(i), i));
-                break;
-            case MetadataEngine::ProgressType:
-                htmlString.append(progressTypeItemHtml(query.value(i), i));
-                break;
-            case MetadataEngine::ImageType:
-                htmlString.append(imageTypeItemHtml(query.value(i), i));
-                break;
-            case MetadataEngine::FilesType:
-                htmlString.append(filesTypeItemHtml(query.value(i), i));
-                break;
-            default:
-                htmlString.append(textTypeItemHtml(query.value(i), i));
-                break;
-            }
-
-            htmlString.append("</td>");
-            htmlString.append("</tr>");
-        }
-
-        htmlString.append("</table><br /><hr />");
-
-        ui->progressBar->setValue(ui->progressBar->value()+1);
-        qApp->processEvents();
-        if (m_printCancelled) {
-            reject();
-            return;
-        }
-    }
-
-    //add image licensing
-    htmlString.append(generateImgLicensingInfo());
-
-    //finalize html
-    htmlString.append("</body></html>");
-
-    //print
-    document.setHtml(htmlString);
-    document.print(&printer);
-
-    accept(); //close
+    return htmlString;
 }
 
-QString PrintDialog::textTypeItemHtml(const QVariant &data, int fieldId)
+void PrintDialog::print()
 {
-    Q_UNUSED(fieldId);
-
-    return data.toString();
-}
-
-QString PrintDialog::numericTypeItemHtml(const QVariant &data, int fieldId)
-{
-    QString html;
-    html.append("<span style=\"");
-
-    QString dataString;
-    bool empty = data.toString().isEmpty();
-
-    //adapt to display properties
-    QString metadata =
-            m_metadataEngine->getFieldProperties(MetadataEngine::DisplayProperty,
-                                                 fieldId);
-    MetadataPropertiesParser parser(metadata);
-    QString v;
-
-    v = parser.getValue("markNegative");
-    if ((v == "1") && (data.toDouble() < 0.0)) {
-        html.append("color:red;");
-    }
-
-    int precision;
-    v = parser.getValue("precision");
-    precision = v.toInt();
-
-    v = parser.getValue("displayMode");
-    if (v == "auto") {
-        if (!empty)
-            dataString = data.toString();
-    } else if (v == "decimal") {
-        if (!empty)
-            dataString = QString::number(data.toDouble(), 'f', precision);
-    } else if (v == "scientific") {
-        if (!empty)
-            dataString = QString::number(data.toDouble(), 'e', precision);
-    } else {
-        if (!empty)
-            dataString = data.toString(); //if display mode not specified
-    }
-
-    //make use of the correct decimal point char
-    QLocale locale;
-    dataString.replace(".", locale.decimalPoint());
-
-    html.append("\">");
-    html.append(dataString);
-    html.append("</span>");
-
-    return html;
-}
-
-QString PrintDialog::dateTypeItemHtml(const QVariant &data, int fieldId)
-{
-    QLocale locale;
-    QString dateFormat = locale.dateTimeFormat(QLocale::ShortFormat);
-
-    //adapt to display properties
-    QString metadata =
-            m_metadataEngine->getFieldProperties(MetadataEngine::DisplayProperty,
-                                                 fieldId);
-    MetadataPropertiesParser parser(metadata);
-    if (metadata.size() > 0) {
-        QString v;
-
-        v = parser.getValue("dateFormat");
-        if (v == "1")
-            dateFormat = locale.dateTimeFormat(QLocale::ShortFormat);
-        else if (v == "2")
-            dateFormat = locale.dateFormat(QLocale::ShortFormat);
-        else if (v == "3")
-            dateFormat = "ddd MMM d hh:mm yyyy";
-        else if (v == "4")
-            dateFormat = "ddd MMM d yyyy";
-        else if (v == "5")
-            dateFormat = "yyyy-MM-dd hh:mm";
-        else if (v == "6")
-            dateFormat = "yyyy-MM-dd";
-    }
-
-    return data.toDateTime().toString(dateFormat);
-}
-
-QString PrintDialog::checkboxTypeItemHtml(const QVariant &data, int fieldId)
-{
-    Q_UNUSED(fieldId);
-
-    QString html;
-    bool checked = data.toInt();
-
-    if(checked)
-        html.append(tr("Yes"));
-    else
-        html.append(tr("No"));
-
-    return html;
-}
-
-QString PrintDialog::comboboxTypeItemHtml(const QVariant &data, int fieldId)
-{
-    bool ok;
-    int itemId = data.toInt(&ok);
-    if (!ok) itemId = -1;
-    QString itemString;
-
-    //adapt to display properties
-    QString metadata =
-            m_metadataEngine->getFieldProperties(MetadataEngine::DisplayProperty,
-                                                 fieldId);
-    MetadataPropertiesParser parser(metadata);
-    if (metadata.size() > 0) {
-        QString v;
-
-        //load items from display properties
-        QStringList items = parser.getValue("items")
-                .split(',', QString::SkipEmptyParts);
-
-        //handle default
-        v = parser.getValue("default");
-        if ((!v.isEmpty()) && (itemId == -1)) {
-            bool ok;
-            itemId = v.toInt(&ok);
-            if (!ok) itemId = -1;
-        }
-
-        if ((itemId != -1) && (itemId < items.size()))
-            itemString = items.at(itemId);
-
-        //replace some escape codes
-        itemString.replace("\\comma", ",");
-        itemString.replace("\\colon", ":");
-        itemString.replace("\\semicolon", ";");
-        itemString.replace("\\doublequote", "\"");
-        itemString.replace("\\singlequote", "'");
-    }
-
-    return itemString;
-}
+    QPrinter printer;
 
-QString PrintDialog::progressTypeItemHtml(const QVariant &data, int fieldId)
-{
-    QString html;
-
-    int max = 100;
-    int value = data.toInt();
-
-    //display properties
-    QString metadata =
-            m_metadataEngine->getFieldProperties(MetadataEngine::DisplayProperty,
-                                                 fieldId);
-    MetadataPropertiesParser parser(metadata);
-    if (metadata.size() > 0) {
-        max = parser.getValue("max").toInt();
+    QPrintDialog printDialog(&printer, this);
+    if (printDialog.exec() != QDialog::Accepted) {
+        ui->stackedWidget->setCurrentIndex(0);
+        return;
     }
 
-    //calc percentage
-    int percentage = (((double) value) / max) * 100.0;
-    html.append(QString::number(percentage) + "%");
-
-    return html;
-}
+    m_printEngine = createPrintEngine();
+    bool success = m_printEngine->render(&printer);
+    bool cancelled = m_printEngine->isCancelled();
+    delete m_printEngine;
+    m_printEngine = 0;
 
-QString PrintDialog::imageTypeItemHtml(const QVariant &data, int fieldId)
-{
-    Q_UNUSED(fieldId);
-
-    QString html;
-    int fileId = data.toInt();
-    if (fileId) {
-        QString filePath;
-        QString fileName;
-        QString fileHash;
-        QDateTime addedDateTime;
-        FileManager fm;
-
-        m_metadataEngine->getContentFile(fileId,
-                                         fileName,
-                                         fileHash,
-                                         addedDateTime);
-
-        filePath = fm.getFilesDirectory() + fileHash;
-
-        //calc size
-        QPixmap pixmap(filePath);
-        QSize pixmapSize = pixmap.size();
-        QSize newSize(256, 256);
-        QRect imageRect = pixmap.scaled(QSize(256, 256),
-                                        Qt::KeepAspectRatio,
-                                        Qt::FastTransformation).rect();
-        if ((newSize.width() > pixmapSize.width()) &&
-                (newSize.height() > pixmapSize.height())) {
-            newSize = pixmapSize;
-        } else {
-            newSize = QSize(imageRect.width(), imageRect.height());
-        }
-
-        html.append(QString("<img border=\"0\" src=\"%1\" width=\"%2\" height=\"%3\">")
-                    .arg(filePath).arg(newSize.width()).arg(newSize.height()));
-
-        //save image hash to list for later licensing info
-        m_printedPlantImages.append(fileHash);
+    if (success) {
+        accept(); //close
+    } else if (cancelled) {
+        reject();
+    } else {
+        ui->stackedWidget->setCurrentIndex(0);
     }
-
-    return html;
-}
-
-QString PrintDialog::filesTypeItemHtml(const QVariant &data, int fieldId)
-{
-    Q_UNUSED(fieldId);
-
-    QString dataString = data.toString();
-
-    int fileCount = dataString.split(',', QString::SkipEmptyParts).size();
-    //opt.text = tr("%n file(s)", "", fileCount);
-    //BUG workaround: investigate why it doesn't work (http://qt-project.org/doc/qt-4.8/i18n-source-translation.html#handling-plurals)
-    QString countString = (fileCount == 1 )? tr("%1 file").arg(fileCount) :
-                                             tr("%1 files").arg(fileCount);
-
-    return countString;
 }
 
-QString PrintDialog::generateImgLicensingInfo()
+void PrintDialog::printToPdf(const QString &pdfOutputPath)
 {
-    QString html = "";
-
-    if (!m_printedPlantImages.isEmpty()) {
-
-        //init progress
-        ui->progressBar->setRange(0, m_printedPlantImages.size());
-        ui->progressBar->setValue(0);
-        qApp->processEvents();
-
-        //init html
-        html.append(tr("<p class=\"header\">The contained images are under the following "
-                       "licensing conditions: <br />"));
-
-        //parse json file
-        FileManager fm(this);
-        QFile jsonFile(fm.getPlantImageMetaJsonFilePath());
-        bool error = false;
-        QString errorMessage = "";
-        QJsonDocument jsonDoc;
-
-        if (!jsonFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            error = true;
-            errorMessage.append(tr("Filed to open image metadata json file. "));
-        } else {
-            QString raw = jsonFile.readAll();
-            jsonDoc = QJsonDocument::fromJson(raw.toUtf8());
-            jsonFile.close();
-            if (jsonDoc.isNull()) {
-                error = true;
-                errorMessage.append(tr("Invalid json format. "));
-            }
-        }
-        if (error) {
-            return errorMessage;
-        }
-
-        QJsonObject jsonObject = jsonDoc.object();
-        QJsonArray jsonArray = jsonObject["plant"].toArray();
-
-        foreach (const QJsonValue &value, jsonArray) {
-            QJsonObject obj = value.toObject();
-            QString plantName = obj["name"].toString();
-            QString licenseHtml = obj["license html"].toString();
-            QString fileName = obj["database file name"].toString();
-
-            if (m_printedPlantImages.contains(fileName)) {
-                html.append("<br /><b>" + plantName + "</b><br />");
-                html.append(licenseHtml);
-                html.append("<br />" + fileName + "<br />");
-            }
-
-            //update progress
-            ui->progressBar->setValue(ui->progressBar->value()+1);
-            qApp->processEvents();
-            if (m_printCancelled) {
-                reject();
-            }
-        }
-    }
-
-    //html outro
-    html.append("</p>");
-
-    return html;
+    m_printEngine = createPrintEngine();
+    m_printEngine->setPdfOutputPath(pdfOutputPath);
+
+    //render in worker thread
+    m_printThread = new QThread;
+    m_printEngine->moveToThread(m_printThread);
+    connect(m_printThread, SIGNAL(started()),
+            m_printEngine, SLOT(renderPdf()));
+    connect(m_printEngine, SIGNAL(finishedSignal(bool)),
+            m_printThread, SLOT(quit()), Qt::DirectConnection);
+    connect(m_printEngine, SIGNAL(finishedSignal(bool)),
+            this, SLOT(pdfFinishedSlot(bool)));
+    m_printThread->start();
 }
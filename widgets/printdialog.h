@@ -1,6 +1,8 @@
 /**
   * \class PrintDialog
   * \brief This dialog is used to print or save to PDF records.
+  *        Rendering is done page by page by PrintEngine, PDF output
+  *        is written from a worker thread.
   * \author Giorgio Wicklein - GIOWISYS Software
   * \date 12/11/2012
   */
@@ -25,6 +27,8 @@ class PrintDialog;
 }
 
 class MetadataEngine;
+class PrintEngine;
+class QThread;
 
 
 //-----------------------------------------------------------------------------
@@ -51,26 +55,21 @@ private slots:
     void pdfButtonClicked();
     void printButtonClicked();
     void cancelPrintButtonClicked();
+    void printProgressSlot(int done, int total);
+    void pdfFinishedSlot(bool success);
     
 private:
-    void initRecordListToPrint();
-    void print(bool pdf = false, QString pdfOutputPath = QString());
-    QString textTypeItemHtml(const QVariant &data, int fieldId);
-    QString numericTypeItemHtml(const QVariant &data, int fieldId);
-    QString dateTypeItemHtml(const QVariant &data, int fieldId);
-    QString checkboxTypeItemHtml(const QVariant &data, int fieldId);
-    QString comboboxTypeItemHtml(const QVariant &data, int fieldId);
-    QString progressTypeItemHtml(const QVariant &data, int fieldId);
-    QString imageTypeItemHtml(const QVariant &data, int fieldId);
-    QString filesTypeItemHtml(const QVariant &data, int fieldId);
-    QString generateImgLicensingInfo();
+    PrintEngine* createPrintEngine();
+    QString headerHtml();
+    void print();
+    void printToPdf(const QString &pdfOutputPath);
 
     Ui::PrintDialog *ui;
     QList<int> m_recordList; /**< List of record ids to print */
     int m_collectionId;
     MetadataEngine *m_metadataEngine;
-    bool m_printCancelled;
-    QStringList m_printedPlantImages;
+    PrintEngine *m_printEngine; /**< Active print engine, if any */
+    QThread *m_printThread; /**< Worker thread for pdf output */
 };
 
 #endif // PRINTDIALOG_H